@@ -0,0 +1,70 @@
+#ifndef GENERATED_DOCUMENT_HPP_
+#define GENERATED_DOCUMENT_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A generated SVG document, written to a temporary file of its own.
+ *
+ * The file name takes a random suffix, so two runs of the same benchmark
+ * never write to the same file, and the file is removed with the object.
+ */
+class GeneratedDocument {
+public:
+    /**
+     * @brief Writes a document to a new temporary file.
+     *
+     * @param name The prefix of the file name, the name of the benchmark.
+     * @param write The generator, called once with the stream of the file
+     * and the arguments.
+     * @param args The arguments of the generator.
+     */
+    template< typename Writer, typename... Args >
+    GeneratedDocument(std::string_view name, Writer write,
+                      const Args&... args) {
+        static std::atomic< std::uint64_t > counter{0};
+        std::random_device device;
+        std::uint64_t suffix = (std::uint64_t)device() << 32 ^ device();
+        std::ostringstream base_name;
+        base_name << name << '-' << std::hex << suffix << '-' << counter++
+                  << ".svg";
+        file_name =
+            (std::filesystem::temp_directory_path() / base_name.str())
+                .string();
+        std::ofstream file(file_name);
+        write(static_cast< std::ostream& >(file), args...);
+    }
+
+    /**
+     * @brief Deleted copy constructor, the object owns its file.
+     */
+    GeneratedDocument(const GeneratedDocument&) = delete;
+
+    /**
+     * @brief Removes the file.
+     */
+    ~GeneratedDocument() {
+        std::error_code error;
+        std::filesystem::remove(file_name, error);
+    }
+
+    /**
+     * @brief Gets the name of the file.
+     *
+     * @return The absolute name of the file.
+     */
+    const std::string& getFileName() const { return file_name; }
+
+private:
+    std::string file_name;  ///< Name of the temporary file
+};
+
+#endif  // GENERATED_DOCUMENT_HPP_
@@ -0,0 +1,46 @@
+// Parses every SVG file of a sample directory and reports how many attribute
+// lookups went through the attribute tables and how many attribute name
+// compares they avoided. It links a parser built with SVG_COUNT_LOOKUPS, the
+// only build that counts them.
+//
+// Usage: bench-attributes [directory] (default: external/samples)
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Parser.hpp"
+
+int main(int argc, char **argv) {
+    std::string directory = argc > 1 ? argv[1] : "external/samples";
+    std::vector< std::filesystem::path > files;
+    for (auto &entry :
+         std::filesystem::recursive_directory_iterator(directory)) {
+        if (entry.path().extension() == ".svg") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    std::cout << std::left << std::setw(40) << "file" << std::right
+              << std::setw(12) << "lookups" << std::setw(18)
+              << "compares avoided" << std::endl;
+
+    for (auto &file_name : files) {
+        std::size_t lookups = AttributeTable::getLookups();
+        std::size_t avoided = AttributeTable::getComparesAvoided();
+        Parser parser(file_name.string());
+        std::cout << std::left << std::setw(40)
+                  << file_name.filename().string() << std::right
+                  << std::setw(12) << AttributeTable::getLookups() - lookups
+                  << std::setw(18)
+                  << AttributeTable::getComparesAvoided() - avoided
+                  << std::endl;
+    }
+
+    std::cout << std::left << std::setw(40) << "total" << std::right
+              << std::setw(12) << AttributeTable::getLookups() << std::setw(18)
+              << AttributeTable::getComparesAvoided() << std::endl;
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Parses a generated chart of rotated polygons and curved paths, then reads
+// the bounds of every shape for a number of frames: rescanning the vertices
+// of each polygon on every call, as PolyShape used to, and reading the
+// bounds cached on the elements. It also bounds the whole chart once, and
+// compares the area of the exact bounds of the paths with the box of their
+// control points.
+//
+// Usage: bench-bounds [shape count] (default: 20000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    constexpr int kFrames = 20;
+    constexpr int kVertices = 64;
+
+    // Writes the chart
+    void writeDocument(std::ostream& file, int shapes) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < shapes; ++i) {
+            int x = i % 100 * 40, y = i / 100 * 40;
+            file << "<g transform=\"translate(" << x << " " << y
+                 << ") rotate(" << i % 90 << ")\">";
+            if (i % 2 == 0) {
+                file << "<polygon points=\"";
+                for (int k = 0; k < kVertices; ++k)
+                    file << (k * 7 + i) % 30 << "," << (k * 11 + i) % 30
+                         << " ";
+                file << "\" fill=\"#69c\"/>";
+            } else {
+                file << "<path d=\"M0 10 C5 -10 25 -10 30 10 S35 40 15 30 "
+                        "Q0 35 5 20 T0 10 A10 6 30 0 1 20 15 Z\" "
+                        "fill=\"#c96\" stroke=\"#333\"/>";
+            }
+            file << "</g>\n";
+        }
+        file << "</svg>\n";
+    }
+
+    // Bounds the vertices of a polygon, as PolyShape used to on every call
+    BoundingBox scanPoints(const PolyShape* shape) {
+        BoundingBox box;
+        for (const Vector2Df& point : shape->getPoints()) box.add(point);
+        return box;
+    }
+
+    // Bounds the control points of a path
+    BoundingBox getHull(const Path* path, const AffineTransform& matrix) {
+        BoundingBox box;
+        for (const Vector2Df& point : path->getGeometry().points)
+            box.add(matrix.apply(point));
+        return box;
+    }
+
+    double getArea(const BoundingBox& box) {
+        return box.isEmpty() ? 0
+                             : (double)(box.max.x - box.min.x) *
+                                   (box.max.y - box.min.y);
+    }
+
+    double elapsed(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration< double, std::milli >(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    int shapes = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    GeneratedDocument document("bench-bounds", writeDocument, shapes);
+    Parser parser(document.getFileName());
+
+    // The shapes, each in its rotated group
+    std::vector< const SVGElement* > elements;
+    for (const SVGElement* group : parser.getRoot()->getElements()) {
+        for (const SVGElement* element :
+             static_cast< const Group* >(group)->getElements())
+            elements.push_back(element);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    BoundingBox chart = parser.getRoot()->getBounds();
+    double first_time = elapsed(start);
+
+    double scan_sum = 0, cached_sum = 0;
+    start = Clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (const SVGElement* element : elements) {
+            if (element->getKind() != ElementKind::Polygon) continue;
+            BoundingBox box =
+                scanPoints(static_cast< const PolyShape* >(element));
+            scan_sum += box.max.x - box.min.x;
+        }
+    }
+    double scan_time = elapsed(start) / kFrames;
+    start = Clock::now();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (const SVGElement* element : elements) {
+            if (element->getKind() != ElementKind::Polygon) continue;
+            cached_sum += element->getMaxBound().x - element->getMinBound().x;
+        }
+    }
+    double cached_time = elapsed(start) / kFrames;
+
+    // The paths in the coordinates of the chart
+    double exact_area = 0, hull_area = 0;
+    for (const SVGElement* element : elements) {
+        if (element->getKind() != ElementKind::Path) continue;
+        const AffineTransform& matrix = element->getParent()->getTransform();
+        exact_area += getArea(element->computeBounds(matrix));
+        hull_area += getArea(
+            getHull(static_cast< const Path* >(element), matrix));
+    }
+
+    std::cout << "shapes:             " << elements.size() << " ("
+              << kVertices << " vertices per polygon)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "first bounds (ms):  " << first_time << " (chart "
+              << chart.max.x - chart.min.x << " x "
+              << chart.max.y - chart.min.y << ")" << std::endl;
+    std::cout << "rescan (ms/frame):  " << scan_time << std::endl;
+    std::cout << "cached (ms/frame):  " << cached_time << " ("
+              << scan_time / cached_time << "x faster"
+              << (scan_sum == cached_sum ? "" : ", results differ") << ")"
+              << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "path box area:      " << exact_area / hull_area * 100
+              << "% of the box of the control points" << std::endl;
+    return 0;
+}
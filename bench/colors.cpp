@@ -0,0 +1,141 @@
+// Compares the former color decoding (a lowercased std::string copy, a
+// std::map of the named colors and std::stringstream for hex digits) with
+// the ColorParser on a mix of named, hex and rgb() values.
+//
+// Usage: bench-colors [value count] (default: 1000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ColorParser.hpp"
+
+namespace {
+    const char *const kNames[] = {"black",     "White",  "steelblue",
+                                  "darkgreen", "orange", "LightGoldenRodYellow",
+                                  "crimson",   "navy"};
+
+    // Generates color values in the proportions of our exports
+    std::vector< std::string > generateValues(int count) {
+        std::vector< std::string > values;
+        unsigned int seed = 1;
+        auto random = [&seed]() {
+            seed = seed * 1103515245u + 12345u;
+            return seed >> 8;
+        };
+        for (int i = 0; i < count; ++i) {
+            std::ostringstream out;
+            switch (i % 4) {
+                case 0:
+                    out << kNames[random() % std::size(kNames)];
+                    break;
+                case 1:
+                case 2:
+                    out << "#" << std::hex << std::setw(6) << std::setfill('0')
+                        << (random() & 0xFFFFFF);
+                    break;
+                default:
+                    out << "rgb(" << random() % 256 << ", " << random() % 256
+                        << ", " << random() % 256 << ")";
+            }
+            values.push_back(out.str());
+        }
+        return values;
+    }
+
+    // The decoding that Parser::parseColor used to do
+    namespace legacy {
+        const std::map< std::string, ColorShape > color_map = {
+            {"black", ColorShape(0, 0, 0)},
+            {"crimson", ColorShape(220, 20, 60)},
+            {"darkgreen", ColorShape(0, 100, 0)},
+            {"lightgoldenrodyellow", ColorShape(250, 250, 210)},
+            {"navy", ColorShape(0, 0, 128)},
+            {"orange", ColorShape(255, 165, 0)},
+            {"steelblue", ColorShape(70, 130, 180)},
+            {"white", ColorShape(255, 255, 255)}};
+
+        ColorShape parse(std::string color) {
+            color.erase(std::remove(color.begin(), color.end(), ' '),
+                        color.end());
+            for (auto &c : color) c = tolower(c);
+            if (color.find("#") != std::string::npos) {
+                std::stringstream ss;
+                ss << std::hex << color.substr(1, 2) << " "
+                   << color.substr(3, 2) << " " << color.substr(5, 2);
+                int r, g, b;
+                ss >> r >> g >> b;
+                return ColorShape(r, g, b, 255);
+            } else if (color.find("rgb") != std::string::npos) {
+                int r, g, b;
+                sscanf(color.c_str(), "rgb(%d,%d,%d)", &r, &g, &b);
+                return ColorShape(r, g, b, 255);
+            }
+            return color_map.find(color)->second;
+        }
+    }  // namespace legacy
+
+    // Runs a function until it has taken a measurable amount of time and
+    // returns the average duration of one run in seconds
+    template< typename Function >
+    double measure(Function function) {
+        using Clock = std::chrono::steady_clock;
+        int runs = 0;
+        auto start = Clock::now();
+        std::chrono::duration< double > elapsed{0};
+        do {
+            function();
+            ++runs;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < 0.5);
+        return elapsed.count() / runs;
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::vector< std::string > values = generateValues(count);
+
+    // Both decoders must agree on every value
+    int mismatches = 0;
+    for (const std::string &value : values) {
+        ColorShape expected = legacy::parse(value), color;
+        ColorParser::parse(value, color);
+        if (color.r != expected.r || color.g != expected.g ||
+            color.b != expected.b || color.a != expected.a)
+            ++mismatches;
+    }
+
+    long long sink = 0;  // Keeps the measured work observable
+    double legacy_time = measure([&] {
+        for (const std::string &value : values) {
+            ColorShape color = legacy::parse(value);
+            sink += color.r + color.g + color.b;
+        }
+    });
+    double parser_time = measure([&] {
+        for (const std::string &value : values) {
+            ColorShape color;
+            ColorParser::parse(value, color);
+            sink += color.r + color.g + color.b;
+        }
+    });
+
+    std::cout << "values:          " << count << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "legacy ns/value: " << legacy_time * 1e9 / count << std::endl;
+    std::cout << "parser ns/value: " << parser_time * 1e9 / count << std::endl;
+    std::cout << "speedup:         " << legacy_time / parser_time << "x"
+              << std::endl;
+    std::cout << "mismatches:      " << mismatches << std::endl;
+    std::cout << "checksum " << sink << std::endl;
+    return 0;
+}
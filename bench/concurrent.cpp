@@ -0,0 +1,126 @@
+// Parses every file of a directory serially, then again from one thread per
+// core, each thread with its own Parser, and checks that every concurrent
+// result matches the serial one. Reports both wall times.
+//
+// Usage: bench-concurrent [directory] [rounds] [threads]
+//        (default: external/samples, 8, one per core)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Parser.hpp"
+
+namespace {
+    // Writes everything the renderer reads from an element and its children
+    void describe(std::ostream &out, const SVGElement *element) {
+        const AffineTransform &transform = element->getTransform();
+        out << element->getClass() << " " << element->getFillColor() << " "
+            << element->getOutlineColor() << " "
+            << element->getOutlineThickness() << " "
+            << element->getPosition().x << " " << element->getPosition().y
+            << " " << element->getMinBound().x << " "
+            << element->getMinBound().y << " " << element->getMaxBound().x
+            << " " << element->getMaxBound().y << " [" << transform.a << " "
+            << transform.b << " " << transform.c << " " << transform.d << " "
+            << transform.e << " " << transform.f << "]";
+        if (Gradient *gradient = element->getGradient()) {
+            out << " " << gradient->getClass() << " "
+                << gradient->getPoints().first.x << " "
+                << gradient->getPoints().first.y << " "
+                << gradient->getStops().size();
+        }
+        out << "\n";
+        if (const Group *group = dynamic_cast< const Group * >(element)) {
+            for (const SVGElement *child : group->getElements())
+                describe(out, child);
+        }
+    }
+
+    // Parses a file and returns the description of its document
+    std::string parseFile(const std::string &file_name) {
+        Parser parser(file_name);
+        std::ostringstream out;
+        out << std::setprecision(9);
+        ViewBox viewbox = parser.getViewBox();
+        out << parser.getViewPort().x << " " << parser.getViewPort().y << " "
+            << viewbox.getX() << " " << viewbox.getY() << " "
+            << viewbox.getWidth() << " " << viewbox.getHeight() << "\n";
+        describe(out, parser.getRoot());
+        return out.str();
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::filesystem::path directory =
+        argc > 1 ? argv[1] : "external/samples";
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 8;
+
+    std::vector< std::string > files;
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(directory)) {
+        if (entry.path().extension() == ".svg")
+            files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cerr << "No SVG file in " << directory << std::endl;
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    std::vector< std::string > expected;
+    for (int round = 0; round < rounds; ++round) {
+        expected.clear();
+        for (const std::string &file_name : files)
+            expected.push_back(parseFile(file_name));
+    }
+    std::chrono::duration< double > serial_time = Clock::now() - start;
+
+    // The threads take the next job from a shared counter, so that large
+    // files do not leave the other cores idle
+    unsigned int thread_count =
+        argc > 3 ? std::atoi(argv[3]) : std::thread::hardware_concurrency();
+    thread_count = std::max(1u, thread_count);
+    std::size_t job_count = files.size() * rounds;
+    std::atomic< std::size_t > next_job{0};
+    std::atomic< std::size_t > mismatches{0};
+    start = Clock::now();
+    std::vector< std::thread > threads;
+    for (unsigned int i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t job = next_job++; job < job_count;
+                 job = next_job++) {
+                std::size_t file = job % files.size();
+                if (parseFile(files[file]) != expected[file]) {
+                    std::cerr << "Mismatch: " << files[file] << std::endl;
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) thread.join();
+    std::chrono::duration< double > concurrent_time = Clock::now() - start;
+
+    std::cout << "files:           " << files.size() << " x " << rounds
+              << std::endl;
+    std::cout << "threads:         " << thread_count << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "serial (ms):     " << serial_time.count() * 1e3 << std::endl;
+    std::cout << "concurrent (ms): " << concurrent_time.count() * 1e3
+              << std::endl;
+    std::cout << "speedup:         "
+              << serial_time.count() / concurrent_time.count() << "x"
+              << std::endl;
+    std::cout << "mismatches:      " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+// Parses a generated city map of blocks of buildings, roads and labels, then
+// finds the shapes visible in a view zoomed into a hundredth of the map,
+// moved over the map frame by frame: testing the bounds of every shape, as
+// the renderer drew them all, skipping the subtrees of the document outside
+// the view with the SceneStore, and querying the SceneBVH. It reports the
+// time of each per frame with the shapes drawn and culled.
+//
+// Usage: bench-culling [block count] (default: 40000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    constexpr int kFrames = 100;
+
+    // Writes the map
+    void writeDocument(std::ostream& file, int blocks) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < blocks; ++i) {
+            int x = i % 200 * 50, y = i / 200 * 50;
+            file << "<g transform=\"translate(" << x << " " << y << ")\">"
+                 << "<rect width=\"20\" height=\"30\" fill=\"#ccb\"/>"
+                 << "<rect x=\"25\" width=\"15\" height=\"15\" fill=\"#bbc\" "
+                    "transform=\"rotate("
+                 << i % 90 << " 30 10)\"/>"
+                 << "<path d=\"M0 45 L50 45 Q55 47 50 49 L0 49 Z\" "
+                    "fill=\"#666\"/>"
+                 << "<circle cx=\"45\" cy=\"25\" r=\"3\" fill=\"#7a7\"/>"
+                 << "<text x=\"2\" y=\"40\" font-size=\"4\">b" << i
+                 << "</text></g>\n";
+        }
+        file << "</svg>\n";
+    }
+
+    // Finds the visible shapes by testing every element. The map has no
+    // symbols, so the tree of the document holds them all
+    void scanAll(const SceneStore& store, const BoundingBox& view,
+                 std::vector< StoreShape >& shapes) {
+        std::span< const ElementKind > kinds = store.getKinds();
+        std::span< const BoundingBox > bounds = store.getBounds();
+        for (std::uint32_t i = 0; i < store.getTreeSize(); ++i) {
+            if (kinds[i] == ElementKind::Group || kinds[i] == ElementKind::Use)
+                continue;
+            if (bounds[i].intersects(view))
+                shapes.push_back({i, store.getMatrix(i)});
+        }
+    }
+
+    // Runs a query for every frame, returns the mean time in ms
+    template< typename Query >
+    double time(Query query, const std::vector< BoundingBox >& views,
+                std::size_t& found) {
+        using Clock = std::chrono::steady_clock;
+        std::vector< StoreShape > shapes;
+        found = 0;
+        Clock::time_point start = Clock::now();
+        for (const BoundingBox& view : views) {
+            shapes.clear();
+            query(view, shapes);
+            found += shapes.size();
+        }
+        return std::chrono::duration< double, std::milli >(Clock::now() -
+                                                           start)
+                   .count() /
+               views.size();
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    int blocks = argc > 1 ? std::atoi(argv[1]) : 40000;
+
+    GeneratedDocument document("bench-culling", writeDocument, blocks);
+    Parser parser(document.getFileName());
+    LoadStats stats = parser.getLoadStats();
+    const SceneStore& store = parser.getStore();
+    const SceneBVH& bvh = parser.getSceneBVH();
+
+    // A view of a tenth of the width and height of the map, panned across
+    BoundingBox map = store.getBounds()[0];
+    Vector2Df size = (map.max - map.min) * 0.1f;
+    std::vector< BoundingBox > views;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        Vector2Df corner = map.min + Vector2Df(size.x * (frame % 10) * 0.9f,
+                                               size.y * (frame / 10) * 0.9f);
+        views.push_back(BoundingBox(corner, corner + size));
+    }
+
+    std::size_t scan_found = 0, store_found = 0, bvh_found = 0;
+    double scan_time = time(
+        [&](const BoundingBox& view, std::vector< StoreShape >& shapes) {
+            scanAll(store, view, shapes);
+        },
+        views, scan_found);
+    double store_time = time(
+        [&](const BoundingBox& view, std::vector< StoreShape >& shapes) {
+            store.query(view, shapes);
+        },
+        views, store_found);
+    double bvh_time = time(
+        [&](const BoundingBox& view, std::vector< StoreShape >& shapes) {
+            bvh.query(view, shapes);
+        },
+        views, bvh_found);
+
+    std::size_t drawn = bvh_found / kFrames;
+    std::size_t shapes = store.getShapeCount();
+    std::cout << "shapes:           " << shapes << " (" << drawn
+              << " drawn, " << shapes - drawn << " culled per frame)"
+              << std::endl;
+    std::cout << "bvh bytes:        " << stats.bvh_bytes << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "bvh build (ms):   " << stats.bvh_time << " (store "
+              << stats.store_time << ")" << std::endl;
+    std::cout << "scan (ms/frame):  " << scan_time << std::endl;
+    std::cout << "store (ms/frame): " << store_time << std::endl;
+    std::cout << "bvh (ms/frame):   " << bvh_time << " ("
+              << scan_time / bvh_time << "x faster than the scan"
+              << (scan_found == bvh_found && store_found == bvh_found
+                      ? ""
+                      : ", results differ")
+              << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Builds a scene of mixed shapes and walks it the way the renderer picks the
+// drawing function of each element: first comparing the class names and
+// casting with dynamic_cast, as the renderer used to, then switching on the
+// kind of the element. Both walks read one field of every shape, and the
+// cost per element is reported.
+//
+// Usage: bench-dispatch [element count] (default: 1000000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "Graphics.hpp"
+#include "SceneArena.hpp"
+
+namespace {
+    constexpr int kRounds = 5;
+
+    // Builds a group of count shapes, cycling through the kinds
+    Group *buildScene(SceneArena &arena, int count) {
+        Group *root = arena.create< Group >(arena.getAllocator());
+        ColorShape fill = ColorShape::Red, stroke = ColorShape::Black;
+        for (int i = 0; i < count; ++i) {
+            float size = i % 97;
+            SVGElement *shape = NULL;
+            switch (i % 9) {
+                case 0:
+                    shape = arena.create< Rect >(size, size, Vector2Df(0, 0),
+                                                 Vector2Df(0, 0), fill,
+                                                 stroke, 1);
+                    break;
+                case 1:
+                    shape = arena.create< Circle >(size, Vector2Df(0, 0), fill,
+                                                   stroke, 1);
+                    break;
+                case 2:
+                    shape = arena.create< Ell >(Vector2Df(size, 1),
+                                                Vector2Df(0, 0), fill, stroke,
+                                                1);
+                    break;
+                case 3:
+                    shape = arena.create< Line >(Vector2Df(0, 0),
+                                                 Vector2Df(size, size),
+                                                 stroke, 1);
+                    break;
+                case 4:
+                    shape = arena.create< Plygon >(fill, stroke, size,
+                                                   arena.getAllocator());
+                    break;
+                case 5:
+                    shape = arena.create< Plyline >(fill, stroke, size,
+                                                    arena.getAllocator());
+                    break;
+                case 6:
+                    shape = arena.create< Path >(fill, stroke, size,
+                                                 arena.getAllocator());
+                    break;
+                case 7:
+                    shape = arena.create< Text >(Vector2Df(0, 0), "", size,
+                                                 fill, stroke, 1,
+                                                 arena.getAllocator());
+                    break;
+                default:
+                    shape = arena.create< Group >(arena.getAllocator());
+                    shape->setOutlineThickness(size);
+                    break;
+            }
+            root->addElement(shape);
+        }
+        return root;
+    }
+
+    // Picks the shape by its class name, as the renderer used to
+    double visitByName(const SVGElement *shape) {
+        if (shape->getClass() == "Group") {
+            return dynamic_cast< const Group * >(shape)->getOutlineThickness();
+        } else if (shape->getClass() == "Polyline") {
+            return dynamic_cast< const Plyline * >(shape)
+                ->getOutlineThickness();
+        } else if (shape->getClass() == "Text") {
+            return dynamic_cast< const Text * >(shape)->getFontSize();
+        } else if (shape->getClass() == "Rect") {
+            return dynamic_cast< const Rect * >(shape)->getWidth();
+        } else if (shape->getClass() == "Circle") {
+            return dynamic_cast< const Circle * >(shape)->getRadius().x;
+        } else if (shape->getClass() == "Ellipse") {
+            return dynamic_cast< const Ell * >(shape)->getRadius().x;
+        } else if (shape->getClass() == "Line") {
+            return dynamic_cast< const Line * >(shape)->getDirection().x;
+        } else if (shape->getClass() == "Polygon") {
+            return dynamic_cast< const Plygon * >(shape)
+                ->getOutlineThickness();
+        } else if (shape->getClass() == "Path") {
+            return dynamic_cast< const Path * >(shape)->getOutlineThickness();
+        }
+        return 0;
+    }
+
+    // Picks the shape by its kind
+    double visitByKind(const SVGElement *shape) {
+        switch (shape->getKind()) {
+            case ElementKind::Group:
+                return static_cast< const Group * >(shape)
+                    ->getOutlineThickness();
+            case ElementKind::Polyline:
+                return static_cast< const Plyline * >(shape)
+                    ->getOutlineThickness();
+            case ElementKind::Text:
+                return static_cast< const Text * >(shape)->getFontSize();
+            case ElementKind::Rect:
+                return static_cast< const Rect * >(shape)->getWidth();
+            case ElementKind::Circle:
+                return static_cast< const Circle * >(shape)->getRadius().x;
+            case ElementKind::Ellipse:
+                return static_cast< const Ell * >(shape)->getRadius().x;
+            case ElementKind::Line:
+                return static_cast< const Line * >(shape)->getDirection().x;
+            case ElementKind::Polygon:
+                return static_cast< const Plygon * >(shape)
+                    ->getOutlineThickness();
+            case ElementKind::Path:
+                return static_cast< const Path * >(shape)
+                    ->getOutlineThickness();
+            default:
+                return 0;
+        }
+    }
+
+    // Walks the scene kRounds times, returns the best time in ms
+    template< typename Visit >
+    double time(const Group *root, Visit visit, double &checksum) {
+        using Clock = std::chrono::steady_clock;
+        double best = 0;
+        for (int round = 0; round < kRounds; ++round) {
+            Clock::time_point start = Clock::now();
+            double sum = 0;
+            for (const SVGElement *shape : root->getElements())
+                sum += visit(shape);
+            double elapsed = std::chrono::duration< double, std::milli >(
+                                 Clock::now() - start)
+                                 .count();
+            if (round == 0 || elapsed < best) best = elapsed;
+            checksum = sum;
+        }
+        return best;
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    SceneArena arena;
+    const Group *root = buildScene(arena, count);
+    double name_sum = 0, kind_sum = 0;
+    double name_time = time(root, visitByName, name_sum);
+    double kind_time = time(root, visitByKind, kind_sum);
+
+    std::cout << "elements:     " << count << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "by name (ms): " << name_time << " ("
+              << name_time * 1e6 / count << " ns/element)" << std::endl;
+    std::cout << "by kind (ms): " << kind_time << " ("
+              << kind_time * 1e6 / count << " ns/element)" << std::endl;
+    std::cout << "speedup:      " << name_time / kind_time << "x"
+              << (name_sum == kind_sum ? "" : " (results differ)")
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Parses a generated map of curved paths, Bezier curves and arcs, then zooms
+// eight times into it and back out frame by frame, flattening every path to
+// a fifth of a pixel at the scale of each frame: again on every frame, and
+// through the flattenings cached by the paths per power of two of the
+// tolerance. It reports the time of each per frame and the lines drawn per
+// frame.
+//
+// Usage: bench-flatten [path count] (default: 20000)
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    constexpr int kFrames = 60;
+    constexpr float kTolerance = 0.2f;  // In pixels
+    constexpr float kMaxZoom = 8;       // Spanning four tolerance buckets
+
+    // Writes the map
+    void writeDocument(std::ostream& file, int paths) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < paths; ++i) {
+            int x = i % 100 * 40, y = i / 100 * 40;
+            file << "<path d=\"M" << x << " " << y + 10
+                 << " c5 -20 25 -20 30 0 s5 30 -15 20 q-15 5 -10 -10"
+                 << " t-5 -10 a12 7 " << i % 180 << " 0 1 20 5 A6 6 0 1 0 "
+                 << x + 5 << " " << y + 35
+                 << " Z\" fill=\"#8ab\" stroke=\"#345\"/>\n";
+        }
+        file << "</svg>\n";
+    }
+
+    double elapsed(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration< double, std::milli >(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    GeneratedDocument document("bench-flatten", writeDocument, count);
+    Parser parser(document.getFileName());
+    std::vector< const Path* > paths;
+    for (const SVGElement* element : parser.getRoot()->getElements()) {
+        if (element->getKind() == ElementKind::Path)
+            paths.push_back(static_cast< const Path* >(element));
+    }
+
+    // The scale of each frame, zooming in then back out
+    std::vector< float > scales;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        float t = 1 - std::abs(2.f * frame / (kFrames - 1) - 1);
+        scales.push_back(std::pow(kMaxZoom, t));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    FlatPath flat;
+    std::size_t flattened_points = 0, cached_points = 0;
+    Clock::time_point start = Clock::now();
+    for (float scale : scales) {
+        for (const Path* path : paths) {
+            flattenPath(*path, kTolerance / scale, flat);
+            flattened_points += flat.points.size();
+        }
+    }
+    double flatten_time = elapsed(start) / kFrames;
+    start = Clock::now();
+    for (float scale : scales) {
+        for (const Path* path : paths) {
+            const FlatPath& cached = path->getFlatPath(kTolerance / scale);
+            cached_points += cached.points.size();
+        }
+    }
+    double cached_time = elapsed(start) / kFrames;
+
+    // The frames after the first pass over every bucket only read caches
+    start = Clock::now();
+    for (float scale : scales) {
+        for (const Path* path : paths) {
+            const FlatPath& cached = path->getFlatPath(kTolerance / scale);
+            cached_points += cached.points.size();
+        }
+    }
+    double warm_time = elapsed(start) / kFrames;
+
+    std::cout << "paths:                   " << paths.size() << std::endl;
+    std::cout << "points (per frame):      " << cached_points / 2 / kFrames
+              << " (" << flattened_points / kFrames
+              << " at the exact tolerance)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "flatten (ms/frame):      " << flatten_time << std::endl;
+    std::cout << "cached (ms/frame):       " << cached_time << " ("
+              << flatten_time / cached_time << "x faster)" << std::endl;
+    std::cout << "cached again (ms/frame): " << warm_time << " ("
+              << flatten_time / warm_time << "x faster)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Parses generated icon sheets that define many gradients, half of them
+// inheriting the stops of a gradient defined after them, and fill shapes with
+// a growing share of the gradients. Only the gradients in use are built, so
+// the parse time should follow the number of shapes, not of gradients. The
+// stops come from a palette of 16 ramps, and the distinct ramps kept and the
+// memory saved by sharing the others are reported.
+//
+// Usage: bench-gradients [gradient count] (default: 20000)
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    // Writes a sheet of gradients and of shapes filled with every step-th one
+    void writeDocument(std::ostream &file, int gradients, int step) {
+        file << "<svg xmlns:xlink=\"http://www.w3.org/1999/xlink\" "
+                "width=\"100\" height=\"100\">\n";
+        for (int i = 0; i < gradients; i += step) {
+            file << "<rect x=\"" << i % 100 << "\" y=\"" << i / 100
+                 << "\" width=\"1\" height=\"1\" fill=\"url(#g" << i
+                 << ")\"/>\n";
+        }
+        file << "<defs>\n";
+        for (int i = 0; i < gradients; ++i) {
+            if (i % 2 == 0 && i + 1 < gradients) {
+                file << "<radialGradient id=\"g" << i << "\" xlink:href=\"#g"
+                     << i + 1 << "\" cx=\"0.5\" cy=\"0.5\" r=\"0.5\"/>\n";
+                continue;
+            }
+            file << "<linearGradient id=\"g" << i
+                 << "\" x1=\"0\" y1=\"0\" x2=\"1\" y2=\"1\" "
+                    "gradientTransform=\"rotate(45 0.5 0.5)\">"
+                 << "<stop offset=\"0\" stop-color=\"#" << std::hex
+                 << std::setw(6) << std::setfill('0')
+                 << (i / 2 % 16 * 2654435761u & 0xFFFFFF) << std::dec
+                 << "\"/>"
+                 << "<stop offset=\"0.5\" stop-color=\"white\" "
+                    "stop-opacity=\"0.5\"/>"
+                 << "<stop offset=\"1\" stop-color=\"black\"/>"
+                 << "</linearGradient>\n";
+        }
+        file << "</defs>\n</svg>\n";
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int gradients = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    std::cout << std::setw(10) << "gradients" << std::setw(8) << "used"
+              << std::setw(14) << "parse (ms)" << std::setw(12) << "ns/used"
+              << std::setw(8) << "ramps" << std::setw(12) << "saved (KB)"
+              << std::endl;
+    for (int step : {1000, 100, 10, 1}) {
+        GeneratedDocument document("bench-gradients", writeDocument,
+                                   gradients, step);
+        LoadStats stats = Parser(document.getFileName()).getLoadStats();
+
+        int used = (gradients + step - 1) / step;
+        std::cout << std::setw(10) << gradients << std::setw(8) << used
+                  << std::fixed << std::setprecision(2) << std::setw(14)
+                  << stats.parse_time << std::setw(12)
+                  << stats.parse_time * 1e6 / used << std::setw(8)
+                  << stats.unique_ramps << std::setw(12)
+                  << stats.ramp_bytes_saved / 1024.0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Parses a generated mosaic of overlapping rectangles, circles, stars,
+// curved paths and lines, then picks the shapes under random points and in
+// small random areas with the ScenePicker: the SceneBVH narrows each query
+// to the shapes whose bounds are hit, then their geometry is tested. It
+// reports the time of each per query, and of finding the candidates of a
+// few points by testing the bounds of every shape instead.
+//
+// Usage: bench-hittest [shape count] (default: 1000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+#include "ScenePicker.hpp"
+
+namespace {
+    constexpr int kPoints = 100000;
+    constexpr int kAreas = 10000;
+    constexpr int kScans = 20;
+
+    // Writes the mosaic, a row of shapes per group
+    void writeDocument(std::ostream& file, int shapes) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < shapes; ++i) {
+            int x = i % 1000 * 10;
+            if (i % 1000 == 0) {
+                if (i != 0) file << "</g>\n";
+                file << "<g transform=\"translate(0 " << i / 1000 * 10
+                     << ") rotate(" << i / 1000 % 7 - 3 << ")\">";
+            }
+            switch (i % 5) {
+                case 0:
+                    file << "<rect x=\"" << x << "\" width=\"13\" "
+                         << "height=\"9\" rx=\"3\" fill=\"#69c\"/>";
+                    break;
+                case 1:
+                    file << "<circle cx=\"" << x + 5 << "\" cy=\"5\" r=\"6\" "
+                         << "fill=\"none\" stroke=\"#333\"/>";
+                    break;
+                case 2:
+                    file << "<polygon points=\"" << x + 5 << ",0 " << x + 8
+                         << ",10 " << x << ",4 " << x + 10 << ",4 " << x + 2
+                         << ",10\" fill=\"#c96\" fill-rule=\"evenodd\"/>";
+                    break;
+                case 3:
+                    file << "<path d=\"M" << x << " 2 C" << x + 4 << " -4 "
+                         << x + 9 << " 4 " << x + 12 << " 2 Q" << x + 14
+                         << " 9 " << x + 6 << " 11 A5 3 30 0 1 " << x
+                         << " 2 Z\" fill=\"#9c6\" stroke=\"#363\"/>";
+                    break;
+                default:
+                    file << "<line x1=\"" << x << "\" y1=\"10\" x2=\""
+                         << x + 12 << "\" y2=\"0\" stroke=\"#c33\" "
+                         << "stroke-width=\"2\"/>";
+                    break;
+            }
+            file << "\n";
+        }
+        if (shapes > 0) file << "</g>\n";
+        file << "</svg>\n";
+    }
+
+    double elapsed(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration< double, std::micro >(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    int shapes = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    GeneratedDocument document("bench-hittest", writeDocument, shapes);
+    Parser parser(document.getFileName());
+    const SceneStore& store = parser.getStore();
+    const SceneBVH& bvh = parser.getSceneBVH();
+    ScenePicker picker(store, bvh);
+
+    // Points and areas of a twentieth of a shape to a few shapes wide
+    BoundingBox mosaic = store.getBounds()[0];
+    std::mt19937 random(1);
+    std::uniform_real_distribution< float > x(mosaic.min.x, mosaic.max.x);
+    std::uniform_real_distribution< float > y(mosaic.min.y, mosaic.max.y);
+    std::uniform_real_distribution< float > size(0.5f, 30);
+    std::vector< Vector2Df > points;
+    for (int i = 0; i < kPoints; ++i)
+        points.push_back(Vector2Df(x(random), y(random)));
+    std::vector< BoundingBox > areas;
+    for (int i = 0; i < kAreas; ++i) {
+        Vector2Df corner(x(random), y(random));
+        Vector2Df extent(size(random), size(random));
+        areas.push_back(BoundingBox(corner, corner + extent));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    std::vector< StoreShape > handles;
+    std::size_t point_hits = 0, area_hits = 0, candidates = 0;
+    Clock::time_point start = Clock::now();
+    for (const Vector2Df& point : points) {
+        handles.clear();
+        picker.hitTest(point, handles);
+        point_hits += handles.size();
+    }
+    double point_time = elapsed(start) / kPoints;
+    start = Clock::now();
+    for (const BoundingBox& area : areas) {
+        handles.clear();
+        picker.query(area, handles);
+        area_hits += handles.size();
+    }
+    double area_time = elapsed(start) / kAreas;
+    for (const Vector2Df& point : points) {
+        handles.clear();
+        bvh.query(BoundingBox(point, point), handles);
+        candidates += handles.size();
+    }
+
+    // Without the hierarchy, finding the candidates alone takes testing
+    // the bounds of every shape
+    start = Clock::now();
+    bool same = true;
+    for (int i = 0; i < kScans; ++i) {
+        std::vector< std::uint32_t > scanned;
+        std::vector< StoreShape > queried;
+        BoundingBox point(points[i], points[i]);
+        std::span< const ElementKind > kinds = store.getKinds();
+        std::span< const BoundingBox > bounds = store.getBounds();
+        for (std::uint32_t index = 0; index < store.getTreeSize(); ++index) {
+            if (kinds[index] == ElementKind::Group ||
+                kinds[index] == ElementKind::Use)
+                continue;
+            if (bounds[index].intersects(point)) scanned.push_back(index);
+        }
+        bvh.query(point, queried);
+        same = same && std::equal(scanned.begin(), scanned.end(),
+                                  queried.begin(), queried.end(),
+                                  [](std::uint32_t index,
+                                     const StoreShape& shape) {
+                                      return index == shape.index;
+                                  });
+    }
+    double scan_time = elapsed(start) / kScans;
+
+    std::cout << "shapes:              " << bvh.size() << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "hit test (us/query): " << point_time << " ("
+              << (double)point_hits / kPoints << " hits of "
+              << (double)candidates / kPoints << " candidates)" << std::endl;
+    std::cout << "area (us/query):     " << area_time << " ("
+              << (double)area_hits / kAreas << " hits)" << std::endl;
+    std::cout << "scan (us/query):     " << scan_time
+              << (same ? "" : " (results differ)") << std::endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Builds a scene of paths and texts and reads their fill rule, anchor and
+// font style the way the renderer picks its fill mode and text format: first
+// from strings returned by value and compared with the keywords, as the
+// shapes used to store them, then from the enums parsed once when the shapes
+// are built. The cost per element and the memory of the strings are reported.
+//
+// Usage: bench-keywords [element count] (default: 1000000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "Graphics.hpp"
+#include "SceneArena.hpp"
+
+namespace {
+    constexpr int kRounds = 5;
+
+    // The keywords of an element, as the shapes used to store them
+    struct KeywordStrings {
+        KeywordStrings(const char *fill_rule, const char *anchor,
+                       const char *style,
+                       const std::pmr::polymorphic_allocator<> &allocator)
+            : fill_rule(fill_rule, allocator), anchor(anchor, allocator),
+              style(style, allocator) {}
+
+        std::pmr::string fill_rule;
+        std::pmr::string anchor;
+        std::pmr::string style;
+    };
+
+    // Picks the fill mode and the format of an element from its strings
+    int visitStrings(const KeywordStrings &keywords) {
+        int mode = 0;
+        std::string fill_rule(keywords.fill_rule);
+        if (fill_rule == "evenodd") {
+            mode = 1;
+        } else if (fill_rule == "nonzero") {
+            mode = 2;
+        }
+        std::string anchor(keywords.anchor);
+        if (anchor == "middle") {
+            mode += 4;
+        } else if (anchor == "end") {
+            mode += 8;
+        }
+        std::string style(keywords.style);
+        if (style == "italic" || style == "oblique") mode += 16;
+        return mode;
+    }
+
+    // Picks the fill mode and the format of an element from its enums
+    int visitEnums(const SVGElement *shape) {
+        if (shape->getKind() == ElementKind::Path) {
+            return static_cast< const Path * >(shape)->getFillRule() ==
+                           FillRule::EvenOdd
+                       ? 1
+                       : 2;
+        }
+        const Text *text = static_cast< const Text * >(shape);
+        int mode = 0;
+        if (text->getAnchor() == TextAnchor::Middle) {
+            mode += 4;
+        } else if (text->getAnchor() == TextAnchor::End) {
+            mode += 8;
+        }
+        if (text->getFontStyle() != FontStyle::Normal) mode += 16;
+        return mode;
+    }
+
+    // Runs visit over count elements kRounds times, returns the best time in
+    // ms
+    template< typename Visit >
+    double time(int count, Visit visit, long &checksum) {
+        using Clock = std::chrono::steady_clock;
+        double best = 0;
+        for (int round = 0; round < kRounds; ++round) {
+            Clock::time_point start = Clock::now();
+            long sum = 0;
+            for (int i = 0; i < count; ++i) sum += visit(i);
+            double elapsed = std::chrono::duration< double, std::milli >(
+                                 Clock::now() - start)
+                                 .count();
+            if (round == 0 || elapsed < best) best = elapsed;
+            checksum = sum;
+        }
+        return best;
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    SceneArena arena;
+    std::vector< SVGElement * > shapes;
+    std::vector< const KeywordStrings * > strings;
+    shapes.reserve(count);
+    strings.reserve(count);
+    ColorShape fill = ColorShape::Red, stroke = ColorShape::Black;
+    for (int i = 0; i < count; ++i) {
+        if (i % 4 != 3) {
+            Path *path =
+                arena.create< Path >(fill, stroke, 1, arena.getAllocator());
+            bool even_odd = i % 2 == 0;
+            path->setFillRule(even_odd ? FillRule::EvenOdd
+                                       : FillRule::NonZero);
+            shapes.push_back(path);
+            strings.push_back(arena.create< KeywordStrings >(
+                even_odd ? "evenodd" : "nonzero", "", "",
+                arena.getAllocator()));
+        } else {
+            Text *text = arena.create< Text >(Vector2Df(0, 0), "", 12, fill,
+                                              stroke, 1, arena.getAllocator());
+            bool middle = i % 8 == 3;
+            text->setAnchor(middle ? TextAnchor::Middle : TextAnchor::Start);
+            text->setFontStyle(FontStyle::Italic);
+            shapes.push_back(text);
+            strings.push_back(arena.create< KeywordStrings >(
+                "", middle ? "middle" : "start", "italic",
+                arena.getAllocator()));
+        }
+    }
+
+    long string_sum = 0, enum_sum = 0;
+    double string_time = time(
+        count, [&](int i) { return visitStrings(*strings[i]); }, string_sum);
+    double enum_time =
+        time(count, [&](int i) { return visitEnums(shapes[i]); }, enum_sum);
+
+    std::cout << "elements:       " << count << std::endl;
+    // A path held one string, a text two
+    int texts = count / 4;
+    std::size_t string_bytes =
+        (count - texts + texts * 2) * sizeof(std::pmr::string);
+    std::cout << "string bytes:   " << string_bytes << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "by string (ms): " << string_time << " ("
+              << string_time * 1e6 / count << " ns/element)" << std::endl;
+    std::cout << "by enum (ms):   " << enum_time << " ("
+              << enum_time * 1e6 / count << " ns/element)" << std::endl;
+    std::cout << "speedup:        " << string_time / enum_time << "x"
+              << (string_sum == enum_sum ? "" : " (results differ)")
+              << std::endl;
+    return 0;
+}
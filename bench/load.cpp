@@ -0,0 +1,63 @@
+// Loads one SVG or SVGZ file and reports how it was brought into memory and
+// how long loading and parsing took. For a compressed file the throughput is
+// reported both in compressed and in decompressed bytes.
+//
+// Usage: bench-load file.svg [mapped|buffered|streaming] [threads] [cache]
+//        (threads: builds the top-level groups on that many threads, 0 for
+//        one per core; cache: reads or writes the scene cache file)
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Parser.hpp"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " file.svg [mapped|buffered|streaming] [threads] [cache]"
+                  << std::endl;
+        return 1;
+    }
+    LoadMode mode = LoadMode::Mapped;
+    if (argc > 2 && std::string(argv[2]) == "buffered")
+        mode = LoadMode::Buffered;
+    else if (argc > 2 && std::string(argv[2]) == "streaming")
+        mode = LoadMode::Streaming;
+
+    unsigned int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    std::string cache_file = argc > 4 ? argv[4] : "";
+
+    Parser parser(argv[1], mode, threads, cache_file);
+    LoadStats stats = parser.getLoadStats();
+    std::cout << "bytes:      " << stats.bytes
+              << (mode == LoadMode::Streaming ? " (streamed)"
+                  : stats.compressed_bytes != 0 ? " (inflated)"
+                  : stats.mapped                ? " (mapped)"
+                                                : " (read)") << std::endl;
+    if (stats.compressed_bytes != 0)
+        std::cout << "compressed: " << stats.compressed_bytes << std::endl;
+    std::cout << "load time:  " << stats.load_time << " ms" << std::endl;
+    std::cout << "parse time: " << stats.parse_time << " ms" << std::endl;
+    if (!cache_file.empty())
+        std::cout << "cache:      " << (stats.cache_hit ? "hit" : "miss")
+                  << std::endl;
+    if (stats.unique_ramps != 0)
+        std::cout << "ramps:      " << stats.unique_ramps << " unique, "
+                  << stats.ramp_bytes_saved << " bytes saved" << std::endl;
+    std::cout << "scene:      " << stats.arena_bytes << " bytes in the arena"
+              << std::endl;
+    std::cout << "store:      " << stats.store_bytes << " bytes, built in "
+              << stats.store_time << " ms" << std::endl;
+    std::cout << "bvh:        " << stats.bvh_bytes << " bytes, built in "
+              << stats.bvh_time << " ms" << std::endl;
+    double total_time = stats.load_time + stats.parse_time;
+    std::cout << "throughput: " << stats.bytes / total_time / 1e3 << " MB/s"
+              << std::endl;
+    if (stats.compressed_bytes != 0) {
+        std::cout << "compressed throughput: "
+                  << stats.compressed_bytes / total_time / 1e3 << " MB/s"
+                  << std::endl;
+    }
+    return 0;
+}
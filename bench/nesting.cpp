@@ -0,0 +1,51 @@
+// Parses generated documents of nested <g> elements, each setting presentation
+// attributes and holding a few shapes, and reports the parse time per element
+// for growing nesting depths. The time per element should stay flat.
+//
+// Usage: bench-nesting [max depth] (default: 4096)
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    // Writes a document with the given nesting depth
+    void writeDocument(std::ostream &file, int depth) {
+        file << "<svg width=\"100\" height=\"100\">\n";
+        for (int i = 0; i < depth; ++i) {
+            file << "<g fill=\"#" << std::hex << std::setw(6)
+                 << std::setfill('0') << (i * 2654435761u & 0xFFFFFF)
+                 << std::dec << "\" stroke-width=\"" << i % 7 + 1
+                 << "\" opacity=\"0.999\">\n"
+                 << "<rect x=\"" << i << "\" y=\"1\" width=\"2\" height=\"3\"/>"
+                 << "<circle cx=\"1\" cy=\"" << i
+                 << "\" r=\"2\" stroke=\"red\"/>\n";
+        }
+        for (int i = 0; i < depth; ++i) file << "</g>\n";
+        file << "</svg>\n";
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int max_depth = argc > 1 ? std::atoi(argv[1]) : 4096;
+
+    std::cout << std::setw(8) << "depth" << std::setw(12) << "elements"
+              << std::setw(14) << "parse (ms)" << std::setw(16) << "ns/element"
+              << std::endl;
+    for (int depth = 256; depth <= max_depth; depth *= 2) {
+        GeneratedDocument document("bench-nesting", writeDocument, depth);
+        double parse_time =
+            Parser(document.getFileName()).getLoadStats().parse_time;
+
+        int elements = depth * 3;
+        std::cout << std::setw(8) << depth << std::setw(12) << elements
+                  << std::fixed << std::setprecision(2) << std::setw(14)
+                  << parse_time << std::setw(16)
+                  << parse_time * 1e6 / elements << std::endl;
+    }
+    return 0;
+}
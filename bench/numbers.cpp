@@ -0,0 +1,177 @@
+// Compares the former numeric parsing (std::stof, std::stringstream and
+// sscanf) with the NumberScanner on the attributes of a synthetic document
+// holding one million numbers.
+//
+// Usage: bench-numbers [file.svg] (writes the synthetic document if given)
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../external/rapidxml/rapidxml.hpp"
+#include "NumberScanner.hpp"
+
+namespace {
+    constexpr int kNumberCount = 1000000;
+
+    // The kinds of numeric attributes, one per former parsing method
+    enum class Kind { Single, List, Transform, Color };
+
+    struct Value {
+        Kind kind;
+        const char *data;
+        std::size_t size;
+    };
+
+    // Generates a document mixing single values, point lists, transforms
+    // and colors, the way the elements of real files do
+    std::string generateDocument() {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "<svg width=\"1000\" height=\"1000\">\n";
+        unsigned int seed = 1;
+        auto random = [&seed]() {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 8) % 100000 / 100.0;
+        };
+        int numbers = 0;
+        while (numbers < kNumberCount) {
+            out << "<rect x=\"" << random() << "\" y=\"" << random()
+                << "\" width=\"" << random() << "\" height=\"" << random()
+                << "\" transform=\"translate(" << random() << ", " << random()
+                << ") scale(" << random() << ")\" fill=\"rgb("
+                << (int)random() % 256 << "," << (int)random() % 256 << ","
+                << (int)random() % 256 << ")\"/>\n";
+            out << "<polygon points=\"";
+            for (int i = 0; i < 8; ++i)
+                out << (i ? " " : "") << random() << "," << random();
+            out << "\"/>\n";
+            numbers += 10 + 16;
+        }
+        out << "</svg>\n";
+        return out.str();
+    }
+
+    // Collects the numeric attribute values of the document
+    std::vector< Value > collectValues(rapidxml::xml_node<> *svg) {
+        std::vector< Value > values;
+        for (auto node = svg->first_node(); node; node = node->next_sibling()) {
+            for (auto attribute = node->first_attribute(); attribute;
+                 attribute = attribute->next_attribute()) {
+                std::string name = attribute->name();
+                Kind kind = name == "points"      ? Kind::List
+                            : name == "transform" ? Kind::Transform
+                            : name == "fill"      ? Kind::Color
+                                                  : Kind::Single;
+                values.push_back(
+                    {kind, attribute->value(), attribute->value_size()});
+            }
+        }
+        return values;
+    }
+
+    // The parsing that each call site used to do
+    namespace legacy {
+        float parse(const Value &value) {
+            std::string text(value.data, value.size);
+            float sum = 0;
+            if (value.kind == Kind::Single) {
+                sum = std::stof(text);
+            } else if (value.kind == Kind::List) {
+                std::stringstream ss(text);
+                float x, y;
+                while (ss >> x) {
+                    if (ss.peek() == ',') ss.ignore();
+                    ss >> y;
+                    sum += x + y;
+                }
+            } else if (value.kind == Kind::Transform) {
+                float x = 0, y = 0, scale = 0;
+                sscanf(text.c_str(), "translate(%f, %f)", &x, &y);
+                sscanf(text.c_str() + text.find("scale"), "scale(%f)", &scale);
+                sum = x + y + scale;
+            } else {
+                int r, g, b;
+                float a = 1;
+                sscanf(text.c_str(), "rgb(%d,%d,%d,%f)", &r, &g, &b, &a);
+                sum = r + g + b + a;
+            }
+            return sum;
+        }
+    }  // namespace legacy
+
+    // The same parsing with the NumberScanner, straight from the buffer
+    float scan(const Value &value) {
+        if (value.kind == Kind::Single)
+            return NumberScanner::parse(
+                std::string_view(value.data, value.size));
+
+        float sum = 0, number;
+        const char *begin = value.data;
+        const char *end = value.data + value.size;
+        while (begin != end) {
+            // Skip the function names and parentheses between the numbers
+            while (begin != end && (*begin < '0' || *begin > '9') &&
+                   *begin != '-' && *begin != '.')
+                ++begin;
+            NumberScanner scanner(begin, end);
+            while (scanner.next(number)) sum += number;
+            begin = scanner.rest().data();
+            if (begin != end) ++begin;
+        }
+        return sum;
+    }
+
+    // Runs a function until it has taken a measurable amount of time and
+    // returns the average duration of one run in seconds
+    template< typename Function >
+    double measure(Function function) {
+        using Clock = std::chrono::steady_clock;
+        int runs = 0;
+        auto start = Clock::now();
+        std::chrono::duration< double > elapsed{0};
+        do {
+            function();
+            ++runs;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < 0.5);
+        return elapsed.count() / runs;
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string document = generateDocument();
+    if (argc > 1) std::ofstream(argv[1]) << document;
+
+    std::vector< char > buffer(document.begin(), document.end());
+    buffer.push_back('\0');
+    rapidxml::xml_document<> doc;
+    doc.parse< 0 >(buffer.data());
+    std::vector< Value > values = collectValues(doc.first_node());
+
+    std::size_t bytes = 0;
+    for (const Value &value : values) bytes += value.size;
+
+    double sink = 0;  // Keeps the measured work observable
+    double legacy_time = measure([&] {
+        for (const Value &value : values) sink += legacy::parse(value);
+    });
+    double scanner_time = measure([&] {
+        for (const Value &value : values) sink += scan(value);
+    });
+
+    std::cout << "numbers:       " << kNumberCount << std::endl;
+    std::cout << "attribute MB:  " << bytes / 1e6 << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "legacy MB/s:   " << bytes / legacy_time / 1e6 << std::endl;
+    std::cout << "scanner MB/s:  " << bytes / scanner_time / 1e6 << std::endl;
+    std::cout << "speedup:       " << legacy_time / scanner_time << "x"
+              << std::endl;
+    std::cout << "checksum " << sink << std::endl;
+    return 0;
+}
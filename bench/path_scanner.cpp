@@ -0,0 +1,211 @@
+// Compares the single-pass PathScanner with the former string-rewriting
+// pipeline of Parser::parsePathPoints on the path data of a sample directory.
+//
+// Usage: bench-path_scanner [directory] (default: external/samples/TestCases)
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../external/rapidxml/rapidxml.hpp"
+#include "PathScanner.hpp"
+
+namespace {
+    // The pre-processing steps that used to run before tokenizing, kept here
+    // as the reference implementation
+    namespace legacy {
+        void removeRedundantSpaces(std::string &path_string) {
+            std::size_t index = 0;
+            while (index < path_string.size()) {
+                if ((index == 0 || index == path_string.size() - 1) &&
+                    path_string[index] == ' ') {
+                    path_string.erase(index, 1);
+                } else if (path_string[index] == ' ' &&
+                           path_string[index - 1] == ' ') {
+                    path_string.erase(index, 1);
+                } else {
+                    index++;
+                }
+            }
+        }
+
+        void insertSpaceBeforeEachLetter(std::string &path_string) {
+            std::string result;
+            for (std::size_t index = 0; index < path_string.size(); index++) {
+                if (std::isalpha(path_string[index]) &&
+                    tolower(path_string[index]) != 'e') {
+                    result += " ";
+                    result += path_string[index];
+                    result += " ";
+                } else if (path_string[index] == '-' && index > 0 &&
+                           tolower(path_string[index - 1]) != 'e') {
+                    result += " ";
+                    result += path_string[index];
+                } else if (path_string[index] == '.') {
+                    if (index > 0 && path_string[index - 1] == '-')
+                        result += "0";
+                    else if (index > 0 && isalpha(path_string[index - 1]))
+                        result += " 0";
+                    result += path_string[index];
+                } else {
+                    result += path_string[index];
+                }
+            }
+            path_string = result;
+        }
+
+        void formatSvgPathString(std::string &path_string) {
+            std::replace(path_string.begin(), path_string.end(), '\t', ' ');
+            std::replace(path_string.begin(), path_string.end(), '\n', ' ');
+            insertSpaceBeforeEachLetter(path_string);
+            std::replace(path_string.begin(), path_string.end(), ',', ' ');
+            removeRedundantSpaces(path_string);
+
+            auto checkAbbreviation = [](const std::string &s) {
+                int cnt = 0;
+                for (auto c : s)
+                    if (c == '.') ++cnt;
+                return cnt == 2;
+            };
+
+            std::stringstream ss(path_string);
+            std::string element;
+            std::string result;
+            while (ss >> element) {
+                std::string point_x = "";
+                std::string point_y = "";
+                if (checkAbbreviation(element)) {
+                    for (int i = (int)element.size() - 1; i >= 0; --i) {
+                        if (element[i] == '.') {
+                            point_y = "0." + element.substr(i + 1);
+                            point_x = element.substr(0, i);
+                            break;
+                        }
+                    }
+                    result += point_x + ' ' + point_y + ' ';
+                } else
+                    result += element + ' ';
+            }
+            path_string = result;
+        }
+
+        // Tokenizes the path data the way parsePathPoints used to, returns
+        // the number of tokens
+        size_t tokenize(const char *data) {
+            std::string path_string = data;
+            formatSvgPathString(path_string);
+            std::stringstream ss(path_string);
+            std::string element;
+            size_t tokens = 0;
+            while (ss >> element) {
+                if (!std::isalpha(element[0])) std::stof(element);
+                ++tokens;
+            }
+            return tokens;
+        }
+    }  // namespace legacy
+
+    // Tokenizes the path data with the PathScanner, returns the number of
+    // argument groups
+    size_t scan(const char *data, size_t size) {
+        PathScanner scanner(data, data + size);
+        PathCommand command;
+        size_t groups = 0;
+        while (scanner.next(command)) ++groups;
+        return groups;
+    }
+
+    // Collects the path data of every <path> element below a node
+    void collectPathData(rapidxml::xml_node<> *node,
+                         std::vector< rapidxml::xml_attribute<> * > &data) {
+        for (auto child = node->first_node(); child;
+             child = child->next_sibling()) {
+            if (std::string(child->name()) == "path" &&
+                child->first_attribute("d"))
+                data.push_back(child->first_attribute("d"));
+            collectPathData(child, data);
+        }
+    }
+
+    // Runs a function until it has taken a measurable amount of time and
+    // returns the average duration of one run in seconds
+    template< typename Function >
+    double measure(Function function) {
+        using Clock = std::chrono::steady_clock;
+        int runs = 0;
+        auto start = Clock::now();
+        std::chrono::duration< double > elapsed{0};
+        do {
+            function();
+            ++runs;
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < 0.2);
+        return elapsed.count() / runs;
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string directory =
+        argc > 1 ? argv[1] : "external/samples/TestCases";
+    std::vector< std::filesystem::path > files;
+    for (auto &entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".svg") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    std::cout << std::left << std::setw(28) << "file" << std::right
+              << std::setw(10) << "bytes" << std::setw(14) << "legacy MB/s"
+              << std::setw(14) << "scanner MB/s" << std::setw(10) << "speedup"
+              << std::endl;
+
+    double total_bytes = 0, total_legacy = 0, total_scanner = 0;
+    size_t sink = 0;  // Keeps the measured work observable
+    for (auto &file_name : files) {
+        std::ifstream file(file_name, std::ios::binary);
+        std::vector< char > buffer((std::istreambuf_iterator< char >(file)),
+                                   std::istreambuf_iterator< char >());
+        buffer.push_back('\0');
+        rapidxml::xml_document<> doc;
+        doc.parse< 0 >(buffer.data());
+
+        std::vector< rapidxml::xml_attribute<> * > data;
+        collectPathData(&doc, data);
+        size_t bytes = 0;
+        for (auto attribute : data) bytes += attribute->value_size();
+        if (bytes == 0) continue;
+
+        double legacy_time = measure([&] {
+            for (auto attribute : data)
+                sink += legacy::tokenize(attribute->value());
+        });
+        double scanner_time = measure([&] {
+            for (auto attribute : data)
+                sink += scan(attribute->value(), attribute->value_size());
+        });
+
+        total_bytes += bytes;
+        total_legacy += legacy_time;
+        total_scanner += scanner_time;
+        std::cout << std::left << std::setw(28)
+                  << file_name.filename().string() << std::right
+                  << std::setw(10) << bytes << std::fixed
+                  << std::setprecision(1) << std::setw(14)
+                  << bytes / legacy_time / 1e6 << std::setw(14)
+                  << bytes / scanner_time / 1e6 << std::setw(9)
+                  << legacy_time / scanner_time << "x" << std::endl;
+    }
+
+    std::cout << std::left << std::setw(28) << "total" << std::right
+              << std::setw(10) << (size_t)total_bytes << std::setw(14)
+              << total_bytes / total_legacy / 1e6 << std::setw(14)
+              << total_bytes / total_scanner / 1e6 << std::setw(9)
+              << total_legacy / total_scanner << "x" << std::endl;
+    std::cout << "checksum " << sink << std::endl;
+    return 0;
+}
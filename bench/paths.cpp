@@ -0,0 +1,87 @@
+// Parses a generated map tile of road and contour paths, made of lines,
+// curves and a few arcs, and reports the memory of their geometry against a
+// full 28-byte record per vertex, as the paths used to store it. It then
+// times a pass over the packed coordinates computing the bounds of every
+// path.
+//
+// Usage: bench-paths [path count] (default: 100000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    // The former record of a path vertex
+    struct FatPathPoint {
+        Vector2Df point;
+        char tc;
+        Vector2Df radius;
+        float x_axis_rotation;
+        bool large_arc_flag;
+        bool sweep_flag;
+    };
+
+    // Writes the tile
+    void writeDocument(std::ostream &file, int paths) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < paths; ++i) {
+            int x = i * 7 % 1000, y = i * 13 % 1000;
+            file << "<path fill=\"none\" stroke=\"#888\" d=\"M" << x << " "
+                 << y << " l10 2 l8 -3 h5 v4 c3 1 6 4 8 9 s4 6 9 7 l6 -2";
+            if (i % 8 == 0) file << " a5 5 0 0 1 10 0";
+            file << " q4 6 10 4 t10 2\"/>\n";
+        }
+        file << "</svg>\n";
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    using Clock = std::chrono::steady_clock;
+    int paths = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    GeneratedDocument document("bench-paths", writeDocument, paths);
+    Parser parser(document.getFileName());
+
+    std::size_t vertices = 0, arcs = 0, packed_bytes = 0;
+    Clock::time_point start = Clock::now();
+    float extent = 0;
+    for (const SVGElement *element : parser.getRoot()->getElements()) {
+        if (element->getKind() != ElementKind::Path) continue;
+        PathView geometry = static_cast< const Path * >(element)->getGeometry();
+        if (geometry.points.empty()) continue;
+        Vector2Df min = geometry.points[0], max = geometry.points[0];
+        for (const Vector2Df &point : geometry.points) {
+            min.x = std::min(min.x, point.x);
+            min.y = std::min(min.y, point.y);
+            max.x = std::max(max.x, point.x);
+            max.y = std::max(max.y, point.y);
+        }
+        extent += max.x - min.x + max.y - min.y;
+        vertices += geometry.points.size();
+        arcs += geometry.arcs.size();
+        packed_bytes += geometry.commands.size_bytes() +
+                        geometry.points.size_bytes() +
+                        geometry.arcs.size_bytes();
+    }
+    double bounds_time =
+        std::chrono::duration< double, std::milli >(Clock::now() - start)
+            .count();
+    std::size_t fat_bytes = vertices * sizeof(FatPathPoint);
+
+    std::cout << "paths:        " << paths << std::endl;
+    std::cout << "vertices:     " << vertices << " (" << arcs << " arcs)"
+              << std::endl;
+    std::cout << "former bytes: " << fat_bytes << std::endl;
+    std::cout << "packed bytes: " << packed_bytes << " (" << std::fixed
+              << std::setprecision(2) << (double)fat_bytes / packed_bytes
+              << "x smaller)" << std::endl;
+    std::cout << "bounds (ms):  " << bounds_time << " (extent " << extent
+              << ")" << std::endl;
+    return 0;
+}
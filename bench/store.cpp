@@ -0,0 +1,134 @@
+// Parses a generated city map of transformed blocks of buildings, roads and
+// labels, then visits every shape with its world matrix twice: walking the
+// tree of SVGElements and composing the matrices on the way, as the renderer
+// used to, and scanning the flattened SceneStore. It then culls the scene to
+// a small area with the bounds of the store, and reports the time of each
+// pass with the memory of the store.
+//
+// Usage: bench-store [block count] (default: 40000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    constexpr int kRounds = 5;
+
+    // Writes the map
+    void writeDocument(std::ostream& file, int blocks) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < blocks; ++i) {
+            int x = i % 200 * 50, y = i / 200 * 50;
+            file << "<g transform=\"translate(" << x << " " << y << ")\">"
+                 << "<rect width=\"20\" height=\"30\" fill=\"#ccb\"/>"
+                 << "<g transform=\"rotate(" << i % 90 << " 30 10)\">"
+                 << "<rect x=\"25\" width=\"15\" height=\"15\" fill=\"#bbc\"/>"
+                 << "<polygon points=\"25,20 40,20 32,28\" fill=\"#a99\"/>"
+                 << "</g><path d=\"M0 45 L50 45 Q55 47 50 49 L0 49 Z\" "
+                    "fill=\"#666\"/>"
+                 << "<text x=\"2\" y=\"40\" font-size=\"4\">b" << i
+                 << "</text></g>\n";
+        }
+        file << "</svg>\n";
+    }
+
+    // Visits the shapes of a group with their world matrix, as the renderer
+    // used to
+    double walkTree(const Group* group, const AffineTransform& matrix) {
+        double sum = 0;
+        for (const SVGElement* element : group->getElements()) {
+            AffineTransform world = element->getTransform().isIdentity()
+                                        ? matrix
+                                        : matrix * element->getTransform();
+            if (element->getKind() == ElementKind::Group) {
+                sum += walkTree(static_cast< const Group* >(element), world);
+            } else if (element->getKind() == ElementKind::Use) {
+                const Group* symbol =
+                    static_cast< const Use* >(element)->getSymbol();
+                if (symbol != NULL) sum += walkTree(symbol, world);
+            } else {
+                sum += world.e + (int)element->getKind();
+            }
+        }
+        return sum;
+    }
+
+    // Visits the shapes of the store with their world matrix. The map has
+    // no symbols, so the tree of the document holds them all
+    double scanStore(const SceneStore& store) {
+        std::span< const ElementKind > kinds = store.getKinds();
+        double sum = 0;
+        for (std::uint32_t i = 0; i < store.getTreeSize(); ++i) {
+            if (kinds[i] == ElementKind::Group || kinds[i] == ElementKind::Use)
+                continue;
+            sum += store.getMatrix(i).e + (int)kinds[i];
+        }
+        return sum;
+    }
+
+    // Runs a pass kRounds times, returns the best time in ms
+    template< typename Pass >
+    double time(Pass pass, double& checksum) {
+        using Clock = std::chrono::steady_clock;
+        double best = 0;
+        for (int round = 0; round < kRounds; ++round) {
+            Clock::time_point start = Clock::now();
+            checksum = pass();
+            double elapsed = std::chrono::duration< double, std::milli >(
+                                 Clock::now() - start)
+                                 .count();
+            if (round == 0 || elapsed < best) best = elapsed;
+        }
+        return best;
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    int blocks = argc > 1 ? std::atoi(argv[1]) : 40000;
+
+    GeneratedDocument document("bench-store", writeDocument, blocks);
+    Parser parser(document.getFileName());
+    LoadStats stats = parser.getLoadStats();
+    const SceneStore& store = parser.getStore();
+
+    double tree_sum = 0, store_sum = 0, visible = 0;
+    double tree_time = time(
+        [&]() { return walkTree(parser.getRoot(), AffineTransform()); },
+        tree_sum);
+    double store_time = time([&]() { return scanStore(store); }, store_sum);
+
+    // An area of about a hundredth of the map
+    BoundingBox map = store.getBounds()[0];
+    Vector2Df size = map.max - map.min;
+    BoundingBox area(map.min, map.min + Vector2Df(size.x / 10, size.y / 10));
+    std::vector< StoreShape > shapes;
+    double query_time = time(
+        [&]() {
+            shapes.clear();
+            store.query(area, shapes);
+            return (double)shapes.size();
+        },
+        visible);
+
+    std::cout << "elements:        " << store.size() << " ("
+              << store.getStyleCount() << " styles, "
+              << store.getMatrixCount() << " matrices)" << std::endl;
+    std::cout << "store bytes:     " << stats.store_bytes << " (tree "
+              << stats.arena_bytes << ")" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "build (ms):      " << stats.store_time << " (parse "
+              << stats.parse_time << ")" << std::endl;
+    std::cout << "tree walk (ms):  " << tree_time << std::endl;
+    std::cout << "store scan (ms): " << store_time << " ("
+              << tree_time / store_time << "x faster"
+              << (tree_sum == store_sum ? "" : ", results differ") << ")"
+              << std::endl;
+    std::cout << "query (ms):      " << query_time << " (" << (int)visible
+              << " shapes visible)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Parses generated documents styled by a <style> sheet of a growing number
+// of class rules, like the exports of Illustrator, and by style attributes.
+// The rules are indexed by class, so the parse time per element should not
+// grow with the size of the sheet.
+//
+// Usage: bench-styles [element count] (default: 100000)
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    // Writes a document of elements using one of the rules each
+    void writeDocument(std::ostream &file, int elements, int rules) {
+        file << "<svg width=\"100\" height=\"100\">\n<style>\n";
+        for (int i = 0; i < rules; ++i) {
+            file << ".st" << i << "{fill:#" << std::hex << std::setw(6)
+                 << std::setfill('0') << (i * 2654435761u & 0xFFFFFF)
+                 << std::dec << ";stroke:#000;stroke-width:" << i % 4 + 1
+                 << "}\n";
+        }
+        file << "#e0{fill:none}\nrect{fill-opacity:0.5}\n</style>\n";
+        for (int i = 0; i < elements; ++i) {
+            file << "<rect id=\"e" << i << "\" class=\"st" << i % rules
+                 << "\" x=\"" << i % 100 << "\" y=\"" << i / 100 % 100
+                 << "\" width=\"1\" height=\"1\"";
+            if (i % 4 == 0) file << " style=\"opacity:0.5;stroke:none\"";
+            file << "/>\n";
+        }
+        file << "</svg>\n";
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int elements = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    std::cout << std::setw(10) << "elements" << std::setw(8) << "rules"
+              << std::setw(14) << "parse (ms)" << std::setw(14)
+              << "ns/element" << std::endl;
+    for (int rules : {10, 100, 1000, 10000}) {
+        GeneratedDocument document("bench-styles", writeDocument,
+                                   elements, rules);
+        LoadStats stats = Parser(document.getFileName()).getLoadStats();
+
+        std::cout << std::setw(10) << elements << std::setw(8) << rules
+                  << std::fixed << std::setprecision(2) << std::setw(14)
+                  << stats.parse_time << std::setw(14)
+                  << stats.parse_time * 1e6 / elements << std::endl;
+    }
+    return 0;
+}
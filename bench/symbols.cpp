@@ -0,0 +1,64 @@
+// Parses a dashboard repeating one icon symbol through <use> elements, then
+// the same dashboard with the icon copied inline at every place. The
+// instances share the subtree of the symbol, in the tree and in the
+// SceneStore, so the elements stored should follow the number of distinct
+// symbols and of uses while the shapes drawn follow the number of instances.
+//
+// Usage: bench-symbols [instance count] (default: 100000)
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    const char *const kIcon =
+        "<rect width=\"10\" height=\"10\" rx=\"2\" fill=\"#336699\"/>"
+        "<circle cx=\"5\" cy=\"5\" r=\"3\" fill=\"white\"/>"
+        "<path d=\"M2 8 L5 2 L8 8 Z\" fill=\"#ff9900\" stroke=\"black\"/>";
+
+    // Writes the dashboard, with <use> elements or inline copies
+    void writeDocument(std::ostream &file, int instances, bool use) {
+        file << "<svg xmlns:xlink=\"http://www.w3.org/1999/xlink\" "
+                "width=\"1000\" height=\"1000\">\n";
+        if (use) file << "<symbol id=\"icon\">" << kIcon << "</symbol>\n";
+        for (int i = 0; i < instances; ++i) {
+            int x = i % 100 * 10, y = i / 100 % 100 * 10;
+            if (use) {
+                file << "<use xlink:href=\"#icon\" x=\"" << x << "\" y=\""
+                     << y << "\"/>\n";
+            } else {
+                file << "<g transform=\"translate(" << x << " " << y << ")\">"
+                     << kIcon << "</g>\n";
+            }
+        }
+        file << "</svg>\n";
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int instances = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    std::cout << std::setw(8) << "mode" << std::setw(11) << "instances"
+              << std::setw(14) << "parse (ms)" << std::setw(8) << "trees"
+              << std::setw(10) << "stored" << std::setw(10) << "drawn"
+              << std::endl;
+    for (bool use : {true, false}) {
+        GeneratedDocument document("bench-symbols", writeDocument,
+                                   instances, use);
+        Parser parser(document.getFileName());
+
+        LoadStats stats = parser.getLoadStats();
+        const SceneStore &store = parser.getStore();
+        std::cout << std::setw(8) << (use ? "use" : "inline")
+                  << std::setw(11) << instances << std::fixed
+                  << std::setprecision(2) << std::setw(14) << stats.parse_time
+                  << std::setw(8) << stats.symbol_trees << std::setw(10)
+                  << store.size() << std::setw(10) << store.getShapeCount()
+                  << std::endl;
+    }
+    return 0;
+}
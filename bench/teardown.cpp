@@ -0,0 +1,60 @@
+// Parses generated documents of growing size, each group holding a path, a
+// polygon, a text and a rectangle, then destroys the parser. The tree lives
+// in the arena of the parser, so the teardown time should stay a small
+// fraction of the parse time however many elements the document has.
+//
+// Usage: bench-teardown [max group count] (default: 256000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "GeneratedDocument.hpp"
+#include "Parser.hpp"
+
+namespace {
+    // Writes a document with the given number of groups
+    void writeDocument(std::ostream &file, int groups) {
+        file << "<svg width=\"1000\" height=\"1000\">\n";
+        for (int i = 0; i < groups; ++i) {
+            int x = i % 100 * 10, y = i / 100 % 100 * 10;
+            file << "<g transform=\"translate(" << x << " " << y << ")\">"
+                 << "<path d=\"M0 0 L8 0 Q9 4 8 8 C4 9 2 9 0 8 Z\" "
+                    "fill=\"#336699\" fill-rule=\"evenodd\"/>"
+                 << "<polygon points=\"1,1 7,1 7,7 1,7\" fill=\"none\" "
+                    "stroke=\"black\"/>"
+                 << "<text x=\"1\" y=\"6\" font-size=\"4\" "
+                    "text-anchor=\"middle\">n" << i << "</text>"
+                 << "<rect width=\"2\" height=\"2\" fill=\"red\"/></g>\n";
+        }
+        file << "</svg>\n";
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    using Clock = std::chrono::steady_clock;
+    int max_groups = argc > 1 ? std::atoi(argv[1]) : 256000;
+
+    std::cout << std::setw(10) << "elements" << std::setw(14) << "parse (ms)"
+              << std::setw(13) << "arena (MB)" << std::setw(17)
+              << "teardown (ms)" << std::endl;
+    for (int groups = 4000; groups <= max_groups; groups *= 4) {
+        GeneratedDocument document("bench-teardown", writeDocument, groups);
+        Parser *parser = new Parser(document.getFileName());
+        LoadStats stats = parser->getLoadStats();
+
+        Clock::time_point start = Clock::now();
+        delete parser;
+        double teardown_time =
+            std::chrono::duration< double, std::milli >(Clock::now() - start)
+                .count();
+
+        std::cout << std::setw(10) << groups * 5 << std::fixed
+                  << std::setprecision(2) << std::setw(14) << stats.parse_time
+                  << std::setw(13) << stats.arena_bytes / 1e6 << std::setw(17)
+                  << teardown_time << std::endl;
+    }
+    return 0;
+}
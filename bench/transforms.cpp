@@ -0,0 +1,133 @@
+// Compares the former per-frame transform handling, which matched and read
+// the transform strings of every element each time it was drawn, with
+// composing the matrices resolved at parse time, over many frames of a
+// synthetic document.
+//
+// Usage: bench-transforms [element count] (default: 100000)
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "NumberScanner.hpp"
+#include "graphics/AffineTransform.hpp"
+
+namespace {
+    constexpr int kFrameCount = 20;
+
+    // Generates the transform lists of the elements, split the way the
+    // former parser stored them
+    std::vector< std::vector< std::string > > generateLists(int count) {
+        std::vector< std::vector< std::string > > lists;
+        unsigned int seed = 1;
+        auto random = [&seed]() {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 8) % 100000 / 100.0;
+        };
+        for (int i = 0; i < count; ++i) {
+            std::ostringstream translate, rotate, scale;
+            translate << "translate(" << random() << "," << random() << ")";
+            rotate << "rotate(" << random() << ")";
+            scale << "scale(" << random() / 100 << "," << random() / 100
+                  << ")";
+            lists.push_back({translate.str(), rotate.str(), scale.str()});
+        }
+        return lists;
+    }
+
+    // The renderer used to do this for every element of every frame
+    namespace legacy {
+        int getArguments(const std::string &type, float *args, int count) {
+            std::size_t open = type.find('(');
+            if (open == std::string::npos) return 0;
+            std::size_t close = type.find(')', open);
+            if (close == std::string::npos) close = type.size();
+            NumberScanner scanner(type.data() + open + 1,
+                                  type.data() + close);
+            int read = 0;
+            while (read < count && scanner.next(args[read])) ++read;
+            return read;
+        }
+
+        AffineTransform apply(std::vector< std::string > transform_order) {
+            AffineTransform result;
+            for (auto type : transform_order) {
+                float args[2] = {0, 0};
+                if (type.find("translate") != std::string::npos) {
+                    getArguments(type, args, 2);
+                    result = result *
+                             AffineTransform::translate(args[0], args[1]);
+                } else if (type.find("rotate") != std::string::npos) {
+                    getArguments(type, args, 1);
+                    result = result * AffineTransform::rotate(args[0]);
+                } else if (type.find("scale") != std::string::npos) {
+                    if (type.find(",") != std::string::npos) {
+                        getArguments(type, args, 2);
+                        result =
+                            result * AffineTransform::scale(args[0], args[1]);
+                    } else {
+                        getArguments(type, args, 1);
+                        result =
+                            result * AffineTransform::scale(args[0], args[0]);
+                    }
+                }
+            }
+            return result;
+        }
+    }  // namespace legacy
+
+    // Runs a function once and returns its duration in seconds
+    template< typename Function >
+    double measure(Function function) {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        function();
+        return std::chrono::duration< double >(Clock::now() - start).count();
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::vector< std::vector< std::string > > lists = generateLists(count);
+
+    // The parser now pays this cost once per element
+    std::vector< AffineTransform > matrices;
+    double resolve_time = measure([&] {
+        for (const auto &list : lists) matrices.push_back(legacy::apply(list));
+    });
+
+    double sink = 0;  // Keeps the measured work observable
+    double legacy_time = measure([&] {
+        for (int frame = 0; frame < kFrameCount; ++frame) {
+            for (const auto &list : lists) {
+                AffineTransform world = AffineTransform::scale(1, 1);
+                sink += (world * legacy::apply(list)).e;
+            }
+        }
+    });
+    double matrix_time = measure([&] {
+        for (int frame = 0; frame < kFrameCount; ++frame) {
+            for (const AffineTransform &matrix : matrices) {
+                AffineTransform world = AffineTransform::scale(1, 1);
+                sink += (world * matrix).e;
+            }
+        }
+    });
+
+    double per_frame = 1e3 / kFrameCount;
+    std::cout << "elements:          " << count << std::endl;
+    std::cout << "frames:            " << kFrameCount << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "resolve once (ms): " << resolve_time * 1e3 << std::endl;
+    std::cout << "legacy ms/frame:   " << legacy_time * per_frame << std::endl;
+    std::cout << "matrix ms/frame:   " << matrix_time * per_frame << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "speedup:           " << legacy_time / matrix_time << "x"
+              << std::endl;
+    std::cout << "checksum " << sink << std::endl;
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "AttributeTable.hpp"
+
+#include "ComputedStyle.hpp"
+#include "StyleSheet.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    constexpr std::size_t kAttributeCount = (std::size_t)AttributeId::Count;
+
+    // The CSS keyword taking the value of the parent: the attribute is left
+    // unset, so it resolves to the computed style or to its default
+    constexpr std::string_view kInherit = "inherit";
+
+    // Names of the attributes, in the order of AttributeId
+    constexpr std::array< std::string_view, kAttributeCount > names = {
+        "fill",              "fill-opacity",      "fill-rule",
+        "stroke",            "stroke-opacity",    "stroke-width",
+        "opacity",           "color",             "stop-color",
+        "stop-opacity",      "offset",            "transform",
+        "gradientTransform", "gradientUnits",     "font-size",
+        "font-style",        "text-anchor",       "x",
+        "y",                 "x1",                "y1",
+        "x2",                "y2",                "cx",
+        "cy",                "r",                 "rx",
+        "ry",                "fx",                "fy",
+        "fr",                "dx",                "dy",
+        "width",             "height",            "points",
+        "d",                 "id",                "xlink:href",
+        "viewBox",           "class",             "style",
+    };
+
+    // Values used when an attribute is not set, empty when the default
+    // depends on the element
+    constexpr std::array< std::string_view, kAttributeCount > defaults = [] {
+        std::array< std::string_view, kAttributeCount > defaults{};
+        defaults[(std::size_t)AttributeId::Fill] = "black";
+        defaults[(std::size_t)AttributeId::Color] = "black";
+        defaults[(std::size_t)AttributeId::StopColor] = "black";
+        defaults[(std::size_t)AttributeId::Stroke] = "none";
+        defaults[(std::size_t)AttributeId::Transform] = "none";
+        defaults[(std::size_t)AttributeId::FontStyle] = "none";
+        defaults[(std::size_t)AttributeId::TextAnchor] = "start";
+        defaults[(std::size_t)AttributeId::FillRule] = "nonzero";
+        defaults[(std::size_t)AttributeId::GradientUnits] =
+            "objectBoundingBox";
+        return defaults;
+    }();
+}  // namespace
+
+#ifdef SVG_COUNT_LOOKUPS
+thread_local std::size_t AttributeTable::compares_avoided = 0;
+thread_local std::size_t AttributeTable::lookups = 0;
+#endif
+
+AttributeTable::AttributeTable(rapidxml::xml_node<>* node,
+                               const StyleSheet* sheet)
+    : values{}, positions{}, attribute_count(0),
+      name(node->name(), node->name_size()),
+      value(node->value(), node->value_size()), style(NULL) {
+    for (auto attribute = node->first_attribute(); attribute;
+         attribute = attribute->next_attribute()) {
+        ++attribute_count;
+        AttributeId id = lookup(
+            std::string_view(attribute->name(), attribute->name_size()));
+        if (id == AttributeId::Count) continue;
+        // Like first_attribute(), the first occurrence of a name wins
+        std::size_t index = (std::size_t)id;
+        if (positions[index] != 0) continue;
+        std::string_view attribute_value(attribute->value(),
+                                         attribute->value_size());
+        if (attribute_value == kInherit) continue;
+        positions[index] = attribute_count;
+        values[index] = attribute_value;
+    }
+
+    // CSS overrides the presentation attributes: the matching rules first,
+    // then the style attribute
+    std::size_t style_index = (std::size_t)AttributeId::Style;
+    if ((!sheet || sheet->empty()) && positions[style_index] == 0) return;
+    thread_local std::vector< StyleSheet::Declaration > declarations;
+    declarations.clear();
+    if (sheet && !sheet->empty()) {
+        sheet->match(name, values[(std::size_t)AttributeId::Id],
+                     values[(std::size_t)AttributeId::Class], declarations);
+    }
+    StyleSheet::parseDeclarations(values[style_index], declarations);
+    for (const StyleSheet::Declaration& declaration : declarations) {
+        std::size_t index = (std::size_t)declaration.id;
+        if (declaration.value == kInherit) {
+            values[index] = std::string_view();
+            positions[index] = 0;
+            continue;
+        }
+        values[index] = declaration.value;
+        if (positions[index] == 0)
+            positions[index] = std::max< unsigned short >(attribute_count, 1);
+    }
+}
+
+AttributeId AttributeTable::lookup(std::string_view name) {
+    static const std::unordered_map< std::string_view, AttributeId > ids = [] {
+        std::unordered_map< std::string_view, AttributeId > ids;
+        for (std::size_t i = 0; i < kAttributeCount; ++i)
+            ids[names[i]] = (AttributeId)i;
+        return ids;
+    }();
+    auto id = ids.find(name);
+    return id == ids.end() ? AttributeId::Count : id->second;
+}
+
+void AttributeTable::setStyle(const ComputedStyle* style) {
+    this->style = style;
+}
+
+const ComputedStyle* AttributeTable::getStyle() const { return style; }
+
+bool AttributeTable::has(AttributeId id) const {
+    return positions[(std::size_t)id] != 0 || (style && style->has(id));
+}
+
+std::string_view AttributeTable::get(AttributeId id) const {
+#ifdef SVG_COUNT_LOOKUPS
+    count(id);
+#endif
+    std::size_t index = (std::size_t)id;
+    if (positions[index] != 0) return values[index];
+    if (style && style->has(id)) return style->get(id);
+    return defaults[index];
+}
+
+std::string_view AttributeTable::getName() const { return name; }
+
+std::string_view AttributeTable::getValue() const { return value; }
+
+#ifdef SVG_COUNT_LOOKUPS
+void AttributeTable::count(AttributeId id) const {
+    // A lookup by name scans the attributes up to the match, or all of them
+    // when the attribute is missing. The former getters looked a present
+    // attribute up twice.
+    std::size_t position = positions[(std::size_t)id];
+    std::size_t compares = position != 0 ? 2 * position : attribute_count;
+    compares_avoided += compares;
+    ++lookups;
+}
+
+std::size_t AttributeTable::getComparesAvoided() { return compares_avoided; }
+
+std::size_t AttributeTable::getLookups() { return lookups; }
+#endif
@@ -0,0 +1,188 @@
+#ifndef ATTRIBUTE_TABLE_HPP_
+#define ATTRIBUTE_TABLE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "../external/rapidxml/rapidxml.hpp"
+
+class ComputedStyle;
+class StyleSheet;
+
+/**
+ * @brief The attributes read by the parser, interned as integers.
+ */
+enum class AttributeId {
+    Fill,               ///< fill
+    FillOpacity,        ///< fill-opacity
+    FillRule,           ///< fill-rule
+    Stroke,             ///< stroke
+    StrokeOpacity,      ///< stroke-opacity
+    StrokeWidth,        ///< stroke-width
+    Opacity,            ///< opacity
+    Color,              ///< color, the value of currentColor
+    StopColor,          ///< stop-color
+    StopOpacity,        ///< stop-opacity
+    Offset,             ///< offset
+    Transform,          ///< transform
+    GradientTransform,  ///< gradientTransform
+    GradientUnits,      ///< gradientUnits
+    FontSize,           ///< font-size
+    FontStyle,          ///< font-style
+    TextAnchor,         ///< text-anchor
+    X,                  ///< x
+    Y,                  ///< y
+    X1,                 ///< x1
+    Y1,                 ///< y1
+    X2,                 ///< x2
+    Y2,                 ///< y2
+    Cx,                 ///< cx
+    Cy,                 ///< cy
+    R,                  ///< r
+    Rx,                 ///< rx
+    Ry,                 ///< ry
+    Fx,                 ///< fx
+    Fy,                 ///< fy
+    Fr,                 ///< fr
+    Dx,                 ///< dx
+    Dy,                 ///< dy
+    Width,              ///< width
+    Height,             ///< height
+    Points,             ///< points
+    D,                  ///< d
+    Id,                 ///< id
+    Href,               ///< xlink:href
+    ViewBox,            ///< viewBox
+    Class,              ///< class
+    Style,              ///< style
+    Count,              ///< Number of interned attributes
+};
+
+/**
+ * @brief The attributes of one XML node, indexed by AttributeId.
+ *
+ * The attributes of the node are sorted into the table in a single pass when
+ * the table is built, so every later lookup is an array index instead of a
+ * linear scan with string compares. Missing inherited attributes resolve to the
+ * computed style of the element when one is set, and every other missing
+ * attribute to its default value. The properties set by the rules of the style
+ * sheet and by the style attribute override the presentation attributes, the
+ * style attribute winning over the rules. A value of "inherit" leaves the
+ * attribute unset, so that it resolves like a missing one. The values point
+ * into the node or the style sheet and stay valid as long as both.
+ */
+class AttributeTable {
+public:
+    /**
+     * @brief Sorts the attributes of a node into a table.
+     *
+     * @param node The node whose attributes are read.
+     * @param sheet The style sheet of the document, or NULL.
+     */
+    explicit AttributeTable(rapidxml::xml_node<>* node,
+                            const StyleSheet* sheet = NULL);
+
+    /**
+     * @brief Sets the computed style used for the missing inherited
+     * attributes.
+     *
+     * @param style The computed style of the element, or NULL.
+     */
+    void setStyle(const ComputedStyle* style);
+
+    /**
+     * @brief Gets the computed style used for the missing inherited
+     * attributes.
+     *
+     * @return The computed style of the element, or NULL.
+     */
+    const ComputedStyle* getStyle() const;
+
+    /**
+     * @brief Checks whether the node has an attribute.
+     *
+     * @param id The attribute to be checked.
+     * @return True if the attribute is set on the node or inherited from its
+     * computed style.
+     */
+    bool has(AttributeId id) const;
+
+    /**
+     * @brief Gets the value of an attribute.
+     *
+     * @param id The attribute to be read.
+     * @return The value of the attribute, the inherited value, or the
+     * default value of the attribute.
+     */
+    std::string_view get(AttributeId id) const;
+
+    /**
+     * @brief Gets the name of the node.
+     *
+     * @return The name of the node.
+     */
+    std::string_view getName() const;
+
+    /**
+     * @brief Gets the character data of the node.
+     *
+     * @return The first run of characters inside the node.
+     */
+    std::string_view getValue() const;
+
+    /**
+     * @brief Interns an attribute name.
+     *
+     * @param name The name of the attribute.
+     * @return The id of the attribute, or AttributeId::Count if the parser
+     * does not read this attribute.
+     */
+    static AttributeId lookup(std::string_view name);
+
+#ifdef SVG_COUNT_LOOKUPS
+    /**
+     * @brief Gets the number of attribute name compares that the lookups
+     * saved, compared with scanning the attributes of the node by name.
+     *
+     * @return The number of compares avoided by the calling thread.
+     * @note Only counted in builds defining SVG_COUNT_LOOKUPS, like
+     * bench-attributes, to keep get() a plain indexed load otherwise.
+     */
+    static std::size_t getComparesAvoided();
+
+    /**
+     * @brief Gets the number of lookups made in all tables.
+     *
+     * @return The number of lookups made by the calling thread.
+     */
+    static std::size_t getLookups();
+#endif
+
+private:
+#ifdef SVG_COUNT_LOOKUPS
+    /**
+     * @brief Records the compares avoided by looking up an attribute.
+     *
+     * @param id The attribute looked up.
+     */
+    void count(AttributeId id) const;
+#endif
+
+    /// Values of the attributes set on the node
+    std::array< std::string_view, (std::size_t)AttributeId::Count > values;
+    /// 1-based position of each attribute on the node, 0 if not set
+    std::array< unsigned short, (std::size_t)AttributeId::Count > positions;
+    unsigned short attribute_count;  ///< Number of attributes of the node
+    std::string_view name;           ///< Name of the node
+    std::string_view value;          ///< Character data of the node
+    const ComputedStyle* style;      ///< Style of the element, may be NULL
+
+#ifdef SVG_COUNT_LOOKUPS
+    // Counted per thread, so that concurrent parsers do not share them
+    static thread_local std::size_t compares_avoided;  ///< Saved compares
+    static thread_local std::size_t lookups;           ///< Lookups made
+#endif
+};
+
+#endif  // ATTRIBUTE_TABLE_HPP_
@@ -0,0 +1,342 @@
+#include "ColorParser.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+#include "NumberScanner.hpp"
+
+namespace {
+    struct NamedColor {
+        std::string_view name;
+        unsigned char r, g, b, a;
+    };
+
+    // The CSS named colors and "transparent", sorted by name
+    constexpr NamedColor kNamedColors[] = {
+        {"aliceblue", 240, 248, 255, 255},
+        {"antiquewhite", 250, 235, 215, 255},
+        {"aqua", 0, 255, 255, 255},
+        {"aquamarine", 127, 255, 212, 255},
+        {"azure", 240, 255, 255, 255},
+        {"beige", 245, 245, 220, 255},
+        {"bisque", 255, 228, 196, 255},
+        {"black", 0, 0, 0, 255},
+        {"blanchedalmond", 255, 235, 205, 255},
+        {"blue", 0, 0, 255, 255},
+        {"blueviolet", 138, 43, 226, 255},
+        {"brown", 165, 42, 42, 255},
+        {"burlywood", 222, 184, 135, 255},
+        {"cadetblue", 95, 158, 160, 255},
+        {"chartreuse", 127, 255, 0, 255},
+        {"chocolate", 210, 105, 30, 255},
+        {"coral", 255, 127, 80, 255},
+        {"cornflowerblue", 100, 149, 237, 255},
+        {"cornsilk", 255, 248, 220, 255},
+        {"crimson", 220, 20, 60, 255},
+        {"cyan", 0, 255, 255, 255},
+        {"darkblue", 0, 0, 139, 255},
+        {"darkcyan", 0, 139, 139, 255},
+        {"darkgoldenrod", 184, 134, 11, 255},
+        {"darkgray", 169, 169, 169, 255},
+        {"darkgreen", 0, 100, 0, 255},
+        {"darkgrey", 169, 169, 169, 255},
+        {"darkkhaki", 189, 183, 107, 255},
+        {"darkmagenta", 139, 0, 139, 255},
+        {"darkolivegreen", 85, 107, 47, 255},
+        {"darkorange", 255, 140, 0, 255},
+        {"darkorchid", 153, 50, 204, 255},
+        {"darkred", 139, 0, 0, 255},
+        {"darksalmon", 233, 150, 122, 255},
+        {"darkseagreen", 143, 188, 143, 255},
+        {"darkslateblue", 72, 61, 139, 255},
+        {"darkslategray", 47, 79, 79, 255},
+        {"darkslategrey", 47, 79, 79, 255},
+        {"darkturquoise", 0, 206, 209, 255},
+        {"darkviolet", 148, 0, 211, 255},
+        {"deeppink", 255, 20, 147, 255},
+        {"deepskyblue", 0, 191, 255, 255},
+        {"dimgray", 105, 105, 105, 255},
+        {"dimgrey", 105, 105, 105, 255},
+        {"dodgerblue", 30, 144, 255, 255},
+        {"firebrick", 178, 34, 34, 255},
+        {"floralwhite", 255, 250, 240, 255},
+        {"forestgreen", 34, 139, 34, 255},
+        {"fuchsia", 255, 0, 255, 255},
+        {"gainsboro", 220, 220, 220, 255},
+        {"ghostwhite", 248, 248, 255, 255},
+        {"gold", 255, 215, 0, 255},
+        {"goldenrod", 218, 165, 32, 255},
+        {"gray", 128, 128, 128, 255},
+        {"green", 0, 128, 0, 255},
+        {"greenyellow", 173, 255, 47, 255},
+        {"grey", 128, 128, 128, 255},
+        {"honeydew", 240, 255, 240, 255},
+        {"hotpink", 255, 105, 180, 255},
+        {"indianred", 205, 92, 92, 255},
+        {"indigo", 75, 0, 130, 255},
+        {"ivory", 255, 255, 240, 255},
+        {"khaki", 240, 230, 140, 255},
+        {"lavender", 230, 230, 250, 255},
+        {"lavenderblush", 255, 240, 245, 255},
+        {"lawngreen", 124, 252, 0, 255},
+        {"lemonchiffon", 255, 250, 205, 255},
+        {"lightblue", 173, 216, 230, 255},
+        {"lightcoral", 240, 128, 128, 255},
+        {"lightcyan", 224, 255, 255, 255},
+        {"lightgoldenrodyellow", 250, 250, 210, 255},
+        {"lightgray", 211, 211, 211, 255},
+        {"lightgreen", 144, 238, 144, 255},
+        {"lightgrey", 211, 211, 211, 255},
+        {"lightpink", 255, 182, 193, 255},
+        {"lightsalmon", 255, 160, 122, 255},
+        {"lightseagreen", 32, 178, 170, 255},
+        {"lightskyblue", 135, 206, 250, 255},
+        {"lightslategray", 119, 136, 153, 255},
+        {"lightslategrey", 119, 136, 153, 255},
+        {"lightsteelblue", 176, 196, 222, 255},
+        {"lightyellow", 255, 255, 224, 255},
+        {"lime", 0, 255, 0, 255},
+        {"limegreen", 50, 205, 50, 255},
+        {"linen", 250, 240, 230, 255},
+        {"magenta", 255, 0, 255, 255},
+        {"maroon", 128, 0, 0, 255},
+        {"mediumaquamarine", 102, 205, 170, 255},
+        {"mediumblue", 0, 0, 205, 255},
+        {"mediumorchid", 186, 85, 211, 255},
+        {"mediumpurple", 147, 112, 219, 255},
+        {"mediumseagreen", 60, 179, 113, 255},
+        {"mediumslateblue", 123, 104, 238, 255},
+        {"mediumspringgreen", 0, 250, 154, 255},
+        {"mediumturquoise", 72, 209, 204, 255},
+        {"mediumvioletred", 199, 21, 133, 255},
+        {"midnightblue", 25, 25, 112, 255},
+        {"mintcream", 245, 255, 250, 255},
+        {"mistyrose", 255, 228, 225, 255},
+        {"moccasin", 255, 228, 181, 255},
+        {"navajowhite", 255, 222, 173, 255},
+        {"navy", 0, 0, 128, 255},
+        {"oldlace", 253, 245, 230, 255},
+        {"olive", 128, 128, 0, 255},
+        {"olivedrab", 107, 142, 35, 255},
+        {"orange", 255, 165, 0, 255},
+        {"orangered", 255, 69, 0, 255},
+        {"orchid", 218, 112, 214, 255},
+        {"palegoldenrod", 238, 232, 170, 255},
+        {"palegreen", 152, 251, 152, 255},
+        {"paleturquoise", 175, 238, 238, 255},
+        {"palevioletred", 219, 112, 147, 255},
+        {"papayawhip", 255, 239, 213, 255},
+        {"peachpuff", 255, 218, 185, 255},
+        {"peru", 205, 133, 63, 255},
+        {"pink", 255, 192, 203, 255},
+        {"plum", 221, 160, 221, 255},
+        {"powderblue", 176, 224, 230, 255},
+        {"purple", 128, 0, 128, 255},
+        {"red", 255, 0, 0, 255},
+        {"rosybrown", 188, 143, 143, 255},
+        {"royalblue", 65, 105, 225, 255},
+        {"saddlebrown", 139, 69, 19, 255},
+        {"salmon", 250, 128, 114, 255},
+        {"sandybrown", 244, 164, 96, 255},
+        {"seagreen", 46, 139, 87, 255},
+        {"seashell", 255, 245, 238, 255},
+        {"sienna", 160, 82, 45, 255},
+        {"silver", 192, 192, 192, 255},
+        {"skyblue", 135, 206, 235, 255},
+        {"slateblue", 106, 90, 205, 255},
+        {"slategray", 112, 128, 144, 255},
+        {"slategrey", 112, 128, 144, 255},
+        {"snow", 255, 250, 250, 255},
+        {"springgreen", 0, 255, 127, 255},
+        {"steelblue", 70, 130, 180, 255},
+        {"tan", 210, 180, 140, 255},
+        {"teal", 0, 128, 128, 255},
+        {"thistle", 216, 191, 216, 255},
+        {"tomato", 255, 99, 71, 255},
+        {"transparent", 0, 0, 0, 0},
+        {"turquoise", 64, 224, 208, 255},
+        {"violet", 238, 130, 238, 255},
+        {"wheat", 245, 222, 179, 255},
+        {"white", 255, 255, 255, 255},
+        {"whitesmoke", 245, 245, 245, 255},
+        {"yellow", 255, 255, 0, 255},
+        {"yellowgreen", 154, 205, 50, 255},
+    };
+
+    constexpr std::size_t kColorCount = std::size(kNamedColors);
+    constexpr std::size_t kBucketCount = 64;
+    constexpr std::size_t kSlotCount = 256;
+
+    constexpr char toLower(char c) {
+        return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+    }
+
+    // FNV-1a of the lowercase name, seeded and mixed so that the low bits
+    // used for the slot depend on every character
+    constexpr std::uint32_t hash(std::string_view name, std::uint32_t seed) {
+        std::uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (char c : name) {
+            h ^= (unsigned char)toLower(c);
+            h *= 16777619u;
+        }
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    // Two-level perfect hash: the first hash picks a bucket, and the
+    // displacement of the bucket seeds the second hash, which picks a slot
+    // that no other name uses
+    struct HashTable {
+        std::uint16_t displacement[kBucketCount];
+        std::uint8_t slot[kSlotCount];  // Color index + 1, 0 if empty
+        bool complete;
+    };
+
+    constexpr HashTable buildTable() {
+        HashTable table{};
+        std::size_t bucket[kColorCount] = {};
+        std::size_t size[kBucketCount] = {};
+        for (std::size_t i = 0; i < kColorCount; ++i) {
+            bucket[i] = hash(kNamedColors[i].name, 0) % kBucketCount;
+            ++size[bucket[i]];
+        }
+
+        table.complete = true;
+        // The largest buckets are placed first, while most slots are free
+        for (std::size_t wanted = kColorCount; wanted > 0; --wanted) {
+            for (std::size_t b = 0; b < kBucketCount; ++b) {
+                if (size[b] != wanted) continue;
+                bool placed = false;
+                for (std::uint16_t d = 1; d < 1024 && !placed; ++d) {
+                    std::size_t slots[kColorCount] = {};
+                    std::size_t keys[kColorCount] = {};
+                    std::size_t count = 0;
+                    placed = true;
+                    for (std::size_t i = 0; i < kColorCount && placed; ++i) {
+                        if (bucket[i] != b) continue;
+                        std::size_t s = hash(kNamedColors[i].name, d) %
+                                        kSlotCount;
+                        if (table.slot[s] != 0) placed = false;
+                        for (std::size_t j = 0; j < count; ++j)
+                            if (slots[j] == s) placed = false;
+                        slots[count] = s;
+                        keys[count++] = i;
+                    }
+                    if (!placed) continue;
+                    table.displacement[b] = d;
+                    for (std::size_t j = 0; j < count; ++j)
+                        table.slot[slots[j]] = keys[j] + 1;
+                }
+                if (!placed) table.complete = false;
+            }
+        }
+        return table;
+    }
+
+    constexpr HashTable kTable = buildTable();
+    static_assert(kTable.complete, "No perfect hash for the color names");
+
+    // Value of every hex digit, 16 for the other characters
+    constexpr std::array< std::uint8_t, 256 > kHexDigits = [] {
+        std::array< std::uint8_t, 256 > digits{};
+        for (auto &digit : digits) digit = 16;
+        for (int c = '0'; c <= '9'; ++c) digits[c] = c - '0';
+        for (int c = 'a'; c <= 'f'; ++c) digits[c] = c - 'a' + 10;
+        for (int c = 'A'; c <= 'F'; ++c) digits[c] = c - 'A' + 10;
+        return digits;
+    }();
+
+    int hexDigit(char c) { return kHexDigits[(unsigned char)c]; }
+
+    bool equalsIgnoreCase(std::string_view lower, std::string_view text) {
+        if (lower.size() != text.size()) return false;
+        for (std::size_t i = 0; i < lower.size(); ++i)
+            if (lower[i] != toLower(text[i])) return false;
+        return true;
+    }
+
+    bool startsWithIgnoreCase(std::string_view text, std::string_view lower) {
+        return text.size() >= lower.size() &&
+               equalsIgnoreCase(lower, text.substr(0, lower.size()));
+    }
+
+    // Separators allowed between the components of a color function
+    void skipSeparators(const char *&cursor, const char *end) {
+        while (cursor != end && (*cursor == ' ' || *cursor == '\t' ||
+                                 *cursor == '\n' || *cursor == '\r' ||
+                                 *cursor == ',' || *cursor == '/'))
+            ++cursor;
+    }
+}  // namespace
+
+bool ColorParser::parse(std::string_view text, ColorShape &color) {
+    if (!text.empty() && text[0] == '#') return parseHex(text, color);
+    if (startsWithIgnoreCase(text, "rgb")) return parseRgb(text, color);
+    return parseName(text, color);
+}
+
+bool ColorParser::parseName(std::string_view name, ColorShape &color) {
+    std::uint16_t d = kTable.displacement[hash(name, 0) % kBucketCount];
+    std::uint8_t index = kTable.slot[hash(name, d) % kSlotCount];
+    if (index == 0) return false;
+    const NamedColor &entry = kNamedColors[index - 1];
+    if (!equalsIgnoreCase(entry.name, name)) return false;
+    color = ColorShape(entry.r, entry.g, entry.b, entry.a);
+    return true;
+}
+
+bool ColorParser::parseHex(std::string_view text, ColorShape &color) {
+    if (text.empty() || text[0] != '#') return false;
+    std::string_view digits = text.substr(1);
+    // Every invalid character sets bit 4 of the union of the digit values
+    int invalid = 0;
+    for (char c : digits) invalid |= hexDigit(c);
+    if (invalid & 16) return false;
+
+    auto nibble = [&](int i) { return hexDigit(digits[i]) * 17; };
+    auto pair = [&](int i) {
+        return hexDigit(digits[i]) * 16 + hexDigit(digits[i + 1]);
+    };
+    switch (digits.size()) {
+        case 3:
+            color = ColorShape(nibble(0), nibble(1), nibble(2), 255);
+            return true;
+        case 4:
+            color = ColorShape(nibble(0), nibble(1), nibble(2), nibble(3));
+            return true;
+        case 6:
+            color = ColorShape(pair(0), pair(2), pair(4), 255);
+            return true;
+        case 8:
+            color = ColorShape(pair(0), pair(2), pair(4), pair(6));
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool ColorParser::parseRgb(std::string_view text, ColorShape &color) {
+    std::size_t open = text.find('(');
+    if (open == std::string_view::npos) return false;
+    const char *cursor = text.data() + open + 1;
+    const char *end = text.data() + text.size();
+
+    float components[4] = {0, 0, 0, 1};
+    int count = 0;
+    while (count < 4) {
+        skipSeparators(cursor, end);
+        if (!NumberScanner::scan(cursor, end, components[count])) break;
+        if (cursor != end && *cursor == '%') {
+            components[count] *= count < 3 ? 2.55f : 0.01f;
+            ++cursor;
+        }
+        ++count;
+    }
+    if (count < 3) return false;
+    color = ColorShape((int)components[0], (int)components[1],
+                       (int)components[2], 255 * components[3]);
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef COLOR_PARSER_HPP_
+#define COLOR_PARSER_HPP_
+
+#include <string_view>
+
+#include "graphics/ColorShape.hpp"
+
+/**
+ * @brief Allocation-free decoder of the color values of an SVG file.
+ *
+ * The ColorParser reads named colors ("steelblue"), hex colors ("#abc",
+ * "#aabbcc80") and color functions ("rgb(1, 2, 3)", "rgba(10%, 0, 0, 0.5)")
+ * straight from the attribute value. Named colors are found through a perfect
+ * hash table generated at compile time, so a lookup costs two hashes and one
+ * compare, and hex digits are decoded through a lookup table.
+ */
+class ColorParser {
+public:
+    /**
+     * @brief Decodes a color value.
+     *
+     * @param text The value, without leading or trailing whitespaces.
+     * @param color The decoded color.
+     * @return True if the value is a valid named, hex or rgb color.
+     * @note Names are case-insensitive.
+     */
+    static bool parse(std::string_view text, ColorShape& color);
+
+    /**
+     * @brief Looks up a named color.
+     *
+     * @param name The name of the color, in any case.
+     * @param color The color with the given name.
+     * @return True if the name is a known color name.
+     */
+    static bool parseName(std::string_view name, ColorShape& color);
+
+    /**
+     * @brief Decodes a hex color.
+     *
+     * @param text The value, starting with '#' and followed by 3, 4, 6 or 8
+     * hex digits.
+     * @param color The decoded color.
+     * @return True if the value is a valid hex color.
+     */
+    static bool parseHex(std::string_view text, ColorShape& color);
+
+    /**
+     * @brief Decodes an rgb() or rgba() color function.
+     *
+     * @param text The value, starting with "rgb(" or "rgba(".
+     * @param color The decoded color.
+     * @return True if the three color components were read.
+     * @note Components may be numbers or percentages, separated by commas or
+     * whitespaces. The optional alpha is in the range [0, 1] or a percentage.
+     */
+    static bool parseRgb(std::string_view text, ColorShape& color);
+};
+
+#endif  // COLOR_PARSER_HPP_
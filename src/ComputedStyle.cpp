@@ -0,0 +1,80 @@
+#include "ComputedStyle.hpp"
+
+#include "NumberScanner.hpp"
+
+ComputedStyle::ComputedStyle() : set_mask(0), opacity(1) {}
+
+int ComputedStyle::getSlot(AttributeId id) {
+    switch (id) {
+        case AttributeId::Fill:
+            return 0;
+        case AttributeId::FillOpacity:
+            return 1;
+        case AttributeId::FillRule:
+            return 2;
+        case AttributeId::Stroke:
+            return 3;
+        case AttributeId::StrokeOpacity:
+            return 4;
+        case AttributeId::StrokeWidth:
+            return 5;
+        case AttributeId::FontSize:
+            return 6;
+        case AttributeId::FontStyle:
+            return 7;
+        case AttributeId::TextAnchor:
+            return 8;
+        case AttributeId::Color:
+            return 9;
+        default:
+            return -1;
+    }
+}
+
+bool ComputedStyle::isInherited(AttributeId id) { return getSlot(id) >= 0; }
+
+const ComputedStyle* ComputedStyle::derive(const ComputedStyle* parent,
+                                           const AttributeTable& attributes,
+                                           SceneArena& arena) {
+    bool overrides = attributes.has(AttributeId::Opacity);
+    for (int i = 0; i < (int)AttributeId::Count && !overrides; ++i) {
+        AttributeId id = (AttributeId)i;
+        overrides = isInherited(id) && attributes.has(id);
+    }
+    if (!overrides) return parent;
+
+    ComputedStyle* style = arena.create< ComputedStyle >(*parent);
+    for (int i = 0; i < (int)AttributeId::Count; ++i) {
+        AttributeId id = (AttributeId)i;
+        int slot = getSlot(id);
+        if (slot < 0 || !attributes.has(id)) continue;
+        // The attributes do not outlive the parsing, the scene does
+        style->values[slot] = arena.copy(attributes.get(id));
+        style->set_mask |= 1u << slot;
+    }
+    if (attributes.has(AttributeId::Opacity))
+        style->opacity *=
+            NumberScanner::parse(attributes.get(AttributeId::Opacity), 1);
+    return style;
+}
+
+bool ComputedStyle::has(AttributeId id) const {
+    int slot = getSlot(id);
+    return slot >= 0 && (set_mask & (1u << slot)) != 0;
+}
+
+std::string_view ComputedStyle::get(AttributeId id) const {
+    if (!has(id)) return std::string_view();
+    return values[getSlot(id)];
+}
+
+float ComputedStyle::getOpacity() const { return opacity; }
+
+bool ComputedStyle::operator==(const ComputedStyle& other) const {
+    if (set_mask != other.set_mask || opacity != other.opacity) return false;
+    for (int slot = 0; slot < kSlotCount; ++slot) {
+        if ((set_mask & (1u << slot)) && values[slot] != other.values[slot])
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,102 @@
+#ifndef COMPUTED_STYLE_HPP_
+#define COMPUTED_STYLE_HPP_
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "AttributeTable.hpp"
+#include "SceneArena.hpp"
+
+/**
+ * @brief The inherited presentation attributes of an element, resolved once.
+ *
+ * A ComputedStyle is immutable and lives in the arena of the scene, with the
+ * copies of its values, so it needs no destructor. Every group pushes one
+ * record holding the attributes it sets on top of the record of its parent,
+ * and every shape points to its resolved record. Elements that do not set any
+ * inherited attribute share the record of their parent, so a child costs no
+ * copy at all. The opacity is not inherited in SVG but every record holds the
+ * product of the opacities of the element and its ancestors, which is how the
+ * renderer applies group opacity.
+ */
+class ComputedStyle {
+public:
+    /**
+     * @brief Constructs the initial style, where no attribute is set.
+     */
+    ComputedStyle();
+
+    /**
+     * @brief Resolves the style of an element.
+     *
+     * @param parent The style of the parent of the element.
+     * @param attributes The attributes of the element.
+     * @param arena The arena of the scene, receiving a new record.
+     * @return The style of the parent if the element sets no inherited
+     * attribute, a new record otherwise.
+     */
+    static const ComputedStyle* derive(const ComputedStyle* parent,
+                                       const AttributeTable& attributes,
+                                       SceneArena& arena);
+
+    /**
+     * @brief Checks whether an attribute is inherited by the children.
+     *
+     * @param id The attribute to be checked.
+     * @return True if the attribute is inherited.
+     */
+    static bool isInherited(AttributeId id);
+
+    /**
+     * @brief Checks whether an inherited attribute is set.
+     *
+     * @param id The attribute to be checked.
+     * @return True if the element or one of its ancestors sets the attribute.
+     */
+    bool has(AttributeId id) const;
+
+    /**
+     * @brief Gets the value of an inherited attribute.
+     *
+     * @param id The attribute to be read.
+     * @return The value set by the element or its closest ancestor, or an
+     * empty string if the attribute is not set.
+     */
+    std::string_view get(AttributeId id) const;
+
+    /**
+     * @brief Gets the opacity of the element.
+     *
+     * @return The product of the opacities of the element and its ancestors.
+     */
+    float getOpacity() const;
+
+    /**
+     * @brief Compares the resolved values of two styles.
+     *
+     * @param other The style to be compared with.
+     * @return True if both styles set the same attributes to the same values
+     * and have the same opacity.
+     */
+    bool operator==(const ComputedStyle& other) const;
+
+private:
+    /**
+     * @brief Gets the slot of an inherited attribute.
+     *
+     * @param id The attribute.
+     * @return The index of the attribute in the record, or -1 if the
+     * attribute is not inherited.
+     */
+    static int getSlot(AttributeId id);
+
+    static constexpr int kSlotCount = 10;  ///< Number of inherited attributes
+
+    std::array< std::string_view, kSlotCount > values;  ///< Inherited values
+    unsigned int set_mask;  ///< Bit i is set if slot i has a value
+    float opacity;          ///< Product of the ancestor opacities
+};
+
+#endif  // COMPUTED_STYLE_HPP_
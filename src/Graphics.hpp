@@ -13,6 +13,7 @@
 #include "graphics/RadialGradient.hpp"
 #include "graphics/Rect.hpp"
 #include "graphics/Text.hpp"
+#include "graphics/Use.hpp"
 #include "graphics/ViewBox.hpp"
 
 #endif  // GRAPHICS_HPP_
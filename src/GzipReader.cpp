@@ -0,0 +1,455 @@
+#include "GzipReader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+    // Size of the window the matches of deflate may refer to
+    constexpr std::size_t kWindowSize = 1 << 15;
+
+    // Longest match of deflate, the room needed to decode one more code
+    constexpr std::size_t kMaxMatch = 258;
+
+    // Deflate can not compress better than about 1032:1, which bounds the
+    // size hint of a corrupted trailer
+    constexpr std::uint64_t kMaxRatio = 1032;
+
+    // Base lengths and extra bits of the length codes 257..285
+    constexpr std::uint16_t kLengthBase[29] = {
+        3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    constexpr std::uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                               1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                               4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+    // Base distances and extra bits of the distance codes 0..29
+    constexpr std::uint16_t kDistanceBase[30] = {
+        1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+        33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+        1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+    constexpr std::uint8_t kDistanceExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    // Order in which the lengths of the code length code are stored
+    constexpr std::uint8_t kCodeLengthOrder[19] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    // CRC-32 of each byte value, for the reflected polynomial of gzip
+    constexpr std::array< std::uint32_t, 256 > makeCrcTable() {
+        std::array< std::uint32_t, 256 > table{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            table[i] = crc;
+        }
+        return table;
+    }
+    constexpr std::array< std::uint32_t, 256 > kCrcTable = makeCrcTable();
+
+    // Reverses the lowest bits of a code, deflate stores codes from their
+    // most significant bit
+    unsigned int reverse(unsigned int code, int length) {
+        unsigned int reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | (code & 1);
+            code >>= 1;
+        }
+        return reversed;
+    }
+}  // namespace
+
+bool GzipReader::Huffman::build(const unsigned char* lengths, int count) {
+    std::fill(std::begin(counts), std::end(counts), 0);
+    for (int symbol = 0; symbol < count; ++symbol) ++counts[lengths[symbol]];
+    counts[0] = 0;
+
+    int left = 1;
+    for (int length = 1; length < 16; ++length) {
+        left = (left << 1) - counts[length];
+        if (left < 0) return false;
+    }
+
+    // Incomplete codes are allowed, the missing codes fail to decode
+    std::uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int length = 1; length < 15; ++length)
+        offsets[length + 1] = offsets[length] + counts[length];
+    for (int symbol = 0; symbol < count; ++symbol) {
+        if (lengths[symbol] != 0) symbols[offsets[lengths[symbol]]++] = symbol;
+    }
+
+    // The codes are assigned in the order of the sorted symbols
+    std::fill(std::begin(fast), std::end(fast), 0);
+    unsigned int code = 0;
+    int index = 0;
+    for (int length = 1; length <= kFastBits; ++length) {
+        for (int i = 0; i < counts[length]; ++i, ++index, ++code) {
+            std::uint16_t entry = (symbols[index] << 4) | length;
+            for (unsigned int slot = reverse(code, length);
+                 slot < (1u << kFastBits); slot += 1u << length)
+                fast[slot] = entry;
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+GzipReader::GzipReader(const std::string& file_name, std::size_t chunk_size)
+    : file(file_name, std::ios::binary), bytes_read(0), size_hint(0),
+      input(std::max< std::size_t >(chunk_size, 1)), input_position(0),
+      input_end(0), bit_buffer(0), bit_count(0), padding(0),
+      output(kWindowSize + std::max(chunk_size, 4 * kMaxMatch)),
+      output_position(0), output_end(0), checked_end(0), state(State::Header),
+      last_block(false), stored_left(0), crc(0), member_size(0) {
+    if (!file) {
+        state = State::Error;
+        return;
+    }
+
+    // The last 4 bytes hold the size of the last member
+    file.seekg(0, std::ios::end);
+    std::streamoff file_size = file.tellg();
+    if (file_size >= 18) {
+        unsigned char trailer[4];
+        file.seekg(file_size - 4);
+        file.read(reinterpret_cast< char* >(trailer), 4);
+        size_hint = std::uint64_t(trailer[0]) | std::uint64_t(trailer[1]) << 8 |
+                    std::uint64_t(trailer[2]) << 16 |
+                    std::uint64_t(trailer[3]) << 24;
+        size_hint = std::min(size_hint, file_size * kMaxRatio);
+    }
+    file.clear();
+    file.seekg(0);
+}
+
+bool GzipReader::isGzip(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    unsigned char magic[2] = {0, 0};
+    file.read(reinterpret_cast< char* >(magic), 2);
+    return file && magic[0] == 0x1F && magic[1] == 0x8B;
+}
+
+bool GzipReader::good() const { return state != State::Error; }
+
+std::size_t GzipReader::getBytesRead() const { return bytes_read; }
+
+std::uint64_t GzipReader::getSizeHint() const { return size_hint; }
+
+std::size_t GzipReader::read(char* out, std::size_t size) {
+    std::size_t total = 0;
+    while (total < size) {
+        if (output_position == output_end) {
+            if (state == State::Done || state == State::Error) break;
+            // Only the window is kept for the matches of the next bytes
+            if (output_end > kWindowSize) {
+                std::memmove(output.data(),
+                             output.data() + output_end - kWindowSize,
+                             kWindowSize);
+                output_position = output_end = checked_end = kWindowSize;
+            }
+            inflate();
+            checksum();
+            continue;
+        }
+        std::size_t count =
+            std::min(size - total, output_end - output_position);
+        std::memcpy(out + total, output.data() + output_position, count);
+        output_position += count;
+        total += count;
+    }
+    return total;
+}
+
+bool GzipReader::refill() {
+    if (!file) return false;
+    file.read(reinterpret_cast< char* >(input.data()), input.size());
+    input_position = 0;
+    input_end = file.gcount();
+    bytes_read += input_end;
+    return input_end > 0;
+}
+
+void GzipReader::need(int count) {
+    while (bit_count < count) {
+        std::uint64_t byte = 0;
+        if (input_position < input_end || refill())
+            byte = input[input_position++];
+        else
+            padding += 8;
+        bit_buffer |= byte << bit_count;
+        bit_count += 8;
+    }
+}
+
+void GzipReader::consume(int count) {
+    bit_buffer >>= count;
+    bit_count -= count;
+    if (bit_count < padding) state = State::Error;
+}
+
+std::uint32_t GzipReader::bits(int count) {
+    if (count == 0) return 0;
+    need(count);
+    std::uint32_t value = bit_buffer & ((std::uint64_t(1) << count) - 1);
+    consume(count);
+    return value;
+}
+
+int GzipReader::decode(const Huffman& code) {
+    need(15);
+    std::uint16_t entry =
+        code.fast[bit_buffer & ((1u << Huffman::kFastBits) - 1)];
+    if (entry != 0) {
+        consume(entry & 15);
+        return entry >> 4;
+    }
+
+    // Longer codes: the first code of each length follows the codes of the
+    // previous lengths
+    int first = 0, index = 0, value = 0;
+    for (int length = 1; length < 16; ++length) {
+        value |= (bit_buffer >> (length - 1)) & 1;
+        int count = code.counts[length];
+        if (value - first < count) {
+            consume(length);
+            return code.symbols[index + value - first];
+        }
+        index += count;
+        first = (first + count) << 1;
+        value <<= 1;
+    }
+    return -1;
+}
+
+void GzipReader::readHeader() {
+    if (bits(8) != 0x1F || bits(8) != 0x8B || bits(8) != 8) {
+        state = State::Error;
+        return;
+    }
+    std::uint32_t flags = bits(8);
+    bits(32);  // Modification time
+    bits(16);  // Extra flags and operating system
+    if (flags & 0xE0) {
+        state = State::Error;
+        return;
+    }
+    if (flags & 4) {  // Extra field
+        for (std::uint32_t length = bits(16);
+             length > 0 && state != State::Error; --length)
+            bits(8);
+    }
+    if (flags & 8) {  // File name
+        while (bits(8) != 0 && state != State::Error) continue;
+    }
+    if (flags & 16) {  // Comment
+        while (bits(8) != 0 && state != State::Error) continue;
+    }
+    if (flags & 2) bits(16);  // Header CRC
+    if (state == State::Error) return;
+
+    crc = 0;
+    member_size = 0;
+    last_block = false;
+    state = State::Block;
+}
+
+void GzipReader::readBlockHeader() {
+    if (last_block) {
+        state = State::Trailer;
+        return;
+    }
+    last_block = bits(1);
+    std::uint32_t type = bits(2);
+    if (state == State::Error) return;
+    if (type == 0) {
+        // Stored blocks start on a byte boundary
+        consume(bit_count % 8);
+        std::uint32_t length = bits(16);
+        std::uint32_t complement = bits(16);
+        if (state == State::Error || length != (~complement & 0xFFFF)) {
+            state = State::Error;
+            return;
+        }
+        stored_left = length;
+        state = State::Stored;
+    } else if (type == 1) {
+        unsigned char code_lengths[288 + 30];
+        std::fill(code_lengths, code_lengths + 144, 8);
+        std::fill(code_lengths + 144, code_lengths + 256, 9);
+        std::fill(code_lengths + 256, code_lengths + 280, 7);
+        std::fill(code_lengths + 280, code_lengths + 288, 8);
+        std::fill(code_lengths + 288, code_lengths + 318, 5);
+        lengths.build(code_lengths, 288);
+        distances.build(code_lengths + 288, 30);
+        state = State::Codes;
+    } else if (type == 2 && readDynamicCodes()) {
+        state = State::Codes;
+    } else {
+        state = State::Error;
+    }
+}
+
+bool GzipReader::readDynamicCodes() {
+    int length_count = bits(5) + 257;
+    int distance_count = bits(5) + 1;
+    int code_length_count = bits(4) + 4;
+    if (length_count > 286 || distance_count > 30) return false;
+
+    unsigned char code_lengths[288 + 30] = {};
+    for (int i = 0; i < code_length_count; ++i)
+        code_lengths[kCodeLengthOrder[i]] = bits(3);
+    Huffman code_length_code;
+    if (!code_length_code.build(code_lengths, 19)) return false;
+
+    // The lengths of both codes form one sequence, runs may cross from one
+    // code to the other
+    int total = length_count + distance_count;
+    for (int i = 0; i < total && state != State::Error;) {
+        int symbol = decode(code_length_code);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            code_lengths[i++] = symbol;
+            continue;
+        }
+        unsigned char value = 0;
+        int repeat;
+        if (symbol == 16) {
+            if (i == 0) return false;
+            value = code_lengths[i - 1];
+            repeat = 3 + bits(2);
+        } else if (symbol == 17) {
+            repeat = 3 + bits(3);
+        } else {
+            repeat = 11 + bits(7);
+        }
+        if (i + repeat > total) return false;
+        std::fill(code_lengths + i, code_lengths + i + repeat, value);
+        i += repeat;
+    }
+    if (state == State::Error || code_lengths[256] == 0) return false;
+    return lengths.build(code_lengths, length_count) &&
+           distances.build(code_lengths + length_count, distance_count);
+}
+
+void GzipReader::copyStored() {
+    while (stored_left > 0 && output_end < output.size()) {
+        if (bit_count > padding) {
+            // Bytes already loaded into the bit buffer come first
+            output[output_end++] = bits(8);
+            --stored_left;
+            continue;
+        }
+        if (input_position == input_end && !refill()) {
+            state = State::Error;
+            return;
+        }
+        std::size_t count = std::min({stored_left, input_end - input_position,
+                                      output.size() - output_end});
+        std::memcpy(output.data() + output_end, input.data() + input_position,
+                    count);
+        input_position += count;
+        output_end += count;
+        stored_left -= count;
+    }
+    if (stored_left == 0) state = State::Block;
+}
+
+bool GzipReader::decodeCodes() {
+    while (output.size() - output_end >= kMaxMatch) {
+        int symbol = decode(lengths);
+        if (symbol < 0 || state == State::Error) {
+            state = State::Error;
+            return true;
+        }
+        if (symbol < 256) {
+            output[output_end++] = symbol;
+            continue;
+        }
+        if (symbol == 256) {
+            state = State::Block;
+            return true;
+        }
+
+        // The extra bits of the length come before the distance code
+        symbol -= 257;
+        if (symbol >= 29) {
+            state = State::Error;
+            return true;
+        }
+        std::size_t length = kLengthBase[symbol] + bits(kLengthExtra[symbol]);
+        int distance_symbol = decode(distances);
+        if (distance_symbol < 0 || distance_symbol >= 30) {
+            state = State::Error;
+            return true;
+        }
+        std::size_t distance = kDistanceBase[distance_symbol] +
+                               bits(kDistanceExtra[distance_symbol]);
+        if (distance > output_end || state == State::Error) {
+            state = State::Error;
+            return true;
+        }
+        // The match may overlap the bytes it produces
+        unsigned char* to = output.data() + output_end;
+        const unsigned char* from = to - distance;
+        for (std::size_t i = 0; i < length; ++i) to[i] = from[i];
+        output_end += length;
+    }
+    return false;
+}
+
+void GzipReader::readTrailer() {
+    consume(bit_count % 8);
+    checksum();
+    std::uint32_t stored_crc = bits(32);
+    std::uint32_t stored_size = bits(32);
+    if (state == State::Error || stored_crc != crc ||
+        stored_size != member_size) {
+        state = State::Error;
+        return;
+    }
+
+    // Another member may follow, anything else after a member is ignored
+    state = State::Done;
+    if (bit_count == 0 && input_position == input_end && !refill()) return;
+    need(8);
+    if (bit_count > padding && (bit_buffer & 0xFF) == 0x1F)
+        state = State::Header;
+}
+
+void GzipReader::inflate() {
+    while (true) {
+        switch (state) {
+            case State::Header:
+                readHeader();
+                break;
+            case State::Block:
+                readBlockHeader();
+                break;
+            case State::Stored:
+                copyStored();
+                if (state == State::Stored) return;
+                break;
+            case State::Codes:
+                if (!decodeCodes()) return;
+                break;
+            case State::Trailer:
+                readTrailer();
+                break;
+            case State::Done:
+            case State::Error:
+                return;
+        }
+    }
+}
+
+void GzipReader::checksum() {
+    std::uint32_t value = ~crc;
+    for (std::size_t i = checked_end; i < output_end; ++i)
+        value = kCrcTable[(value ^ output[i]) & 0xFF] ^ (value >> 8);
+    crc = ~value;
+    member_size += static_cast< std::uint32_t >(output_end - checked_end);
+    checked_end = output_end;
+}
@@ -0,0 +1,225 @@
+#ifndef GZIP_READER_HPP_
+#define GZIP_READER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streaming decompressor of gzip files, such as .svgz files.
+ *
+ * The GzipReader reads the compressed file in fixed-size chunks and inflates
+ * it on demand, so only one chunk of input, the 32 KiB window of the
+ * matches and one chunk of output are held in memory, whatever the size of
+ * the file. Files holding several gzip members are read as one stream. The
+ * CRC-32 and the size stored in the trailer of each member are checked.
+ */
+class GzipReader {
+public:
+    /**
+     * @brief Opens a gzip file for reading.
+     *
+     * @param file_name The name of the file to be read.
+     * @param chunk_size The number of bytes read from the file at once.
+     */
+    GzipReader(const std::string& file_name, std::size_t chunk_size = 1 << 16);
+
+    /**
+     * @brief Deleted copy constructor, the reader owns the file.
+     */
+    GzipReader(const GzipReader&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator, the reader owns the file.
+     */
+    void operator=(const GzipReader&) = delete;
+
+    /**
+     * @brief Checks whether a file starts with the gzip magic number.
+     *
+     * @param file_name The name of the file to be checked.
+     * @return True if the file is gzip-compressed.
+     */
+    static bool isGzip(const std::string& file_name);
+
+    /**
+     * @brief Reads the next decompressed bytes.
+     *
+     * @param out The buffer receiving the bytes.
+     * @param size The number of bytes wanted.
+     * @return The number of bytes read, less than the size only at the end
+     * of the data or on an error.
+     */
+    std::size_t read(char* out, std::size_t size);
+
+    /**
+     * @brief Checks whether the data read so far is valid.
+     *
+     * @return False if the file could not be opened, or if the compressed
+     * data, its checksum or its size is corrupted.
+     */
+    bool good() const;
+
+    /**
+     * @brief Gets the number of compressed bytes read from the file so far.
+     *
+     * @return The number of compressed bytes read.
+     */
+    std::size_t getBytesRead() const;
+
+    /**
+     * @brief Gets the decompressed size stored in the trailer of the file.
+     *
+     * @return The decompressed size of the last member, modulo 4 GiB, or 0 if
+     * the file is too short to hold a trailer.
+     * @note The size is only a hint for allocating the output: it is wrong
+     * for files of several members or of more than 4 GiB.
+     */
+    std::uint64_t getSizeHint() const;
+
+private:
+    /**
+     * @brief The decoding steps of a gzip stream.
+     */
+    enum class State {
+        Header,   ///< Reading the header of a member
+        Block,    ///< Reading the header of a deflate block
+        Stored,   ///< Copying an uncompressed block
+        Codes,    ///< Decoding a block of Huffman codes
+        Trailer,  ///< Reading the checksum and size of a member
+        Done,     ///< End of the data
+        Error,    ///< Corrupted or truncated data
+    };
+
+    /**
+     * @brief A canonical Huffman code of deflate.
+     *
+     * Codes of up to kFastBits bits are decoded with one lookup; longer codes
+     * are decoded bit by bit from the counts and the sorted symbols.
+     */
+    struct Huffman {
+        static constexpr int kFastBits = 10;  ///< Bits of the lookup table
+
+        std::uint16_t fast[1 << kFastBits];  ///< Symbol << 4 | length, or 0
+        std::uint16_t counts[16];            ///< Number of codes per length
+        std::uint16_t symbols[288];          ///< Symbols sorted by code
+
+        /**
+         * @brief Builds the code from the code lengths of the symbols.
+         *
+         * @param lengths The code length of every symbol, 0 if unused.
+         * @param count The number of symbols.
+         * @return False if the lengths are over-subscribed.
+         */
+        bool build(const unsigned char* lengths, int count);
+    };
+
+    /**
+     * @brief Reads the next chunk of the file into the input buffer.
+     *
+     * @return False at the end of the file.
+     */
+    bool refill();
+
+    /**
+     * @brief Ensures that the bit buffer holds at least a number of bits.
+     *
+     * @param count The number of bits needed, at most 32. Past the end of the
+     * file the bit buffer is padded with zeros.
+     */
+    void need(int count);
+
+    /**
+     * @brief Drops bits from the bit buffer.
+     *
+     * @param count The number of bits to be dropped. Dropping padding bits
+     * means that the data is truncated.
+     */
+    void consume(int count);
+
+    /**
+     * @brief Reads bits from the stream, least significant bit first.
+     *
+     * @param count The number of bits to be read, at most 32.
+     * @return The bits read.
+     */
+    std::uint32_t bits(int count);
+
+    /**
+     * @brief Decodes one symbol of a Huffman code.
+     *
+     * @param code The code to be decoded.
+     * @return The symbol, or -1 if the bits match no code.
+     */
+    int decode(const Huffman& code);
+
+    /**
+     * @brief Reads the header of a gzip member.
+     */
+    void readHeader();
+
+    /**
+     * @brief Reads the header of a deflate block and its Huffman codes.
+     */
+    void readBlockHeader();
+
+    /**
+     * @brief Reads the code lengths of a block with dynamic Huffman codes.
+     *
+     * @return False if the code lengths are invalid.
+     */
+    bool readDynamicCodes();
+
+    /**
+     * @brief Copies the bytes of a stored block to the output.
+     */
+    void copyStored();
+
+    /**
+     * @brief Decodes the codes of a block to the output.
+     *
+     * @return False when the output is full before the end of the block.
+     */
+    bool decodeCodes();
+
+    /**
+     * @brief Reads and checks the trailer of a gzip member.
+     */
+    void readTrailer();
+
+    /**
+     * @brief Decodes until the output is full or the data ends.
+     */
+    void inflate();
+
+    /**
+     * @brief Updates the checksum and size of the member with the output
+     * decoded since the last update.
+     */
+    void checksum();
+
+    std::ifstream file;                     ///< File being read
+    std::size_t bytes_read;                 ///< Compressed bytes read
+    std::uint64_t size_hint;                ///< Size stored in the trailer
+    std::vector< unsigned char > input;     ///< Chunk of compressed bytes
+    std::size_t input_position;             ///< Next byte of the chunk
+    std::size_t input_end;                  ///< End of the chunk
+    std::uint64_t bit_buffer;               ///< Bits not consumed yet
+    int bit_count;                          ///< Number of bits in the buffer
+    int padding;                            ///< Zero bits past the file end
+    std::vector< unsigned char > output;    ///< Window and decoded bytes
+    std::size_t output_position;            ///< Next byte to be returned
+    std::size_t output_end;                 ///< End of the decoded bytes
+    std::size_t checked_end;                ///< End of the checksummed bytes
+    State state;                            ///< Current decoding step
+    bool last_block;                        ///< Whether the block is final
+    std::size_t stored_left;                ///< Bytes left in a stored block
+    std::uint32_t crc;                      ///< CRC-32 of the member
+    std::uint32_t member_size;              ///< Size of the member mod 4 GiB
+    Huffman lengths;                        ///< Literal/length code
+    Huffman distances;                      ///< Distance code
+};
+
+#endif  // GZIP_READER_HPP_
@@ -0,0 +1,126 @@
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "GzipReader.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& file_name, bool allow_mapping)
+    : view(nullptr), length(0), compressed_length(0) {
+    if (GzipReader::isGzip(file_name))
+        inflate(file_name);
+    else if (!allow_mapping || !map(file_name))
+        read(file_name);
+}
+
+MappedFile::~MappedFile() {
+    if (view == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap(view, length);
+#endif
+}
+
+char* MappedFile::data() { return view != nullptr ? view : buffer.data(); }
+
+std::size_t MappedFile::size() const { return length; }
+
+bool MappedFile::isMapped() const { return view != nullptr; }
+
+std::size_t MappedFile::compressedSize() const { return compressed_length; }
+
+// The bytes between the end of the file and the end of its last page are
+// zero-filled by the system, which gives the NUL terminator for free. Files
+// ending exactly on a page boundary have no such byte and are read instead.
+bool MappedFile::map(const std::string& file_name) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 ||
+        file_size.QuadPart % system_info.dwPageSize == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Copy-on-write pages: the parser may write to them, the file is kept
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return false;
+    void* address = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (address == NULL) return false;
+
+    view = static_cast< char* >(address);
+    length = static_cast< std::size_t >(file_size.QuadPart);
+    return true;
+#else
+    int file = open(file_name.c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (fstat(file, &status) != 0 || status.st_size == 0 ||
+        status.st_size % page_size == 0) {
+        close(file);
+        return false;
+    }
+
+    // Private pages: the parser may write to them, the file is kept
+    void* address = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, file, 0);
+    close(file);
+    if (address == MAP_FAILED) return false;
+
+    view = static_cast< char* >(address);
+    length = static_cast< std::size_t >(status.st_size);
+    return true;
+#endif
+}
+
+void MappedFile::read(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+    std::streamoff file_size = 0;
+    if (file) file_size = std::max< std::streamoff >(file.tellg(), 0);
+
+    // One allocation of the final size, the extra byte is the NUL terminator
+    buffer.assign(static_cast< std::size_t >(file_size) + 1, '\0');
+    file.seekg(0);
+    file.read(buffer.data(), file_size);
+    length = file ? static_cast< std::size_t >(file_size)
+                  : static_cast< std::size_t >(file.gcount());
+    buffer[length] = '\0';
+}
+
+void MappedFile::inflate(const std::string& file_name) {
+    GzipReader reader(file_name);
+
+    // The trailer gives the size, the buffer only grows when it is wrong, for
+    // files of several members or of more than 4 GiB
+    buffer.assign(static_cast< std::size_t >(reader.getSizeHint()) + 1, '\0');
+    while (true) {
+        length += reader.read(buffer.data() + length, buffer.size() - length);
+        if (length < buffer.size()) break;
+        buffer.resize(buffer.size() * 2);
+    }
+    buffer[length] = '\0';
+    compressed_length = reader.getBytesRead();
+    if (!reader.good())
+        std::cerr << "Error: corrupted compressed file " << file_name
+                  << std::endl;
+}
@@ -0,0 +1,104 @@
+#ifndef MAPPED_FILE_HPP_
+#define MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A writable, NUL-terminated view of a whole file.
+ *
+ * The MappedFile maps the file copy-on-write, so the in-situ parser of
+ * rapidxml can modify the buffer without touching the file and without
+ * copying it first. When the file cannot be mapped (or its size is a multiple
+ * of the page size, so there is no room left for the terminating NUL), the
+ * file is read with a single call into a buffer allocated once with the exact
+ * size. Gzip-compressed files (.svgz) are inflated chunk by chunk into a
+ * buffer sized from the gzip trailer, so it is also allocated once.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Opens a file and loads it into memory.
+     *
+     * @param file_name The name of the file to be loaded.
+     * @param allow_mapping Whether the file may be memory-mapped. If false,
+     * the file is always read into a buffer.
+     */
+    MappedFile(const std::string& file_name, bool allow_mapping = true);
+
+    /**
+     * @brief Deleted copy constructor, the mapping has a single owner.
+     */
+    MappedFile(const MappedFile&) = delete;
+
+    /**
+     * @brief Deleted copy assignment operator, the mapping has a single owner.
+     */
+    void operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Unmaps the file or releases the buffer.
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Gets the content of the file.
+     *
+     * @return The NUL-terminated content of the file. The content may be
+     * modified in place.
+     */
+    char* data();
+
+    /**
+     * @brief Gets the size of the file.
+     *
+     * @return The size of the file in bytes, without the terminating NUL.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether the file is memory-mapped.
+     *
+     * @return True if the file is mapped, false if it was read into a buffer.
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief Gets the size of the file before decompression.
+     *
+     * @return The size of the gzip-compressed file in bytes, or 0 if the file
+     * is not compressed.
+     */
+    std::size_t compressedSize() const;
+
+private:
+    /**
+     * @brief Maps the file copy-on-write.
+     *
+     * @param file_name The name of the file to be mapped.
+     * @return True if the file was mapped.
+     */
+    bool map(const std::string& file_name);
+
+    /**
+     * @brief Reads the file into a buffer of the exact size.
+     *
+     * @param file_name The name of the file to be read.
+     */
+    void read(const std::string& file_name);
+
+    /**
+     * @brief Decompresses a gzip file into a buffer.
+     *
+     * @param file_name The name of the file to be decompressed.
+     */
+    void inflate(const std::string& file_name);
+
+    char* view;                     ///< Start of the mapping, if mapped
+    std::size_t length;             ///< Size of the content in bytes
+    std::size_t compressed_length;  ///< Size of the file, if compressed
+    std::vector< char > buffer;     ///< Content of the file, if not mapped
+};
+
+#endif  // MAPPED_FILE_HPP_
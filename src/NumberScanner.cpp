@@ -0,0 +1,90 @@
+#include "NumberScanner.hpp"
+
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+
+namespace {
+    // Whitespace characters allowed between numbers
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    // Check whether a number out of the range of float is too large rather
+    // than too small: its first significant digit is left of the point once
+    // the exponent is applied
+    bool isOverflow(const char* first, const char* last) {
+        long magnitude = 0;  // Position of the first significant digit
+        bool point = false, significant = false;
+        for (; first != last && *first != 'e' && *first != 'E'; ++first) {
+            if (*first == '.') {
+                point = true;
+            } else if (isDigit(*first) && !significant) {
+                if (*first != '0')
+                    significant = true;
+                else if (point)
+                    --magnitude;
+            }
+            if (significant && !point && isDigit(*first)) ++magnitude;
+        }
+        if (!significant) return false;
+        long exponent = 0;
+        bool negative = false;
+        if (first != last) ++first;
+        if (first != last && (*first == '-' || *first == '+'))
+            negative = *first++ == '-';
+        for (; first != last && exponent < 100000; ++first)
+            exponent = exponent * 10 + (*first - '0');
+        return magnitude + (negative ? -exponent : exponent) > 0;
+    }
+}  // namespace
+
+NumberScanner::NumberScanner(const char* begin, const char* end)
+    : cursor(begin), end(end) {}
+
+NumberScanner::NumberScanner(std::string_view text)
+    : cursor(text.data()), end(text.data() + text.size()) {}
+
+bool NumberScanner::scan(const char*& cursor, const char* end, float& value) {
+    const char* first = cursor;
+    // std::from_chars does not accept an explicit plus sign, and reads
+    // "inf" and "nan" after a minus sign
+    if (first != end && *first == '+') ++first;
+    const char* digits = first;
+    if (digits != end && *digits == '-' && first == cursor) ++digits;
+    if (digits == end || (*digits != '.' && !isDigit(*digits))) return false;
+    std::from_chars_result result = std::from_chars(first, end, value);
+    if (result.ec == std::errc::invalid_argument) return false;
+    if (result.ec == std::errc::result_out_of_range) {
+        float sign = *first == '-' ? -1.f : 1.f;
+        value = isOverflow(digits, result.ptr) ? sign * FLT_MAX : sign * 0.f;
+    }
+    if (!std::isfinite(value)) return false;
+    cursor = result.ptr;
+    return true;
+}
+
+float NumberScanner::parse(std::string_view text, float fallback) {
+    NumberScanner scanner(text);
+    float value;
+    return scanner.next(value) ? value : fallback;
+}
+
+void NumberScanner::skipSeparators() {
+    while (cursor != end && isWhitespace(*cursor)) ++cursor;
+    if (cursor != end && *cursor == ',') {
+        ++cursor;
+        while (cursor != end && isWhitespace(*cursor)) ++cursor;
+    }
+}
+
+bool NumberScanner::next(float& value) {
+    skipSeparators();
+    return scan(cursor, end, value);
+}
+
+std::string_view NumberScanner::rest() const {
+    return std::string_view(cursor, end - cursor);
+}
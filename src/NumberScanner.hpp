@@ -0,0 +1,87 @@
+#ifndef NUMBER_SCANNER_HPP_
+#define NUMBER_SCANNER_HPP_
+
+#include <string_view>
+
+/**
+ * @brief Locale-independent reader of the numbers of an attribute value.
+ *
+ * The NumberScanner reads numbers straight from a character buffer with
+ * std::from_chars, so it neither allocates nor depends on the C locale. It is
+ * used for every number of the parser and the renderer: single values
+ * ("1.5", "50%"), lists ("1,2 3 4", "1-2"), color functions
+ * ("rgb(1, 2, 3)") and transform arguments ("translate(1 2)").
+ */
+class NumberScanner {
+public:
+    /**
+     * @brief Constructs a scanner over a character buffer.
+     *
+     * @param begin The first character to be read.
+     * @param end One past the last character to be read.
+     */
+    NumberScanner(const char* begin, const char* end);
+
+    /**
+     * @brief Constructs a scanner over a string.
+     *
+     * @param text The characters to be read.
+     */
+    explicit NumberScanner(std::string_view text);
+
+    /**
+     * @brief Reads the next number, skipping the whitespaces and the comma
+     * before it.
+     *
+     * @param value The number that was read.
+     * @return True if a number was read, false at the end of the buffer or if
+     * the next character does not start a number.
+     */
+    bool next(float& value);
+
+    /**
+     * @brief Skips whitespaces and at most one comma.
+     */
+    void skipSeparators();
+
+    /**
+     * @brief Gets the characters that are not read yet.
+     *
+     * @return The rest of the buffer.
+     */
+    std::string_view rest() const;
+
+    /**
+     * @brief Reads a number at a position of a buffer.
+     *
+     * @param cursor The position of the number, moved past it when a number
+     * is read.
+     * @param end The end of the buffer.
+     * @param value The number that was read.
+     * @return True if a number was read.
+     *
+     * @note An explicit plus sign is accepted, and one sign must be followed
+     * by a digit or a point: infinities and NaN are not numbers. Numbers too
+     * large for a float are clamped to FLT_MAX, with their sign, and numbers
+     * too small are read as 0.
+     */
+    static bool scan(const char*& cursor, const char* end, float& value);
+
+    /**
+     * @brief Reads the leading number of a value, like std::stof but without
+     * allocating or throwing.
+     *
+     * @param text The value, which may start with whitespaces and end with a
+     * unit.
+     * @param fallback The number returned if the value does not start with a
+     * number.
+     * @return The leading number of the value.
+     */
+    static float parse(std::string_view text, float fallback = 0);
+
+private:
+    const char* cursor;  ///< Current position in the buffer
+    const char* end;     ///< End of the buffer
+};
+
+#endif  // NUMBER_SCANNER_HPP_
@@ -1,60 +1,76 @@
 #include "Parser.hpp"
 
-Parser *Parser::instance = nullptr;
-
 namespace {
-    // Lambda function to convert a hex color string to ColorShape
-    auto getHexColor = [](std::string color) -> ColorShape {
-        std::stringstream ss;
-        int pos = color.find("#");
-        if (color.size() < 5 || color[pos + 4] == ' ') {
-            // Parse 3-digit hex color format
-            ss << std::hex << color.substr(pos + 1, 1) << " "
-               << color.substr(pos + 2, 1) << " " << color.substr(pos + 3, 1);
-            int r, g, b;
-            ss >> r >> g >> b;
-            r = r * 16 + r;
-            g = g * 16 + g;
-            b = b * 16 + b;
-            return ColorShape(r, g, b, 255);
-        } else if (color.size() < 6 || color[pos + 5] == ' ') {
-            // Parse 4-digit hex color format (with alpha channel)
-            ss << std::hex << color.substr(pos + 1, 1) << " "
-               << color.substr(pos + 2, 1) << " " << color.substr(pos + 3, 1)
-               << color.substr(pos + 4, 1);
-            int r, g, b, a;
-            ss >> r >> g >> b >> a;
-            r = r * 16 + r;
-            g = g * 16 + g;
-            b = b * 16 + b;
-            a = a * 16 + a;
-            return ColorShape(r, g, b, a);
-        } else {
-            // Parse 6-digit hex color format (with optional alpha channel)
-            ss << std::hex << color.substr(pos + 1, 2) << " "
-               << color.substr(pos + 3, 2) << " " << color.substr(pos + 5, 2);
-            int r, g, b;
-            ss >> r >> g >> b;
-            if (color[pos + 7] != '\0' && color[pos + 7] != ' ') {
-                // Parse alpha channel if present
-                std::stringstream ss;
-                ss << std::hex << color.substr(pos + 7, 2);
-                int a;
-                ss >> a;
-                return ColorShape(r, g, b, a);
+    // The tags drawn as a single shape, with the kind of their element
+    constexpr std::pair< std::string_view, ElementKind > kShapeTags[] = {
+        {"path", ElementKind::Path},         {"rect", ElementKind::Rect},
+        {"circle", ElementKind::Circle},     {"line", ElementKind::Line},
+        {"polygon", ElementKind::Polygon},   {"text", ElementKind::Text},
+        {"polyline", ElementKind::Polyline}, {"ellipse", ElementKind::Ellipse},
+        {"use", ElementKind::Use},
+    };
+
+    // Get the kind of the shape drawn by a tag, returns false if the tag is
+    // not a shape
+    bool getShapeKind(std::string_view name, ElementKind &kind) {
+        for (const auto &tag : kShapeTags) {
+            if (tag.first == name) {
+                kind = tag.second;
+                return true;
             }
-            return ColorShape(r, g, b, 255);
         }
-    };
+        return false;
+    }
 
-    // Lambda function to convert an RGB color string to ColorShape
-    auto getRgbColor = [](std::string color) -> ColorShape {
-        int r, g, b;
-        float a = 1;
-        sscanf(color.c_str(), "rgb(%d,%d,%d,%f)", &r, &g, &b, &a);
-        return ColorShape(r, g, b, 255 * a);
+    // The keywords of the enumerated attributes, the default first
+    constexpr std::pair< std::string_view, FillRule > kFillRules[] = {
+        {"nonzero", FillRule::NonZero},
+        {"evenodd", FillRule::EvenOdd},
+    };
+    constexpr std::pair< std::string_view, TextAnchor > kTextAnchors[] = {
+        {"start", TextAnchor::Start},
+        {"middle", TextAnchor::Middle},
+        {"end", TextAnchor::End},
+    };
+    constexpr std::pair< std::string_view, FontStyle > kFontStyles[] = {
+        {"normal", FontStyle::Normal},
+        {"italic", FontStyle::Italic},
+        {"oblique", FontStyle::Oblique},
+    };
+    constexpr std::pair< std::string_view, GradientUnits > kGradientUnits[] = {
+        {"objectBoundingBox", GradientUnits::ObjectBoundingBox},
+        {"userSpaceOnUse", GradientUnits::UserSpaceOnUse},
     };
 
+    // Get the value of a keyword, ignoring spaces, returns the default if the
+    // keyword is unknown
+    template< typename Enum, std::size_t N >
+    Enum getKeyword(std::string keyword,
+                    const std::pair< std::string_view, Enum > (&keywords)[N]) {
+        keyword.erase(std::remove(keyword.begin(), keyword.end(), ' '),
+                      keyword.end());
+        for (const auto &entry : keywords) {
+            if (entry.first == keyword) return entry.second;
+        }
+        return keywords[0].second;
+    }
+
+    // Remove the spaces around a color value
+    std::string_view trimColor(std::string_view color) {
+        while (!color.empty() && isspace(color.front())) color.remove_prefix(1);
+        while (!color.empty() && isspace(color.back())) color.remove_suffix(1);
+        return color;
+    }
+
+    // Check whether a color value is the currentColor keyword, in any case
+    bool isCurrentColor(std::string_view color) {
+        constexpr std::string_view keyword = "currentcolor";
+        return std::equal(color.begin(), color.end(), keyword.begin(),
+                          keyword.end(), [](char a, char b) {
+                              return std::tolower((unsigned char)a) == b;
+                          });
+    }
+
     // Remove extra spaces, tabs, and newlines from a string
     std::string removeExtraSpaces(std::string input) {
         input.erase(std::remove(input.begin(), input.end(), '\t'), input.end());
@@ -84,372 +100,555 @@ namespace {
 
         return result;
     }
+}  // namespace
 
-    // Remove redundant consecutive spaces from a string
-    void removeRedundantSpaces(std::string &path_string) {
-        int index = 0;
-        while (index < path_string.size()) {
-            if ((index == 0 || index == path_string.size() - 1) &&
-                path_string[index] == ' ') {
-                path_string.erase(index, 1);
-            } else if (path_string[index] == ' ' &&
-                       path_string[index - 1] == ' ') {
-                path_string.erase(index, 1);
-            } else {
-                index++;
+// Constructor for the Parser class
+Parser::Parser(const std::string &file_name, LoadMode mode,
+               unsigned int threads, const std::string &cache_file)
+    : load_mode(mode), thread_count(threads), cache_file(cache_file) {
+    // 0 asks for one thread per core
+    if (thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    root = parseElements(file_name);
+    load_stats.arena_bytes = arena.getBytesUsed();
+
+    // The store is a linear copy of the finished tree
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    store.build(getRoot());
+    load_stats.store_time =
+        std::chrono::duration< double, std::milli >(Clock::now() - start)
+            .count();
+    load_stats.store_bytes = store.getBytesUsed();
+
+    // The hierarchy indexes the world bounds of the store
+    start = Clock::now();
+    bvh.build(store);
+    load_stats.bvh_time =
+        std::chrono::duration< double, std::milli >(Clock::now() - start)
+            .count();
+    load_stats.bvh_bytes = bvh.getBytesUsed();
+}
+
+// Get the root element of the SVG document
+Group *Parser::getRoot() { return dynamic_cast< Group * >(root); }
+
+// Get the flattened tree
+const SceneStore &Parser::getStore() const { return store; }
+
+// Get the hierarchy of the bounds of the store
+const SceneBVH &Parser::getSceneBVH() const { return bvh; }
+
+// Build the children of a node into a group, walking the subtree depth first
+void Parser::parseChildren(Group *group, rapidxml::xml_node<> *container,
+                           bool parse_defs) {
+    Group *current = group;
+    rapidxml::xml_node<> *node = container->first_node();
+    while (node != NULL) {
+        std::string_view name(node->name(), node->name_size());
+        if (name == "defs") {
+            // Parse gradients
+            if (parse_defs) GetGradients(node);
+        } else if (name == "symbol") {
+            // Symbols are only drawn by the <use> elements
+            if (parse_defs) registerSymbol(node);
+        } else if (name == "g") {
+            Group *new_group = parseGroup(current, node);
+            // An empty group is a leaf, go on with its siblings
+            if (node->first_node()) {
+                current = new_group;
+                node = node->first_node();
+                continue;
             }
+        } else {
+            // Parse Shape attributes and add to current group
+            SVGElement *shape = parseShape(node, current->getStyle());
+            if (shape != NULL) current->addElement(shape);
         }
-    }
 
-    // Insert space before each letter in a string, except 'e'
-    void insertSpaceBeforeEachLetter(std::string &path_string) {
-        std::string result;
-        for (int index = 0; index < path_string.size(); index++) {
-            if (std::isalpha(path_string[index]) &&
-                tolower(path_string[index]) != 'e') {
-                result += " ";
-                result += path_string[index];
-                result += " ";
-            } else if (path_string[index] == '-' && index - 1 >= 0 &&
-                       tolower(path_string[index - 1]) != 'e') {
-                result += " ";
-                result += path_string[index];
-            } else if (path_string[index] == '.') {
-                if (index > 0 && path_string[index - 1] == '-')
-                    result += "0";
-                else if (index > 0 && isalpha(path_string[index - 1]))
-                    result += " 0";
-                result += path_string[index];
-            } else {
-                result += path_string[index];
-            }
+        // Go on with the next sibling of the node, or of its closest ancestor
+        // that has one, without leaving the container
+        while (node->next_sibling() == NULL && node->parent() != container) {
+            node = node->parent();
+            current = dynamic_cast< Group * >(current->getParent());
         }
-        path_string = result;
-    }
-
-    // Format SVG path string by removing extra spaces and handling
-    // abbreviations
-    void formatSvgPathString(std::string &path_string) {
-        std::replace(path_string.begin(), path_string.end(), '\t', ' ');
-        std::replace(path_string.begin(), path_string.end(), '\n', ' ');
-        insertSpaceBeforeEachLetter(path_string);
-        std::replace(path_string.begin(), path_string.end(), ',', ' ');
-        removeRedundantSpaces(path_string);
-
-        // Check for and handle abbreviations in the SVG path string
-        auto checkAbbreviation = [](const std::string &s) {
-            int cnt = 0;
-            for (auto c : s)
-                if (c == '.') ++cnt;
-            if (cnt == 2) return true;
-            return false;
-        };
-
-        std::stringstream ss(path_string);
-        std::string element;
-        std::string result;
-        while (ss >> element) {
-            std::string point_x = "";
-            std::string point_y = "";
-            if (checkAbbreviation(element)) {
-                for (int i = (int)element.size() - 1; i >= 0; --i) {
-                    if (element[i] == '.') {
-                        point_y = "0." + element.substr(i + 1);
-                        point_x = element.substr(0, i);
-                        break;
-                    }
-                }
-                result += point_x + ' ' + point_y + ' ';
-            } else
-                result += element + ' ';
+        node = node->next_sibling();
+    }
+}
+
+// Read every <defs> and <symbol> first, then build the top-level groups on a
+// pool of threads. The groups are added to the root in document order before
+// they are filled, so the workers only touch their own subtree and read the
+// gradients.
+void Parser::parseChildrenConcurrently(Group *root, rapidxml::xml_node<> *svg) {
+    rapidxml::xml_node<> *node = svg->first_node();
+    while (node != NULL) {
+        std::string_view name(node->name(), node->name_size());
+        if (name == "defs") {
+            GetGradients(node);
+        } else if (name == "symbol") {
+            registerSymbol(node);
+        } else if (name == "g" && node->first_node()) {
+            node = node->first_node();
+            continue;
         }
-        path_string = result;
+        while (node->next_sibling() == NULL && node->parent() != svg)
+            node = node->parent();
+        node = node->next_sibling();
     }
-}  // namespace
 
-// Singleton design pattern: Parser class instance creation
-Parser *Parser::getInstance(const std::string &file_name) {
-    if (instance == nullptr) {
-        instance = new Parser(file_name);
+    std::vector< std::pair< Group *, rapidxml::xml_node<> * > > jobs;
+    for (node = svg->first_node(); node; node = node->next_sibling()) {
+        std::string_view name(node->name(), node->name_size());
+        if (name == "defs") continue;
+        if (name == "g") {
+            Group *group = parseGroup(root, node);
+            if (node->first_node()) jobs.push_back({group, node});
+        } else {
+            SVGElement *shape = parseShape(node, root->getStyle());
+            if (shape != NULL) root->addElement(shape);
+        }
     }
-    return instance;
+
+    // The subtrees vary a lot in size, so the idle workers take the next
+    // one from a shared cursor rather than a fixed share of them
+    std::atomic< std::size_t > next_job{0};
+    auto work = [&] {
+        for (std::size_t job = next_job++; job < jobs.size();
+             job = next_job++)
+            parseChildren(jobs[job].first, jobs[job].second, false);
+    };
+    std::vector< std::thread > workers;
+    unsigned int worker_count =
+        std::min< std::size_t >(thread_count, jobs.size());
+    for (unsigned int i = 1; i < worker_count; ++i) workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers) worker.join();
 }
 
-// Constructor for the Parser class
-Parser::Parser(const std::string &file_name) {
-    root = parseElements(file_name);
+// Create a group from a <g> node and add it to its parent group
+Group *Parser::parseGroup(Group *parent, rapidxml::xml_node<> *node) {
+    AttributeTable attributes(node, &style_sheet);
+    Group *group = arena.create< Group >(arena.getAllocator());
+    // The group pushes its own style record only if it sets an attribute
+    group->setStyle(
+        ComputedStyle::derive(parent->getStyle(), attributes, arena));
+    group->setTransform(parseTransform(attributes));
+    parent->addElement(group);
+    return group;
 }
 
-// Get the root element of the SVG document
-Group *Parser::getRoot() { return dynamic_cast< Group * >(root); }
+// Read the <style> elements of a subtree, in document order, before any
+// element is styled
+void Parser::parseStyleSheets(rapidxml::xml_node<> *node) {
+    rapidxml::xml_node<> *container = node;
+    node = node->first_node();
+    while (node != NULL) {
+        if (node->type() == rapidxml::node_element) {
+            std::string_view name(node->name(), node->name_size());
+            if (name == "style") {
+                parseStyleSheet(node);
+            } else if (node->first_node()) {
+                node = node->first_node();
+                continue;
+            }
+        }
+        while (node->next_sibling() == NULL && node->parent() != container)
+            node = node->parent();
+        node = node->next_sibling();
+    }
+}
 
-// Convert XML attribute to string representation
-Attributes xmlToString(rapidxml::xml_attribute<> *attribute) {
-    Attributes attributes;
-    while (attribute) {
-        attributes.push_back(
-            std::make_pair(attribute->name(), attribute->value()));
-        attribute = attribute->next_attribute();
+// Read the rules of a <style> node, whose text may be split in several runs
+// of characters and CDATA sections
+void Parser::parseStyleSheet(rapidxml::xml_node<> *node) {
+    std::string text;
+    for (rapidxml::xml_node<> *child = node->first_node(); child;
+         child = child->next_sibling()) {
+        if (child->type() == rapidxml::node_data ||
+            child->type() == rapidxml::node_cdata)
+            text.append(child->value(), child->value_size());
+    }
+    style_sheet.parse(text);
+}
+
+// Read the viewport and the viewbox from the <svg> node
+void Parser::parseViewPort(rapidxml::xml_node<> *svg) {
+    AttributeTable attributes(svg);
+    viewport.x = getFloatAttribute(attributes, AttributeId::Width);
+    viewport.y = getFloatAttribute(attributes, AttributeId::Height);
+    if (attributes.has(AttributeId::ViewBox)) {
+        NumberScanner scanner(attributes.get(AttributeId::ViewBox));
+        float x = 0, y = 0, w = 0, h = 0;
+        scanner.next(x) && scanner.next(y) && scanner.next(w) &&
+            scanner.next(h);
+        this->viewbox = ViewBox(x, y, w, h);
     }
-    return attributes;
 }
 
 // Parse SVG elements from the XML document
 SVGElement *Parser::parseElements(std::string file_name) {
-    rapidxml::xml_document<> doc;
-    std::ifstream file(file_name);
-    std::vector< char > buffer((std::istreambuf_iterator< char >(file)),
-                               std::istreambuf_iterator< char >());
-    buffer.push_back('\0');
-    doc.parse< 0 >(&buffer[0]);
-
-    rapidxml::xml_node<> *svg = doc.first_node();
-    viewport.x = getFloatAttribute(svg, "width");
-    viewport.y = getFloatAttribute(svg, "height");
-    std::string viewbox = getAttribute(svg, "viewBox");
-    if (viewbox != "") {
-        std::stringstream ss(viewbox);
-        float x, y, w, h;
-        ss >> x >> y >> w >> h;
-        this->viewbox = ViewBox(x, y, w, h);
+    if (load_mode == LoadMode::Streaming) return streamElements(file_name);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    // The mapping is parsed in place and only lives until the tree is built
+    MappedFile file(file_name, load_mode == LoadMode::Mapped);
+    load_stats.bytes = file.size();
+    load_stats.compressed_bytes = file.compressedSize();
+    load_stats.mapped = file.isMapped();
+    Clock::time_point loaded = Clock::now();
+    load_stats.load_time =
+        std::chrono::duration< double, std::milli >(loaded - start).count();
+
+    // A cache of the same content skips the XML parsing entirely
+    std::uint64_t source_hash = 0;
+    if (!cache_file.empty()) {
+        source_hash = SceneCache::hash(file.data(), file.size());
+        Group *cached = SceneCache::read(cache_file, source_hash, file.size(),
+                                         arena, gradients, viewbox, viewport);
+        if (cached != NULL) {
+            load_stats.cache_hit = true;
+            load_stats.parse_time = std::chrono::duration< double, std::milli >(
+                                        Clock::now() - loaded)
+                                        .count();
+            return cached;
+        }
     }
-    rapidxml::xml_node<> *node = svg->first_node();
-    rapidxml::xml_node<> *prev = NULL;
 
-    SVGElement *root = new Group();
-    SVGElement *current = root;
+    // Most files have no style sheet, which saves a walk of the tree
+    bool has_styles = std::string_view(file.data(), file.size()).find(
+                          "<style") != std::string_view::npos;
+    rapidxml::xml_document<> doc;
+    doc.parse< 0 >(file.data());
 
-    // Parse SVG elements
-    while (node) {
-        if (std::string(node->name()) == "defs") {
-            // Parse gradients
-            GetGradients(node);
-            prev = node;
-            node = node->next_sibling();
-        } else if (std::string(node->name()) == "g") {
-            // Parse Group attributes
-            Group *group = dynamic_cast< Group * >(current);
-            for (auto group_attribute : group->getAttributes()) {
-                bool found = false;
-                for (auto attribute = node->first_attribute(); attribute;
-                     attribute = attribute->next_attribute()) {
-                    if (std::string(attribute->name()) ==
-                        group_attribute.first) {
-                        if (group_attribute.first == "opacity") {
-                            // Adjust opacity if already present in the group
-                            // and node
-                            std::string opacity = std::to_string(
-                                std::stof(attribute->value()) *
-                                std::stof(group_attribute.second));
-                            char *value = doc.allocate_string(opacity.c_str());
-                            attribute->value(value);
-                        }
-                        found = true;
-                        break;
-                    }
-                }
+    Group *root = arena.create< Group >(arena.getAllocator());
+    root->setStyle(arena.create< ComputedStyle >());
+    rapidxml::xml_node<> *svg = doc.first_node();
+    if (svg == NULL) return root;
+    parseViewPort(svg);
+    if (has_styles) parseStyleSheets(svg);
+    if (thread_count > 1)
+        parseChildrenConcurrently(root, svg);
+    else
+        parseChildren(root, svg, true);
+    bindSymbols();
+    bindGradients();
+    load_stats.parse_time =
+        std::chrono::duration< double, std::milli >(Clock::now() - loaded)
+            .count();
+    if (!cache_file.empty())
+        SceneCache::write(cache_file, source_hash, file.size(), root,
+                          gradients, viewbox, viewport);
+    return root;
+}
 
-                if (!found && group_attribute.first != "transform") {
-                    // Add missing attributes from the group to the node
-                    char *name =
-                        doc.allocate_string(group_attribute.first.c_str());
-                    char *value =
-                        doc.allocate_string(group_attribute.second.c_str());
-                    rapidxml::xml_attribute<> *new_attribute =
-                        doc.allocate_attribute(name, value);
-                    node->append_attribute(new_attribute);
-                }
-            }
+// Builds the tree from the events of an XmlStream. Only the XML of the
+// element being parsed is kept: the start tag of a group, or the whole
+// subtree of a shape, is copied into a scratch document, turned into
+// SVGElements, then the scratch document is cleared. The subtrees of the
+// <defs> and of the <symbol> are kept in their own document until the
+// gradients and the symbols are bound. The rules of a <style> apply to the
+// elements that follow it.
+class Parser::StreamHandler : public XmlHandler {
+public:
+    StreamHandler(Parser &parser, Group *root)
+        : parser(parser), document(&scratch), current(root), capture(NULL),
+          skip_depth(0), seen_svg(false) {}
+
+    void startElement(const char *name,
+                      const std::vector< XmlAttribute > &attributes) override {
+        if (skip_depth > 0) {
+            ++skip_depth;
+            return;
+        }
+        if (capture != NULL) {
+            // Children of a shape or of a <defs> are parsed with their parent
+            rapidxml::xml_node<> *node = copyElement(name, attributes);
+            capture->append_node(node);
+            capture = node;
+            return;
+        }
 
-            Group *new_group = new Group(xmlToString(node->first_attribute()));
-            new_group->setTransforms(getTransformOrder(node));
-            current->addElement(new_group);
-            current = new_group;
-            prev = node;
-            node = node->first_node();
+        std::string type = name;
+        ElementKind kind;
+        if (!seen_svg) {
+            seen_svg = true;
+            parser.parseViewPort(copyElement(name, attributes));
+            scratch.clear();
+        } else if (type == "g") {
+            current = parser.parseGroup(current, copyElement(name, attributes));
+            scratch.clear();
+        } else if (type == "defs" || type == "symbol" || type == "style" ||
+                   getShapeKind(type, kind)) {
+            if (type == "defs" || type == "symbol") document = &definitions;
+            capture = copyElement(name, attributes);
+            document->append_node(capture);
         } else {
-            // Parse Shape attributes and add to current group
-            Group *group = dynamic_cast< Group * >(current);
-
-            for (auto group_attribute : group->getAttributes()) {
-                bool found = false;
-                for (auto attribute = node->first_attribute(); attribute;
-                     attribute = attribute->next_attribute()) {
-                    if (std::string(attribute->name()) ==
-                        group_attribute.first) {
-                        if (group_attribute.first == "opacity") {
-                            std::string opacity = std::to_string(
-                                std::stof(attribute->value()) *
-                                std::stof(group_attribute.second));
-                            char *value = doc.allocate_string(opacity.c_str());
-                            attribute->value(value);
-                        }
-                        found = true;
-                        break;
-                    }
-                }
+            // Elements that are not rendered are skipped with their children
+            skip_depth = 1;
+        }
+    }
 
-                if (!found && group_attribute.first != "transform") {
-                    char *name =
-                        doc.allocate_string(group_attribute.first.c_str());
-                    char *value =
-                        doc.allocate_string(group_attribute.second.c_str());
-                    rapidxml::xml_attribute<> *new_attribute =
-                        doc.allocate_attribute(name, value);
-                    node->append_attribute(new_attribute);
-                }
-            }
+    void endElement(const char *name) override {
+        if (skip_depth > 0) {
+            --skip_depth;
+            return;
+        }
+        if (capture == NULL) {
+            if (std::string(name) == "g" && current->getParent() != NULL)
+                current = dynamic_cast< Group * >(current->getParent());
+            return;
+        }
+        if (capture->parent() != document) {
+            capture = capture->parent();
+            return;
+        }
 
-            SVGElement *shape = parseShape(node);
+        // The subtree is complete
+        if (std::string(name) == "defs") {
+            parser.parseStyleSheets(capture);
+            parser.GetGradients(capture);
+        } else if (std::string(name) == "symbol") {
+            parser.parseStyleSheets(capture);
+            parser.registerSymbol(capture);
+        } else if (std::string(name) == "style") {
+            parser.parseStyleSheet(capture);
+            scratch.clear();
+        } else {
+            SVGElement *shape =
+                parser.parseShape(capture, current->getStyle());
             if (shape != NULL) current->addElement(shape);
-            prev = node;
-            node = node->next_sibling();
+            scratch.clear();
         }
+        capture = NULL;
+        document = &scratch;
+    }
 
-        if (node == NULL && current != root) {
-            while (prev->parent()->next_sibling() == NULL) {
-                current = current->getParent();
-                prev = prev->parent();
-                if (prev == svg) {
-                    break;
-                }
-            }
-            if (prev == svg) {
-                break;
-            }
-            current = current->getParent();
-            node = prev->parent()->next_sibling();
+    void characterData(const char *data, std::size_t size) override {
+        // A style sheet keeps all of its text, as the data nodes of rapidxml
+        if (capture != NULL && std::strcmp(capture->name(), "style") == 0) {
+            capture->append_node(document->allocate_node(
+                rapidxml::node_data, NULL, copyString(data, size), 0, size));
+            return;
         }
+        // Like rapidxml, the value of an element is its first run of
+        // characters that is not only whitespace
+        if (capture == NULL || capture->value_size() > 0) return;
+        if (std::all_of(data, data + size, [](char c) {
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }))
+            return;
+        capture->value(copyString(data, size), size);
     }
+
+private:
+    // Copies a string into the current document, with its terminating NUL
+    char *copyString(const char *data, std::size_t size) {
+        char *copy = document->allocate_string(NULL, size + 1);
+        std::memcpy(copy, data, size);
+        copy[size] = '\0';
+        return copy;
+    }
+
+    // Copies an element reported by the stream into the current document
+    rapidxml::xml_node<> *copyElement(
+        const char *name, const std::vector< XmlAttribute > &attributes) {
+        rapidxml::xml_node<> *node = document->allocate_node(
+            rapidxml::node_element, copyString(name, std::strlen(name)));
+        for (const XmlAttribute &attribute : attributes) {
+            node->append_attribute(document->allocate_attribute(
+                copyString(attribute.name, std::strlen(attribute.name)),
+                copyString(attribute.value, attribute.value_size),
+                0, attribute.value_size));
+        }
+        return node;
+    }
+
+    Parser &parser;
+    rapidxml::xml_document<> scratch;      // XML of the element being parsed
+    rapidxml::xml_document<> definitions;  // XML of the <defs> read so far
+    rapidxml::xml_document<> *document;    // Document receiving the copies
+    Group *current;                        // Group receiving the elements
+    rapidxml::xml_node<> *capture;         // Innermost open node of the subtree
+    int skip_depth;                        // Depth inside a skipped element
+    bool seen_svg;                         // Whether the <svg> tag was read
+};
+
+// Parse SVG elements while streaming the file
+SVGElement *Parser::streamElements(const std::string &file_name) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    Group *root = arena.create< Group >(arena.getAllocator());
+    root->setStyle(arena.create< ComputedStyle >());
+    XmlStream stream(file_name);
+    StreamHandler handler(*this, root);
+    if (!stream.parse(handler))
+        std::cerr << "Error: malformed SVG file " << file_name << std::endl;
+    bindSymbols();
+    bindGradients();
+
+    // Reading and parsing are interleaved, so all of it is parse time
+    load_stats.bytes = stream.getBytesRead();
+    load_stats.compressed_bytes = stream.getCompressedBytesRead();
+    load_stats.mapped = false;
+    load_stats.parse_time =
+        std::chrono::duration< double, std::milli >(Clock::now() - start)
+            .count();
     return root;
 }
 
-// Parse and retrieve the value of the specified attribute from the XML node
-std::string Parser::getAttribute(rapidxml::xml_node<> *node, std::string name) {
-    if (name == "text") return removeExtraSpaces(node->value());
-    std::string result;
-    if (node->first_attribute(name.c_str()) == NULL) {
-        if (name == "fill" || name == "stop-color")
-            result = "black";
-        else if (name == "stroke" || name == "transform" || name == "rotate" ||
-                 name == "font-style")
-            result = "none";
-        else if (name == "text-anchor")
-            result = "start";
-        else if (name == "fill-rule")
-            result = "nonzero";
-        else if (name == "gradientUnits")
-            result = "objectBoundingBox";
-    } else {
-        result = node->first_attribute(name.c_str())->value();
-    }
-    return result;
+// Retrieve the value of an attribute, or its default value
+std::string Parser::getAttribute(const AttributeTable &attributes,
+                                 AttributeId id) {
+    return std::string(attributes.get(id));
 }
 
-// Parse and retrieve the float value of the specified attribute from the XML
-// node
-float Parser::getFloatAttribute(rapidxml::xml_node<> *node, std::string name) {
+// Retrieve the float value of an attribute, or its default value
+float Parser::getFloatAttribute(const AttributeTable &attributes,
+                                AttributeId id) {
+    // The opacity of an element is multiplied by the one of its ancestors
+    if (id == AttributeId::Opacity && attributes.getStyle() != NULL)
+        return attributes.getStyle()->getOpacity();
+
     float result;
-    if (node->first_attribute(name.c_str()) == NULL) {
-        if (std::string(node->name()).find("Gradient") != std::string::npos) {
+    std::string_view value = attributes.get(id);
+    if (!attributes.has(id)) {
+        if (attributes.getName().find("Gradient") != std::string::npos) {
             // Handle gradient-specific attribute default values
-            if (name == "x1" || name == "y1" || name == "fr")
+            if (id == AttributeId::X1 || id == AttributeId::Y1 ||
+                id == AttributeId::Fr)
                 result = 0;
-            else if (name == "cx" || name == "cy")
-                result = name == "cx" ? 0.5 * this->viewbox.getWidth()
-                                      : 0.5 * this->viewbox.getHeight();
-            else if (name == "r") {
+            else if (id == AttributeId::Cx || id == AttributeId::Cy)
+                result = id == AttributeId::Cx
+                             ? 0.5 * this->viewbox.getWidth()
+                             : 0.5 * this->viewbox.getHeight();
+            else if (id == AttributeId::R) {
                 result = sqrt((pow(this->viewbox.getWidth(), 2) +
                                pow(this->viewbox.getHeight(), 2)) /
                               2) /
                          2;
-            } else if (name == "fx" || name == "fy")
-                result = name == "fx" ? getFloatAttribute(node, "cx")
-                                      : getFloatAttribute(node, "cy");
+            } else if (id == AttributeId::Fx || id == AttributeId::Fy)
+                result = id == AttributeId::Fx
+                             ? getFloatAttribute(attributes, AttributeId::Cx)
+                             : getFloatAttribute(attributes, AttributeId::Cy);
             else
-                result = name == "x2" ? this->viewbox.getWidth()
-                                      : this->viewbox.getHeight();
+                result = id == AttributeId::X2 ? this->viewbox.getWidth()
+                                               : this->viewbox.getHeight();
         } else {
             // Handle default float attribute values for other elements
-            if (name == "stroke-width" || name == "stroke-opacity" ||
-                name == "fill-opacity" || name == "opacity" ||
-                name == "stop-opacity")
+            if (id == AttributeId::StrokeWidth ||
+                id == AttributeId::StrokeOpacity ||
+                id == AttributeId::FillOpacity || id == AttributeId::Opacity ||
+                id == AttributeId::StopOpacity)
                 result = 1;
             else
                 result = 0;
         }
     } else {
-        if (name == "width" || name == "height") {
+        if (id == AttributeId::Width || id == AttributeId::Height) {
             // Handle width and height attributes with percentage or point units
-            std::string value = node->first_attribute(name.c_str())->value();
             if (value.find("%") != std::string::npos) {
-                result = std::stof(value.substr(0, value.find("%"))) *
+                result = NumberScanner::parse(value) *
                          this->viewbox.getWidth() / 100;
             } else if (value.find("pt") != std::string::npos) {
-                result = std::stof(value.substr(0, value.find("pt"))) * 1.33;
+                result = NumberScanner::parse(value) * 1.33;
             } else {
-                result = std::stof(value);
+                result = NumberScanner::parse(value);
             }
         } else
-            result = std::stof(node->first_attribute(name.c_str())->value());
+            result = NumberScanner::parse(value);
     }
     return result;
 }
 
 // Parse and convert color attribute from the XML node
-ColorShape Parser::parseColor(rapidxml::xml_node<> *node, std::string name,
-                              std::string &id) {
-    std::string color = getAttribute(node, name);
-    color.erase(std::remove(color.begin(), color.end(), ' '), color.end());
-    if (color.find("url") == std::string::npos) {
-        for (auto &c : color) c = tolower(c);
-    }
+ColorShape Parser::parseColor(const AttributeTable &attributes,
+                              AttributeId name, std::string &id) {
+    std::string_view color = trimColor(attributes.get(name));
+    // currentColor takes the color property of the element itself, which
+    // may be inherited from a group or set by a style sheet
+    if (isCurrentColor(color))
+        color = trimColor(attributes.get(AttributeId::Color));
     if (color == "none")
         return ColorShape::Transparent;
     else {
         ColorShape result;
-        if (color.find("url") != std::string::npos) {
+        if (color.find("url") != std::string_view::npos) {
             // Handle gradient color reference
-            if (color.find("'") != std::string::npos) {
-                id = color.substr(color.find("'") + 1);
+            std::string url(color);
+            url.erase(std::remove(url.begin(), url.end(), ' '), url.end());
+            if (url.find("'") != std::string::npos) {
+                id = url.substr(url.find("'") + 1);
                 id.erase(id.find("'"));
                 id.erase(id.find("#"), 1);
             } else {
-                id = color.substr(color.find("#") + 1);
+                id = url.substr(url.find("#") + 1);
                 id.erase(id.find(")"));
             }
             result = ColorShape::Transparent;
-        } else if (color.find("#") != std::string::npos) {
-            // Handle hex color representation
-            result = getHexColor(color);
-        } else if (color.find("rgb") != std::string::npos) {
-            // Handle RGB color representation
-            result = getRgbColor(color);
+        } else if (!ColorParser::parse(color, result)) {
+            // Malformed values and unknown keywords fall back to the initial
+            // value, no stroke for the stroke and black for the others
+            result = name == AttributeId::Stroke ? ColorShape::Transparent
+                                                 : ColorShape::Black;
+        }
+        if (name == AttributeId::StopColor) {
+            result.a = result.a *
+                       getFloatAttribute(attributes, AttributeId::StopOpacity);
         } else {
-            // Handle predefined color names
-            auto color_code = color_map.find(color);
-            if (color_code == color_map.end()) {
-                std::cout << "Color " << color << " not found" << std::endl;
-                exit(-1);
-            }
-            result = color_code->second;
+            AttributeId opacity = name == AttributeId::Fill
+                                      ? AttributeId::FillOpacity
+                                      : AttributeId::StrokeOpacity;
+            result.a = result.a * getFloatAttribute(attributes, opacity) *
+                       getFloatAttribute(attributes, AttributeId::Opacity);
         }
-        if (name == "stop-color")
-            result.a = result.a * getFloatAttribute(node, "stop-opacity");
-        else
-            result.a = result.a * getFloatAttribute(node, name + "-opacity") *
-                       getFloatAttribute(node, "opacity");
         return result;
     }
 }
 
-// Parse and return the Gradient object associated with the specified ID
-Gradient *Parser::parseGradient(std::string id) {
-    if (gradients.find(id) == gradients.end()) {
-        std::cout << "Gradient " << id << " not found" << std::endl;
-        exit(-1);
+// Build a gradient on its first use. The href chain is followed up to a
+// gradient that is already built, then built backwards, so that every
+// gradient of the chain is built once and can share the stops of the
+// gradient it references.
+Gradient *Parser::parseGradient(const std::string &id) {
+    std::vector< std::pair< const std::string *, GradientNode * > > chain;
+    Gradient *base = NULL;
+    std::string current = id;
+    while (!current.empty()) {
+        auto built = gradients.find(current);
+        if (built != gradients.end()) {
+            base = built->second;
+            break;
+        }
+        auto pending = gradient_nodes.find(current);
+        if (pending == gradient_nodes.end()) break;
+        if (pending->second.visiting) {
+            std::cerr << "Gradient " << current << " references itself"
+                      << std::endl;
+            break;
+        }
+        pending->second.visiting = true;
+        chain.push_back({&pending->first, &pending->second});
+
+        AttributeTable attributes(pending->second.node);
+        std::string_view href = attributes.get(AttributeId::Href);
+        std::size_t hash = href.find('#');
+        current = hash != std::string_view::npos
+                      ? std::string(href.substr(hash + 1))
+                      : std::string();
+    }
+
+    for (auto link = chain.rbegin(); link != chain.rend(); ++link) {
+        base = buildGradient(link->second->node, base);
+        if (base != NULL) gradients[*link->first] = base;
     }
-    return gradients.at(id);
+    // A link that built no gradient is followed again by its next use, so
+    // the marks are only kept while the chain is followed
+    for (auto &link : chain) link.second->visiting = false;
+    return base;
 }
 
 // Parse and return the gradient stops from the XML node
@@ -458,9 +657,11 @@ std::vector< Stop > Parser::getGradientStops(rapidxml::xml_node<> *node) {
     rapidxml::xml_node<> *stop_node = node->first_node();
     while (stop_node) {
         if (std::string(stop_node->name()) == "stop") {
+            AttributeTable attributes(stop_node, &style_sheet);
             std::string id = "";
-            ColorShape color = parseColor(stop_node, "stop-color", id);
-            float offset = getFloatAttribute(stop_node, "offset");
+            ColorShape color =
+                parseColor(attributes, AttributeId::StopColor, id);
+            float offset = getFloatAttribute(attributes, AttributeId::Offset);
             if (offset > 1) offset /= 100;
             stops.push_back(Stop(color, offset));
         }
@@ -469,436 +670,511 @@ std::vector< Stop > Parser::getGradientStops(rapidxml::xml_node<> *node) {
     return stops;
 }
 
-// Parse and handle gradients defined in the XML node
+// Register the gradients defined in the XML node, by id
 void Parser::GetGradients(rapidxml::xml_node<> *node) {
     rapidxml::xml_node<> *gradient_node = node->first_node();
     while (gradient_node) {
-        if (std::string(gradient_node->name()).find("Gradient") !=
-            std::string::npos) {
-            Gradient *gradient;
-            std::string id = getAttribute(gradient_node, "id");
-            std::string units = getAttribute(gradient_node, "gradientUnits");
-            std::vector< Stop > stops = getGradientStops(gradient_node);
-            std::string href = getAttribute(gradient_node, "xlink:href");
-            int pos = href.find("#");
-            if (pos != std::string::npos) {
-                href = href.substr(pos + 1);
-            }
-            if (std::string(gradient_node->name()).find("linear") !=
-                std::string::npos) {
-                float x1 = getFloatAttribute(gradient_node, "x1");
-                float y1 = getFloatAttribute(gradient_node, "y1");
-                float x2 = getFloatAttribute(gradient_node, "x2");
-                float y2 = getFloatAttribute(gradient_node, "y2");
-                std::pair< Vector2Df, Vector2Df > points = {{x1, y1}, {x2, y2}};
-                gradient = new LinearGradient(stops, points, units);
-                if (this->gradients.find(id) == this->gradients.end())
-                    this->gradients[id] = gradient;
-            } else if (std::string(gradient_node->name()).find("radial") !=
-                       std::string::npos) {
-                float cx = getFloatAttribute(gradient_node, "cx");
-                float cy = getFloatAttribute(gradient_node, "cy");
-                float fx = getFloatAttribute(gradient_node, "fx");
-                float fy = getFloatAttribute(gradient_node, "fy");
-                float r = getFloatAttribute(gradient_node, "r");
-                float fr = getFloatAttribute(gradient_node, "fr");
-                std::pair< Vector2Df, Vector2Df > points = {{cx, cy}, {fx, fy}};
-                Vector2Df radius(r, fr);
-                gradient = new RadialGradient(stops, points, radius, units);
-                if (this->gradients.find(id) == this->gradients.end())
-                    this->gradients[id] = gradient;
-            }
-            if (href != "") {
-                for (auto stop : parseGradient(href)->getStops()) {
-                    gradient->addStop(stop);
-                }
-            }
-            if (gradient != NULL)
-                gradient->setTransforms(getTransformOrder(gradient_node));
+        std::string_view name(gradient_node->name(),
+                              gradient_node->name_size());
+        rapidxml::xml_attribute<> *id = gradient_node->first_attribute("id");
+        if (name.find("Gradient") != std::string_view::npos && id != NULL) {
+            // The first gradient with an id wins
+            gradient_nodes.emplace(std::string(id->value(), id->value_size()),
+                                   GradientNode{gradient_node, false});
+        } else if (gradient_node->type() == rapidxml::node_element) {
+            // Any other definition may be drawn by a <use>
+            registerSymbol(gradient_node);
         }
         gradient_node = gradient_node->next_sibling();
     }
 }
 
+// Build a gradient from its node, with the stops of the gradient it
+// references if it has none of its own
+Gradient *Parser::buildGradient(rapidxml::xml_node<> *node,
+                                const Gradient *base) {
+    std::string_view name(node->name(), node->name_size());
+    AttributeTable attributes(node, &style_sheet);
+    GradientUnits units = getKeyword(
+        getAttribute(attributes, AttributeId::GradientUnits), kGradientUnits);
+    // Stops are shared with the referenced gradient, or with any gradient
+    // of the document that has the same ones
+    std::vector< Stop > stops = getGradientStops(node);
+    StopRamp ramp = stops.empty() && base != NULL
+                        ? base->getSharedStops()
+                        : stop_pool.intern(std::move(stops));
+    Gradient *gradient;
+    if (name.find("linear") != std::string_view::npos) {
+        float x1 = getFloatAttribute(attributes, AttributeId::X1);
+        float y1 = getFloatAttribute(attributes, AttributeId::Y1);
+        float x2 = getFloatAttribute(attributes, AttributeId::X2);
+        float y2 = getFloatAttribute(attributes, AttributeId::Y2);
+        std::pair< Vector2Df, Vector2Df > points = {{x1, y1}, {x2, y2}};
+        gradient = new LinearGradient(std::move(ramp), points, units);
+    } else if (name.find("radial") != std::string_view::npos) {
+        float cx = getFloatAttribute(attributes, AttributeId::Cx);
+        float cy = getFloatAttribute(attributes, AttributeId::Cy);
+        float fx = getFloatAttribute(attributes, AttributeId::Fx);
+        float fy = getFloatAttribute(attributes, AttributeId::Fy);
+        float r = getFloatAttribute(attributes, AttributeId::R);
+        float fr = getFloatAttribute(attributes, AttributeId::Fr);
+        std::pair< Vector2Df, Vector2Df > points = {{cx, cy}, {fx, fy}};
+        Vector2Df radius(r, fr);
+        gradient = new RadialGradient(std::move(ramp), points, radius, units);
+    } else {
+        return NULL;
+    }
+    gradient->setTransform(parseTransform(attributes));
+    return gradient;
+}
+
+// Register a symbol, or another element that a <use> may reference, by id
+void Parser::registerSymbol(rapidxml::xml_node<> *node) {
+    rapidxml::xml_attribute<> *id = node->first_attribute("id");
+    if (id == NULL) return;
+    // The first element with an id wins
+    symbol_nodes.emplace(std::string(id->value(), id->value_size()),
+                         SymbolNode{node, false, {}});
+}
+
+// Get the subtree of a symbol drawn with a style, building it on the first
+// use of this style. The instances of a symbol usually all inherit the same
+// style, so they share a single subtree.
+const Group *Parser::instantiateSymbol(const std::string &id,
+                                       const ComputedStyle *style) {
+    auto found = symbol_nodes.find(id);
+    if (found == symbol_nodes.end()) {
+        std::cerr << "Symbol " << id << " not found" << std::endl;
+        return NULL;
+    }
+    SymbolNode &symbol = found->second;
+    for (const SymbolInstance &instance : symbol.instances) {
+        if (instance.style == style || *instance.style == *style)
+            return instance.tree;
+    }
+    if (symbol.visiting) {
+        std::cerr << "Symbol " << id << " references itself" << std::endl;
+        return NULL;
+    }
+
+    symbol.visiting = true;
+    std::size_t first_use = symbol_uses.size();
+    Group *tree = arena.create< Group >(arena.getAllocator());
+    tree->setStyle(style);
+    std::string_view name(symbol.node->name(), symbol.node->name_size());
+    if (name == "symbol") {
+        parseChildren(tree, symbol.node, true);
+    } else if (name == "g") {
+        Group *group = parseGroup(tree, symbol.node);
+        parseChildren(group, symbol.node, true);
+    } else {
+        SVGElement *shape = parseShape(symbol.node, style);
+        if (shape != NULL) tree->addElement(shape);
+    }
+    // The instances nested in the symbol are bound while it is marked, so a
+    // symbol that uses itself is cut instead of expanded forever
+    bindSymbolUses(first_use);
+    symbol.visiting = false;
+
+    symbol.instances.push_back({style, tree});
+    ++load_stats.symbol_trees;
+    return tree;
+}
+
+// Set the subtrees of the <use> elements found since the given one. The
+// uses are taken off the list first, since building a symbol adds its own.
+void Parser::bindSymbolUses(std::size_t first) {
+    std::vector< std::pair< Use *, std::string > > uses(
+        symbol_uses.begin() + first, symbol_uses.end());
+    symbol_uses.resize(first);
+    for (auto &use : uses)
+        use.first->setSymbol(instantiateSymbol(use.second,
+                                               use.first->getStyle()));
+}
+
+// Set the subtrees of all the <use> elements of the document
+void Parser::bindSymbols() {
+    bindSymbolUses(0);
+    symbol_nodes.clear();
+}
+
+// Set the gradients used by the shapes. A gradient that is missing or has no
+// stops leaves the shape unpainted, as if it were "none".
+void Parser::bindGradients() {
+    for (auto &use : gradient_uses) {
+        Gradient *gradient = parseGradient(use.second);
+        if (gradient == NULL)
+            std::cerr << "Gradient " << use.second << " not found"
+                      << std::endl;
+        else if (!gradient->getStops().empty())
+            use.first->setGradient(gradient);
+    }
+    gradient_uses.clear();
+    gradient_nodes.clear();
+    load_stats.unique_ramps = stop_pool.getUniqueCount();
+    load_stats.ramp_bytes_saved = stop_pool.getBytesSaved();
+}
+
 // Parse SVG elements from the XML document
-std::vector< Vector2Df > Parser::parsePoints(rapidxml::xml_node<> *node) {
+std::vector< Vector2Df > Parser::parsePoints(
+    const AttributeTable &attributes) {
     std::vector< Vector2Df > points;
-    std::string points_string = getAttribute(node, "points");
-
-    std::stringstream ss(points_string);
+    NumberScanner scanner(attributes.get(AttributeId::Points));
     float x, y;
 
-    while (ss >> x) {
-        if (ss.peek() == ',') ss.ignore();
-        ss >> y;
+    // An odd number of coordinates leaves the last one out
+    while (scanner.next(x) && scanner.next(y)) {
         points.push_back(Vector2Df(x, y));
     }
 
     return points;
 }
 
-// Parse and convert path data into a vector of PathPoint
-std::vector< PathPoint > Parser::parsePathPoints(rapidxml::xml_node<> *node) {
-    std::vector< PathPoint > points;
-    std::string path_string = getAttribute(node, "d");
-
-    // Pre-processing the raw path string
-    formatSvgPathString(path_string);
-
-    // Tokenizing the path string using stringstream
-    std::stringstream ss(path_string);
-    std::string element;
-    PathPoint pPoint{{0, 0}, 'M'};  // Default starting point and command
-    while (ss >> element) {
-        if (std::isalpha(element[0])) {
-            pPoint.tc = element[0];
-            if (tolower(pPoint.tc) == 'm' || tolower(pPoint.tc) == 'l' ||
-                tolower(pPoint.tc) == 'c' || tolower(pPoint.tc) == 's' ||
-                tolower(pPoint.tc) == 'q' || tolower(pPoint.tc) == 't')
-                ss >> pPoint.point.x >> pPoint.point.y;
-            else if (tolower(pPoint.tc) == 'h') {
-                ss >> pPoint.point.x;
-                pPoint.point.y = 0;
-            } else if (tolower(pPoint.tc) == 'v') {
-                ss >> pPoint.point.y;
-                pPoint.point.x = 0;
-            } else if (tolower(pPoint.tc) == 'a') {
-                ss >> pPoint.radius.x >> pPoint.radius.y;
-                ss >> pPoint.x_axis_rotation;
-                ss >> pPoint.large_arc_flag >> pPoint.sweep_flag;
-                ss >> pPoint.point.x >> pPoint.point.y;
-            }
-        } else {
-            if (tolower(pPoint.tc) == 'm' || tolower(pPoint.tc) == 'l' ||
-                tolower(pPoint.tc) == 'c' || tolower(pPoint.tc) == 's' ||
-                tolower(pPoint.tc) == 'q' || tolower(pPoint.tc) == 't') {
-                if (tolower(pPoint.tc) == 'm') pPoint.tc = 'L';
-                pPoint.point.x = std::stof(element);
-                ss >> pPoint.point.y;
-            } else if (tolower(pPoint.tc) == 'h') {
-                pPoint.point.x = std::stof(element);
-                pPoint.point.y = 0;
-            } else if (tolower(pPoint.tc) == 'v') {
-                pPoint.point.y = std::stof(element);
-                pPoint.point.x = 0;
-            } else if (tolower(pPoint.tc) == 'a') {
-                pPoint.radius.x = std::stof(element);
-                ss >> pPoint.radius.y;
-                ss >> pPoint.x_axis_rotation;
-                ss >> pPoint.large_arc_flag >> pPoint.sweep_flag;
-                ss >> pPoint.point.x >> pPoint.point.y;
-            }
-        }
-        points.push_back(pPoint);
-    }
-
-    std::vector< PathPoint > handle_points;
-
-    // Processing and transforming raw path points
+// Parse and convert path data into the geometry of a path
+void Parser::parsePathPoints(const AttributeTable &attributes, Path *path) {
+    // The geometry is collected in reused buffers, so that the path stores it
+    // at its exact size
+    thread_local std::vector< char > commands;
+    thread_local std::vector< Vector2Df > points;
+    thread_local std::vector< PathArc > arcs;
+    commands.clear();
+    points.clear();
+    arcs.clear();
+    std::string_view data = attributes.get(AttributeId::D);
+
+    // Scan the raw attribute buffer and resolve every command to absolute
+    // coordinates on the fly
+    PathScanner scanner(data.data(), data.data() + data.size());
+    PathCommand command;
     Vector2Df first_point{0, 0}, cur_point{0, 0};
-    int n = points.size();
-    for (int i = 0; i < n; i++) {
-        if (tolower(points[i].tc) == 'm') {
-            first_point = points[i].point;
-            if (points[i].tc == 'm') {
-                first_point.x = cur_point.x + points[i].point.x;
-                first_point.y = cur_point.y + points[i].point.y;
-            }
+    while (scanner.next(command)) {
+        char type = tolower(command.type);
+        const float *args = command.args;
+        Vector2Df origin{0, 0};
+        if (command.type == type) origin = cur_point;
+
+        if (type == 'm') {
+            first_point = Vector2Df{origin.x + args[0], origin.y + args[1]};
             cur_point = first_point;
-            handle_points.push_back({first_point, 'm'});
-
-        } else if (tolower(points[i].tc) == 'l' ||
-                   tolower(points[i].tc) == 't') {
-            Vector2Df end_point{cur_point.x + points[i].point.x,
-                                cur_point.y + points[i].point.y};
-            if (points[i].tc == 'L' || points[i].tc == 'T')
-                end_point = points[i].point;
-            cur_point = end_point;
-            char TC = tolower(points[i].tc);
-            handle_points.push_back({end_point, TC});
-
-        } else if (tolower(points[i].tc) == 'h') {
-            Vector2Df end_point{cur_point.x + points[i].point.x, cur_point.y};
-            if (points[i].tc == 'H')
-                end_point = Vector2Df{points[i].point.x, cur_point.y};
-            cur_point = end_point;
-            handle_points.push_back({end_point, 'h'});
-
-        } else if (tolower(points[i].tc) == 'v') {
-            Vector2Df end_point{cur_point.x, cur_point.y + points[i].point.y};
-            if (points[i].tc == 'V')
-                end_point = Vector2Df{cur_point.x, points[i].point.y};
-            cur_point = end_point;
-            handle_points.push_back({end_point, 'v'});
-
-        } else if (tolower(points[i].tc) == 'c') {
-            if (i + 2 < n) {
-                Vector2Df control_point1 =
-                    Vector2Df{cur_point.x + points[i].point.x,
-                              cur_point.y + points[i].point.y};
-                Vector2Df control_point2 =
-                    Vector2Df{cur_point.x + points[i + 1].point.x,
-                              cur_point.y + points[i + 1].point.y};
-                Vector2Df control_point3 =
-                    Vector2Df{cur_point.x + points[i + 2].point.x,
-                              cur_point.y + points[i + 2].point.y};
-                if (points[i].tc == 'C') {
-                    control_point1 = points[i].point;
-                    control_point2 = points[i + 1].point;
-                    control_point3 = points[i + 2].point;
-                }
-                i += 2;
-                cur_point = control_point3;
-                handle_points.push_back({control_point1, 'c'});
-                handle_points.push_back({control_point2, 'c'});
-                handle_points.push_back({control_point3, 'c'});
-            }
-        } else if (tolower(points[i].tc) == 'z') {
-            cur_point = first_point;
-            handle_points.push_back({first_point, 'z'});
-
-        } else if (tolower(points[i].tc) == 's' ||
-                   tolower(points[i].tc) == 'q') {
-            if (i + 1 < n) {
-                Vector2Df control_point1 =
-                    Vector2Df{cur_point.x + points[i].point.x,
-                              cur_point.y + points[i].point.y};
-                Vector2Df control_point2 =
-                    Vector2Df{cur_point.x + points[i + 1].point.x,
-                              cur_point.y + points[i + 1].point.y};
-                if (points[i].tc == 'S' || points[i].tc == 'Q') {
-                    control_point1 = points[i].point;
-                    control_point2 = points[i + 1].point;
-                }
-                i += 1;
-                cur_point = control_point2;
-                char TC = tolower(points[i].tc);
-                handle_points.push_back({control_point1, TC});
-                handle_points.push_back({control_point2, TC});
+            commands.push_back('m');
+            points.push_back(first_point);
+
+        } else if (type == 'l' || type == 't') {
+            cur_point = Vector2Df{origin.x + args[0], origin.y + args[1]};
+            commands.push_back(type);
+            points.push_back(cur_point);
+
+        } else if (type == 'h') {
+            cur_point.x = origin.x + args[0];
+            commands.push_back('h');
+            points.push_back(cur_point);
+
+        } else if (type == 'v') {
+            cur_point.y = origin.y + args[0];
+            commands.push_back('v');
+            points.push_back(cur_point);
+
+        } else if (type == 'c' || type == 's' || type == 'q') {
+            // Every coordinate pair of a curve is relative to the start point
+            for (int i = 0; i < command.count; i += 2) {
+                commands.push_back(type);
+                points.push_back(
+                    Vector2Df{origin.x + args[i], origin.y + args[i + 1]});
             }
+            cur_point = points.back();
 
-        } else if (tolower(points[i].tc) == 'a') {
-            Vector2Df end_point{cur_point.x + points[i].point.x,
-                                cur_point.y + points[i].point.y};
-            if (points[i].tc == 'A') end_point = points[i].point;
-            handle_points.push_back(
-                {end_point, 'a', points[i].radius, points[i].x_axis_rotation,
-                 points[i].large_arc_flag, points[i].sweep_flag});
-            cur_point = end_point;
+        } else if (type == 'z') {
+            cur_point = first_point;
+            commands.push_back('z');
+            points.push_back(first_point);
+
+        } else if (type == 'a') {
+            cur_point = Vector2Df{origin.x + args[5], origin.y + args[6]};
+            commands.push_back('a');
+            points.push_back(cur_point);
+            arcs.push_back({Vector2Df{args[0], args[1]}, args[2],
+                            args[3] != 0, args[4] != 0});
         }
     }
-    return handle_points;
+    path->setGeometry({commands, points, arcs});
 }
 
-// Retrieve the order of transformations applied to the SVG element
-std::vector< std::string > Parser::getTransformOrder(
-    rapidxml::xml_node<> *node) {
-    std::string transform_tag;
-    if (std::string(node->name()).find("Gradient") != std::string::npos) {
-        transform_tag = getAttribute(node, "gradientTransform");
-    } else {
-        transform_tag = getAttribute(node, "transform");
-    }
-
-    std::vector< std::string > order;
-    std::stringstream ss(transform_tag);
-    std::string type;
-    while (ss >> type) {
-        if (type.find("translate") != std::string::npos ||
-            type.find("scale") != std::string::npos ||
-            type.find("rotate") != std::string::npos ||
-            type.find("matrix") != std::string::npos) {
-            while (type.find(")") == std::string::npos) {
-                std::string temp;
-                ss >> temp;
-                type += " " + temp;
-            }
-            std::string temp = type.substr(0, type.find("(") + 1);
-            temp.erase(std::remove(temp.begin(), temp.end(), ' '), temp.end());
-            type.erase(0, type.find("(") + 1);
-            type = temp + type;
-            order.push_back(type);
+// Resolve the transform list of the SVG element into a single matrix
+AffineTransform Parser::parseTransform(const AttributeTable &attributes) {
+    std::string_view list =
+        attributes.getName().find("Gradient") != std::string::npos
+            ? attributes.get(AttributeId::GradientTransform)
+            : attributes.get(AttributeId::Transform);
+
+    AffineTransform result;
+    const char *cursor = list.data();
+    const char *end = list.data() + list.size();
+    while (true) {
+        while (cursor != end && (isspace(*cursor) || *cursor == ',')) ++cursor;
+        if (cursor == end) break;
+
+        const char *name = cursor;
+        while (cursor != end && isalpha(*cursor)) ++cursor;
+        std::string_view type(name, cursor - name);
+        while (cursor != end && isspace(*cursor)) ++cursor;
+        if (type.empty() || cursor == end || *cursor != '(')
+            return AffineTransform();
+        const char *close = std::find(cursor, end, ')');
+        if (close == end) return AffineTransform();
+
+        float args[6] = {0, 0, 0, 0, 0, 0};
+        int count = 0;
+        NumberScanner scanner(cursor + 1, close);
+        while (count < 6 && scanner.next(args[count])) ++count;
+        cursor = close + 1;
+
+        AffineTransform step;
+        if (type == "translate" && count >= 1) {
+            step = AffineTransform::translate(args[0], args[1]);
+        } else if (type == "scale" && count >= 1) {
+            step =
+                AffineTransform::scale(args[0], count > 1 ? args[1] : args[0]);
+        } else if (type == "rotate" && count >= 1) {
+            // rotate(a cx cy) turns around (cx, cy) instead of the origin
+            step = AffineTransform::translate(args[1], args[2]) *
+                   AffineTransform::rotate(args[0]) *
+                   AffineTransform::translate(-args[1], -args[2]);
+        } else if (type == "skewX" && count >= 1) {
+            step = AffineTransform::skewX(args[0]);
+        } else if (type == "skewY" && count >= 1) {
+            step = AffineTransform::skewY(args[0]);
+        } else if (type == "matrix" && count == 6) {
+            step = AffineTransform(args[0], args[1], args[2], args[3], args[4],
+                                   args[5]);
+        } else {
+            // An invalid list disables the whole transform
+            return AffineTransform();
         }
+        result = result * step;
     }
-    return order;
+    return result;
 }
 
 // Parse and convert SVG elements from the XML document
-SVGElement *Parser::parseShape(rapidxml::xml_node<> *node) {
+SVGElement *Parser::parseShape(rapidxml::xml_node<> *node,
+                               const ComputedStyle *parent_style) {
+    ElementKind kind;
+    if (!getShapeKind(std::string_view(node->name(), node->name_size()), kind))
+        return NULL;
     SVGElement *shape = NULL;
-    std::string type = node->name();
+    AttributeTable attributes(node, &style_sheet);
+    const ComputedStyle *style =
+        ComputedStyle::derive(parent_style, attributes, arena);
+    attributes.setStyle(style);
     std::string id = "";
-    ColorShape stroke_color = parseColor(node, "stroke", id);
-    ColorShape fill_color = parseColor(node, "fill", id);
-    float stroke_width = getFloatAttribute(node, "stroke-width");
-    // Determine the type of SVG element and create the corresponding object
-    if (type == "line") {
-        shape = parseLine(node, stroke_color, stroke_width);
-    } else if (type == "rect") {
-        shape = parseRect(node, fill_color, stroke_color, stroke_width);
-    } else if (type == "circle") {
-        shape = parseCircle(node, fill_color, stroke_color, stroke_width);
-    } else if (type == "ellipse") {
-        shape = parseEllipse(node, fill_color, stroke_color, stroke_width);
-    } else if (type == "polygon") {
-        shape = parsePolygon(node, fill_color, stroke_color, stroke_width);
-    } else if (type == "polyline") {
-        shape = parsePolyline(node, fill_color, stroke_color, stroke_width);
-    } else if (type == "path") {
-        shape = parsePath(node, fill_color, stroke_color, stroke_width);
-    } else if (type == "text") {
-        shape = parseText(node, fill_color, stroke_color, stroke_width);
+    ColorShape stroke_color = parseColor(attributes, AttributeId::Stroke, id);
+    ColorShape fill_color = parseColor(attributes, AttributeId::Fill, id);
+    float stroke_width =
+        getFloatAttribute(attributes, AttributeId::StrokeWidth);
+    // Create the object of the kind of the SVG element
+    switch (kind) {
+        case ElementKind::Line:
+            shape = parseLine(attributes, stroke_color, stroke_width);
+            break;
+        case ElementKind::Rect:
+            shape =
+                parseRect(attributes, fill_color, stroke_color, stroke_width);
+            break;
+        case ElementKind::Circle:
+            shape =
+                parseCircle(attributes, fill_color, stroke_color, stroke_width);
+            break;
+        case ElementKind::Ellipse:
+            shape = parseEllipse(attributes, fill_color, stroke_color,
+                                 stroke_width);
+            break;
+        case ElementKind::Polygon:
+            shape = parsePolygon(attributes, fill_color, stroke_color,
+                                 stroke_width);
+            break;
+        case ElementKind::Polyline:
+            shape = parsePolyline(attributes, fill_color, stroke_color,
+                                  stroke_width);
+            break;
+        case ElementKind::Path:
+            shape =
+                parsePath(attributes, fill_color, stroke_color, stroke_width);
+            break;
+        case ElementKind::Text:
+            shape =
+                parseText(attributes, fill_color, stroke_color, stroke_width);
+            break;
+        case ElementKind::Use:
+            shape = parseUse(attributes);
+            break;
+        default:
+            break;
     }
 
     // Apply transformations and gradient if applicable
     if (shape != NULL) {
-        if (type == "text") {
-            float dx = getFloatAttribute(node, "dx");
-            float dy = getFloatAttribute(node, "dy");
-            std::string transform = "translate(" + std::to_string(dx) + " " +
-                                    std::to_string(dy) + ")";
-            std::vector< std::string > transform_order =
-                getTransformOrder(node);
-            transform_order.push_back(transform);
-            shape->setTransforms(transform_order);
+        shape->setStyle(style);
+        if (kind == ElementKind::Text) {
+            float dx = getFloatAttribute(attributes, AttributeId::Dx);
+            float dy = getFloatAttribute(attributes, AttributeId::Dy);
+            shape->setTransform(parseTransform(attributes) *
+                                AffineTransform::translate(dx, dy));
+        } else if (kind == ElementKind::Use) {
+            float x = getFloatAttribute(attributes, AttributeId::X);
+            float y = getFloatAttribute(attributes, AttributeId::Y);
+            shape->setTransform(parseTransform(attributes) *
+                                AffineTransform::translate(x, y));
         } else
-            shape->setTransforms(getTransformOrder(node));
+            shape->setTransform(parseTransform(attributes));
+        // The gradient may be defined later in the document
         if (id != "") {
-            shape->setGradient(parseGradient(id));
+            std::lock_guard< std::mutex > lock(uses_mutex);
+            gradient_uses.push_back({shape, id});
         }
     }
     return shape;
 }
 
+// Parse a <use> element. Its subtree is set once the whole document is read,
+// so that it may reference a symbol defined after it.
+Use *Parser::parseUse(const AttributeTable &attributes) {
+    std::string_view href = attributes.get(AttributeId::Href);
+    std::size_t hash = href.find('#');
+    if (hash == std::string_view::npos) return NULL;
+    Use *shape = arena.create< Use >();
+    std::lock_guard< std::mutex > lock(uses_mutex);
+    symbol_uses.push_back({shape, std::string(href.substr(hash + 1))});
+    ++load_stats.symbol_instances;
+    return shape;
+}
+
 // Parse a line element
-Line *Parser::parseLine(rapidxml::xml_node<> *node,
+Line *Parser::parseLine(const AttributeTable &attributes,
                         const ColorShape &stroke_color, float stroke_width) {
-    Line *shape = new Line(
-        Vector2Df(getFloatAttribute(node, "x1"), getFloatAttribute(node, "y1")),
-        Vector2Df(getFloatAttribute(node, "x2"), getFloatAttribute(node, "y2")),
-        stroke_color, stroke_width);
+    float x1 = getFloatAttribute(attributes, AttributeId::X1);
+    float y1 = getFloatAttribute(attributes, AttributeId::Y1);
+    float x2 = getFloatAttribute(attributes, AttributeId::X2);
+    float y2 = getFloatAttribute(attributes, AttributeId::Y2);
+    Line *shape = arena.create< Line >(Vector2Df(x1, y1), Vector2Df(x2, y2),
+                                       stroke_color, stroke_width);
     return shape;
 }
 
 // Parse a rectangle element
-Rect *Parser::parseRect(rapidxml::xml_node<> *node,
+Rect *Parser::parseRect(const AttributeTable &attributes,
                         const ColorShape &fill_color,
                         const ColorShape &stroke_color, float stroke_width) {
-    float x = getFloatAttribute(node, "x");
-    float y = getFloatAttribute(node, "y");
-    float rx = getFloatAttribute(node, "rx");
-    float ry = getFloatAttribute(node, "ry");
-    Rect *shape =
-        new Rect(getFloatAttribute(node, "width"),
-                 getFloatAttribute(node, "height"), Vector2Df(x, y),
-                 Vector2Df(rx, ry), fill_color, stroke_color, stroke_width);
+    float x = getFloatAttribute(attributes, AttributeId::X);
+    float y = getFloatAttribute(attributes, AttributeId::Y);
+    float rx = getFloatAttribute(attributes, AttributeId::Rx);
+    float ry = getFloatAttribute(attributes, AttributeId::Ry);
+    float width = getFloatAttribute(attributes, AttributeId::Width);
+    float height = getFloatAttribute(attributes, AttributeId::Height);
+    Rect *shape = arena.create< Rect >(width, height, Vector2Df(x, y),
+                                       Vector2Df(rx, ry), fill_color,
+                                       stroke_color, stroke_width);
     return shape;
 }
 
 // Parse a circle element
-Circle *Parser::parseCircle(rapidxml::xml_node<> *node,
+Circle *Parser::parseCircle(const AttributeTable &attributes,
                             const ColorShape &fill_color,
                             const ColorShape &stroke_color,
                             float stroke_width) {
-    float cx = getFloatAttribute(node, "cx");
-    float cy = getFloatAttribute(node, "cy");
-    float radius = getFloatAttribute(node, "r");
-    Circle *shape = new Circle(radius, Vector2Df(cx, cy), fill_color,
-                               stroke_color, stroke_width);
+    float cx = getFloatAttribute(attributes, AttributeId::Cx);
+    float cy = getFloatAttribute(attributes, AttributeId::Cy);
+    float radius = getFloatAttribute(attributes, AttributeId::R);
+    Circle *shape = arena.create< Circle >(radius, Vector2Df(cx, cy),
+                                           fill_color, stroke_color,
+                                           stroke_width);
     return shape;
 }
 
 // Parse an ellipse element
-Ell *Parser::parseEllipse(rapidxml::xml_node<> *node,
+Ell *Parser::parseEllipse(const AttributeTable &attributes,
                           const ColorShape &fill_color,
                           const ColorShape &stroke_color, float stroke_width) {
-    float radius_x = getFloatAttribute(node, "rx");
-    float radius_y = getFloatAttribute(node, "ry");
-    float cx = getFloatAttribute(node, "cx");
-    float cy = getFloatAttribute(node, "cy");
-    Ell *shape = new Ell(Vector2Df(radius_x, radius_y), Vector2Df(cx, cy),
-                         fill_color, stroke_color, stroke_width);
+    float radius_x = getFloatAttribute(attributes, AttributeId::Rx);
+    float radius_y = getFloatAttribute(attributes, AttributeId::Ry);
+    float cx = getFloatAttribute(attributes, AttributeId::Cx);
+    float cy = getFloatAttribute(attributes, AttributeId::Cy);
+    Ell *shape = arena.create< Ell >(Vector2Df(radius_x, radius_y),
+                                     Vector2Df(cx, cy), fill_color,
+                                     stroke_color, stroke_width);
     return shape;
 }
 
 // Parse a polygon element
-Plygon *Parser::parsePolygon(rapidxml::xml_node<> *node,
+Plygon *Parser::parsePolygon(const AttributeTable &attributes,
                              const ColorShape &fill_color,
                              const ColorShape &stroke_color,
                              float stroke_width) {
-    Plygon *shape = new Plygon(fill_color, stroke_color, stroke_width);
-    std::vector< Vector2Df > points = parsePoints(node);
+    Plygon *shape = arena.create< Plygon >(fill_color, stroke_color,
+                                           stroke_width, arena.getAllocator());
+    std::vector< Vector2Df > points = parsePoints(attributes);
     for (auto point : points) {
         shape->addPoint(point);
     }
-    std::string fill_rule = getAttribute(node, "fill-rule");
-    fill_rule.erase(std::remove(fill_rule.begin(), fill_rule.end(), ' '),
-                    fill_rule.end());
-    shape->setFillRule(fill_rule);
+    shape->setFillRule(getKeyword(
+        getAttribute(attributes, AttributeId::FillRule), kFillRules));
     return shape;
 }
 
 // Parse a polyline element
-Plyline *Parser::parsePolyline(rapidxml::xml_node<> *node,
+Plyline *Parser::parsePolyline(const AttributeTable &attributes,
                                const ColorShape &fill_color,
                                const ColorShape &stroke_color,
                                float stroke_width) {
-    Plyline *shape = new Plyline(fill_color, stroke_color, stroke_width);
-    std::vector< Vector2Df > points = parsePoints(node);
+    Plyline *shape = arena.create< Plyline >(
+        fill_color, stroke_color, stroke_width, arena.getAllocator());
+    std::vector< Vector2Df > points = parsePoints(attributes);
     for (auto point : points) {
         shape->addPoint(point);
     }
-    std::string fill_rule = getAttribute(node, "fill-rule");
-    fill_rule.erase(std::remove(fill_rule.begin(), fill_rule.end(), ' '),
-                    fill_rule.end());
-    shape->setFillRule(fill_rule);
+    shape->setFillRule(getKeyword(
+        getAttribute(attributes, AttributeId::FillRule), kFillRules));
     return shape;
 }
 
 // Parse a text element
-Text *Parser::parseText(rapidxml::xml_node<> *node,
+Text *Parser::parseText(const AttributeTable &attributes,
                         const ColorShape &fill_color,
                         const ColorShape &stroke_color, float stroke_width) {
-    float x = getFloatAttribute(node, "x");
-    float y = getFloatAttribute(node, "y");
-    float font_size = getFloatAttribute(node, "font-size");
-    std::string text = getAttribute(node, "text");
-
-    Text *shape =
-        new Text(Vector2Df(x - (font_size * 6.6 / 40),
-                           y - font_size + (font_size * 4.4 / 40)),
-                 text, font_size, fill_color, stroke_color, stroke_width);
-
-    std::string anchor = getAttribute(node, "text-anchor");
-    anchor.erase(std::remove(anchor.begin(), anchor.end(), ' '), anchor.end());
-    shape->setAnchor(anchor);
-
-    std::string style = getAttribute(node, "font-style");
-    style.erase(std::remove(style.begin(), style.end(), ' '), style.end());
-    shape->setFontStyle(style);
+    float x = getFloatAttribute(attributes, AttributeId::X);
+    float y = getFloatAttribute(attributes, AttributeId::Y);
+    float font_size = getFloatAttribute(attributes, AttributeId::FontSize);
+    std::string text = removeExtraSpaces(std::string(attributes.getValue()));
+
+    Text *shape = arena.create< Text >(
+        Vector2Df(x - (font_size * 6.6 / 40),
+                  y - font_size + (font_size * 4.4 / 40)),
+        text, font_size, fill_color, stroke_color, stroke_width,
+        arena.getAllocator());
+
+    shape->setAnchor(getKeyword(
+        getAttribute(attributes, AttributeId::TextAnchor), kTextAnchors));
+    shape->setFontStyle(getKeyword(
+        getAttribute(attributes, AttributeId::FontStyle), kFontStyles));
 
     return shape;
 }
 
 // Parse a path element
-Path *Parser::parsePath(rapidxml::xml_node<> *node,
+Path *Parser::parsePath(const AttributeTable &attributes,
                         const ColorShape &fill_color,
                         const ColorShape &stroke_color, float stroke_width) {
-    Path *shape = new Path(fill_color, stroke_color, stroke_width);
-    std::vector< PathPoint > points = parsePathPoints(node);
-    for (auto point : points) {
-        shape->addPoint(point);
-    }
-    std::string fill_rule = getAttribute(node, "fill-rule");
-    fill_rule.erase(std::remove(fill_rule.begin(), fill_rule.end(), ' '),
-                    fill_rule.end());
-    shape->setFillRule(fill_rule);
+    Path *shape =
+        arena.create< Path >(fill_color, stroke_color, stroke_width,
+                             arena.getAllocator(), arena.getCacheAllocator());
+    parsePathPoints(attributes, shape);
+    shape->setFillRule(getKeyword(
+        getAttribute(attributes, AttributeId::FillRule), kFillRules));
     return shape;
 }
 
 // Destructor
 Parser::~Parser() {
-    delete root;
+    // The tree is freed with the arena
     for (auto gradient : gradients) {
         delete gradient.second;
     }
@@ -911,4 +1187,7 @@ void Parser::printShapesData() { root->printData(); }
 ViewBox Parser::getViewBox() const { return viewbox; }
 
 // Get the viewport of the SVG document
-Vector2Df Parser::getViewPort() const { return viewport; }
\ No newline at end of file
+Vector2Df Parser::getViewPort() const { return viewport; }
+
+// Get the statistics about the loading of the SVG document
+LoadStats Parser::getLoadStats() const { return load_stats; }
\ No newline at end of file
@@ -2,38 +2,108 @@
 #define PARSER_HPP_
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "../external/rapidxml/rapidxml.hpp"
+#include "AttributeTable.hpp"
+#include "ColorParser.hpp"
+#include "ComputedStyle.hpp"
 #include "Graphics.hpp"
+#include "MappedFile.hpp"
+#include "NumberScanner.hpp"
+#include "PathScanner.hpp"
+#include "SceneArena.hpp"
+#include "SceneCache.hpp"
+#include "SceneBVH.hpp"
+#include "SceneStore.hpp"
+#include "StopPool.hpp"
+#include "StyleSheet.hpp"
+#include "XmlStream.hpp"
 
-typedef std::vector< std::pair< std::string, std::string > > Attributes;
+/**
+ * @brief The ways an SVG file can be loaded into memory before parsing.
+ */
+enum class LoadMode {
+    Mapped,     ///< Memory-map the file and parse it in place
+    Buffered,   ///< Read the whole file into a buffer of the exact size
+    Streaming,  ///< Read the file in chunks and build the tree on the fly,
+                ///< for files that do not fit in memory
+};
+
+/**
+ * @brief Statistics about the loading of an SVG file.
+ */
+struct LoadStats {
+    std::size_t bytes = 0;             ///< Size of the document in bytes
+    std::size_t compressed_bytes = 0;  ///< Size of the file if compressed,
+                                       ///< 0 otherwise
+    bool mapped = false;               ///< Whether the file was memory-mapped
+    double load_time = 0.0;            ///< Time spent mapping, reading or
+                                       ///< inflating, in ms
+    double parse_time = 0.0;           ///< Time spent parsing, in ms.
+                                       ///< Includes the reading when
+                                       ///< streaming
+    bool cache_hit = false;            ///< Whether the scene was read from
+                                       ///< the cache
+    std::size_t unique_ramps = 0;      ///< Distinct stop lists of the
+                                       ///< gradients
+    std::size_t ramp_bytes_saved = 0;  ///< Bytes saved by sharing the
+                                       ///< identical stop lists
+    std::size_t symbol_instances = 0;  ///< Number of <use> elements
+    std::size_t symbol_trees = 0;      ///< Distinct subtrees built for the
+                                       ///< <use> elements
+    std::size_t arena_bytes = 0;       ///< Memory taken by the tree of
+                                       ///< SVGElements
+    double store_time = 0.0;           ///< Time spent flattening the tree
+                                       ///< into the SceneStore, in ms
+    std::size_t store_bytes = 0;       ///< Memory taken by the SceneStore
+    double bvh_time = 0.0;             ///< Time spent building the SceneBVH
+                                       ///< over the store, in ms
+    std::size_t bvh_bytes = 0;         ///< Memory taken by the SceneBVH
+};
 
 /**
  * @brief To manipulate and parse an SVG file.
  *
- * The Parser class is a singleton class that is used to parse an SVG file and
- * create a tree of SVGElements.
+ * The Parser class is used to parse an SVG file and create a tree of
+ * SVGElements. Each Parser owns the tree, built in its own arena, the
+ * gradients and the viewport of its own document and shares no mutable state
+ * with other instances, so several documents can be parsed concurrently, one
+ * Parser per thread.
  */
 class Parser {
 public:
     /**
-     * @brief Gets the singleton instance of the Parser class.
+     * @brief Parses an SVG file.
      *
      * @param file_name The name of the file to be parsed.
-     *
-     * @return The singleton instance of the Parser class.
+     * @param mode The way the file is loaded into memory.
+     * @param threads The number of threads building the top-level groups,
+     * 0 for one per core. With more than one thread, every <defs> of the
+     * document is read before the groups are built.
+     * @param cache_file The scene cache of the file, empty for none. When it
+     * matches the content of the file the scene is read from it without
+     * parsing the XML, otherwise it is rewritten after parsing.
+     * @note Streaming always parses on the calling thread, without cache.
      */
-    static Parser* getInstance(const std::string& file_name);
+    explicit Parser(const std::string& file_name,
+                    LoadMode mode = LoadMode::Mapped, unsigned int threads = 1,
+                    const std::string& cache_file = "");
 
     /**
-     * @brief Deleted copy constructor to enforce the singleton pattern.
+     * @brief Deleted copy constructor, the parser owns the tree.
      */
     Parser(const Parser&) = delete;
 
@@ -49,6 +119,20 @@ public:
      */
     Group* getRoot();
 
+    /**
+     * @brief Gets the flattened copy of the tree of SVGElements.
+     *
+     * @return The store of the scene, built once the tree is complete.
+     */
+    const SceneStore& getStore() const;
+
+    /**
+     * @brief Gets the bounding-volume hierarchy over the shapes of the store.
+     *
+     * @return The hierarchy, built once the store is.
+     */
+    const SceneBVH& getSceneBVH() const;
+
     /**
      * @brief Prints the data of the shapes.
      *
@@ -70,14 +154,15 @@ public:
      */
     Vector2Df getViewPort() const;
 
-private:
     /**
-     * @brief Construct a new Parser object.
+     * @brief Gets the statistics about the loading of the SVG file.
      *
-     * @param file_name The name of the file to be parsed.
+     * @return The number of bytes loaded, whether they were memory-mapped and
+     * the time spent loading and parsing them.
      */
-    Parser(const std::string& file_name);
+    LoadStats getLoadStats() const;
 
+private:
     /**
      * @brief Parses the SVG file and creates a tree of SVGElements.
      *
@@ -88,24 +173,84 @@ private:
     SVGElement* parseElements(std::string file_name);
 
     /**
-     * @brief Gets the attributes of a node.
+     * @brief Parses the SVG file while streaming it, without building the
+     * whole XML document in memory.
      *
-     * @param node The node to be parsed.
-     * @param name The name of tag to be parsed.
+     * @param file_name The name of the file to be parsed.
      *
-     * @return The attributes of the node.
+     * @return The root of the tree of SVGElements.
      */
-    std::string getAttribute(rapidxml::xml_node<>* node, std::string name);
+    SVGElement* streamElements(const std::string& file_name);
 
     /**
-     * @brief Gets the floating point attributes of a node.
+     * @brief Reads the rules of every <style> element under a node.
      *
-     * @param node The node to be parsed.
-     * @param name The name of tag to be parsed.
+     * @param node The node whose subtree is searched.
+     */
+    void parseStyleSheets(rapidxml::xml_node<>* node);
+
+    /**
+     * @brief Reads the rules of a <style> element.
+     *
+     * @param node The node of the <style> element.
+     * @note The text and CDATA children of the node are read as one sheet.
+     */
+    void parseStyleSheet(rapidxml::xml_node<>* node);
+
+    /**
+     * @brief Reads the viewport and the viewbox of the SVG file.
+     *
+     * @param svg The root node of the SVG file.
+     */
+    void parseViewPort(rapidxml::xml_node<>* svg);
+
+    /**
+     * @brief Builds the elements of the children of a node, depth first.
+     *
+     * @param group The group receiving the elements.
+     * @param container The node whose children are parsed.
+     * @param parse_defs Whether the <defs> met on the way are read, false
+     * when they were read beforehand.
+     */
+    void parseChildren(Group* group, rapidxml::xml_node<>* container,
+                       bool parse_defs);
+
+    /**
+     * @brief Builds the top-level groups of the document on several threads.
+     *
+     * @param root The root group.
+     * @param svg The root node of the SVG file.
+     */
+    void parseChildrenConcurrently(Group* root, rapidxml::xml_node<>* svg);
+
+    /**
+     * @brief Parses a group and adds it to its parent group.
+     *
+     * @param parent The group containing the node.
+     * @param node The node of the group.
+     * @return The new group, without its children.
+     */
+    Group* parseGroup(Group* parent, rapidxml::xml_node<>* node);
+
+    /**
+     * @brief Gets an attribute of a node.
+     *
+     * @param attributes The attributes of the node.
+     * @param id The attribute to be read.
+     *
+     * @return The value of the attribute, or its default value.
+     */
+    std::string getAttribute(const AttributeTable& attributes, AttributeId id);
+
+    /**
+     * @brief Gets a floating point attribute of a node.
      *
-     * @return The floating point attributes of the node.
+     * @param attributes The attributes of the node.
+     * @param id The attribute to be read.
+     *
+     * @return The value of the attribute, or its default value.
      */
-    float getFloatAttribute(rapidxml::xml_node<>* node, std::string name);
+    float getFloatAttribute(const AttributeTable& attributes, AttributeId id);
 
     /**
      * @brief Gets the gradient stops of a node.
@@ -116,88 +261,149 @@ private:
     std::vector< Stop > getGradientStops(rapidxml::xml_node<>* node);
 
     /**
-     * @brief Gets the gradients of a node.
+     * @brief Registers the gradients of a <defs> node.
      *
      * @param node The node to be parsed.
+     * @note The gradients are only built when a shape uses them, so unused
+     * gradients cost one entry in a table. The other elements of the node
+     * are registered as symbols.
      */
     void GetGradients(rapidxml::xml_node<>* node);
 
     /**
-     * @brief Gets the gradient of a node.
+     * @brief Registers an element that a <use> may draw.
+     *
+     * @param node A <symbol> node or an element of a <defs>, with an id.
+     */
+    void registerSymbol(rapidxml::xml_node<>* node);
+
+    /**
+     * @brief Gets the subtree of a symbol, building it on its first use with
+     * a given style.
+     *
+     * @param id The id of the symbol.
+     * @param style The style inherited by the content of the symbol.
+     * @return The shared subtree, or NULL if no symbol has this id or the
+     * symbol uses itself.
+     */
+    const Group* instantiateSymbol(const std::string& id,
+                                   const ComputedStyle* style);
+
+    /**
+     * @brief Sets the subtrees of the <use> elements added since a given
+     * one.
+     *
+     * @param first The index of the first use to be bound.
+     */
+    void bindSymbolUses(std::size_t first);
+
+    /**
+     * @brief Sets the subtrees of the <use> elements.
      *
-     * @param id The id of the gradient to be parsed.
-     * @return The gradient of the node.
+     * @note Called once the whole document is read, so that a <use> may
+     * reference a symbol defined after it.
      */
-    Gradient* parseGradient(std::string id);
+    void bindSymbols();
+
+    /**
+     * @brief Gets a gradient, building it on its first use.
+     *
+     * @param id The id of the gradient.
+     * @return The gradient, or NULL if no gradient has this id.
+     * @note The xlink:href chain of the gradient is followed once, in any
+     * document order, and cut where it loops back. A gradient without stops
+     * shares the stops of the gradient it references.
+     */
+    Gradient* parseGradient(const std::string& id);
+
+    /**
+     * @brief Builds a gradient from its node.
+     *
+     * @param node The <linearGradient> or <radialGradient> node.
+     * @param base The gradient referenced by the node, or NULL.
+     * @return The gradient, or NULL if the node is of another kind.
+     */
+    Gradient* buildGradient(rapidxml::xml_node<>* node, const Gradient* base);
+
+    /**
+     * @brief Sets the gradients of the shapes filled or stroked with one.
+     *
+     * @note Called once the whole document is read, so that a shape may use a
+     * gradient defined after it.
+     */
+    void bindGradients();
 
     /**
      * @brief Gets the color attributes of a node.
      *
-     * @param node The node to be parsed.
-     * @param color The name of the color tag to be parsed.
+     * @param attributes The attributes of the node.
+     * @param color The color attribute to be parsed.
      * @param id The id to check if the color is a reference.
      * @return The color attributes of the node.
      */
-    ColorShape parseColor(rapidxml::xml_node<>* node, std::string color,
+    ColorShape parseColor(const AttributeTable& attributes, AttributeId color,
                           std::string& id);
 
     /**
      * @brief Gets the points of the element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @return The points of the element
      */
-    std::vector< Vector2Df > parsePoints(rapidxml::xml_node<>* node);
+    std::vector< Vector2Df > parsePoints(const AttributeTable& attributes);
 
     /**
-     * @brief Gets the points of the path element
+     * @brief Sets the geometry of the path element
      *
-     * @param node The node to be parsed.
-     * @return The points of the path element
+     * @param attributes The attributes of the node to be parsed.
+     * @param path The path receiving the commands, vertices and arcs.
      */
-    std::vector< PathPoint > parsePathPoints(rapidxml::xml_node<>* node);
+    void parsePathPoints(const AttributeTable& attributes, Path* path);
 
     /**
-     * @brief Gets the transform order of the element
+     * @brief Resolves the transform list of the element into one matrix
      *
-     * @param node The node to be parsed.
-     * @return The transform order of the element
+     * @param attributes The attributes of the node to be parsed.
+     * @return The transform of the element, or the identity if the list is
+     * missing or invalid
+     * @note Gradients read their gradientTransform attribute instead.
      */
-    std::vector< std::string > getTransformOrder(rapidxml::xml_node<>* node);
+    AffineTransform parseTransform(const AttributeTable& attributes);
 
     /**
      * @brief Parses the line element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The line element
      */
-    Line* parseLine(rapidxml::xml_node<>* node, const ColorShape& stroke_color,
-                    float stroke_width);
+    Line* parseLine(const AttributeTable& attributes,
+                    const ColorShape& stroke_color, float stroke_width);
 
     /**
      * @brief Parses the rect element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The rect element
      */
-    Rect* parseRect(rapidxml::xml_node<>* node, const ColorShape& fill_color,
+    Rect* parseRect(const AttributeTable& attributes,
+                    const ColorShape& fill_color,
                     const ColorShape& stroke_color, float stroke_width);
 
     /**
      * @brief Parses the polyline element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The polyline element
      */
-    class Plyline* parsePolyline(rapidxml::xml_node<>* node,
+    class Plyline* parsePolyline(const AttributeTable& attributes,
                                  const ColorShape& fill_color,
                                  const ColorShape& stroke_color,
                                  float stroke_width);
@@ -205,13 +411,13 @@ private:
     /**
      * @brief Parses the polygon element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The polygon element
      */
-    class Plygon* parsePolygon(rapidxml::xml_node<>* node,
+    class Plygon* parsePolygon(const AttributeTable& attributes,
                                const ColorShape& fill_color,
                                const ColorShape& stroke_color,
                                float stroke_width);
@@ -219,67 +425,126 @@ private:
     /**
      * @brief Parses the circle element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The circle element
      */
-    Circle* parseCircle(rapidxml::xml_node<>* node,
+    Circle* parseCircle(const AttributeTable& attributes,
                         const ColorShape& fill_color,
                         const ColorShape& stroke_color, float stroke_width);
 
     /**
      * @brief Parses the ellipse element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The ellipse element
      */
-    class Ell* parseEllipse(rapidxml::xml_node<>* node,
+    class Ell* parseEllipse(const AttributeTable& attributes,
                             const ColorShape& fill_color,
                             const ColorShape& stroke_color, float stroke_width);
 
     /**
      * @brief Parses the path element
      *
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The path element
      */
-    Path* parsePath(rapidxml::xml_node<>* node, const ColorShape& fill_color,
+    Path* parsePath(const AttributeTable& attributes,
+                    const ColorShape& fill_color,
                     const ColorShape& stroke_color, float stroke_width);
 
     /**
      * @brief Parses the text element
-     * @param node The node to be parsed.
+     * @param attributes The attributes of the node to be parsed.
      * @param fill_color The color of the fill
      * @param stroke_color The color of the stroke
      * @param stroke_width The width of the stroke
      * @return The text element
      */
-    Text* parseText(rapidxml::xml_node<>* node, const ColorShape& fill_color,
+    Text* parseText(const AttributeTable& attributes,
+                    const ColorShape& fill_color,
                     const ColorShape& stroke_color, float stroke_width);
 
+    /**
+     * @brief Parses the use element
+     *
+     * @param attributes The attributes of the node to be parsed.
+     * @return The use element, without its symbol, or NULL if it references
+     * nothing
+     */
+    Use* parseUse(const AttributeTable& attributes);
+
     /**
      * @brief Parses the group of elements
      *
      * @param node The node to be parsed.
+     * @param parent_style The computed style of the group containing the
+     * node.
      * @return The group of elements
      */
-    SVGElement* parseShape(rapidxml::xml_node<>* node);
+    SVGElement* parseShape(rapidxml::xml_node<>* node,
+                           const ComputedStyle* parent_style);
 
 private:
-    static Parser* instance;  ///< The instance of the Parser.
-    SVGElement* root;         ///< The root of the SVG file.
+    class StreamHandler;  ///< Builds the tree from the events of a stream.
+
+    /**
+     * @brief A gradient of a <defs> that is not built yet.
+     */
+    struct GradientNode {
+        rapidxml::xml_node<>* node;  ///< The node of the gradient
+        bool visiting;               ///< Whether its chain is being followed
+    };
+
+    /**
+     * @brief A subtree built for the instances of a symbol with one style.
+     */
+    struct SymbolInstance {
+        const ComputedStyle* style;  ///< Inherited style
+        const Group* tree;           ///< Shared subtree
+    };
+
+    /**
+     * @brief A symbol, with the subtrees built for its instances.
+     */
+    struct SymbolNode {
+        rapidxml::xml_node<>* node;  ///< The node of the symbol
+        bool visiting;               ///< Whether its subtree is being built
+        std::vector< SymbolInstance > instances;  ///< Subtrees by style
+    };
+
+    SceneArena arena;  ///< The memory of the tree of the SVG file.
+    SVGElement* root;  ///< The root of the SVG file.
+    SceneStore store;  ///< The flattened tree of the SVG file.
+    SceneBVH bvh;      ///< The hierarchy of the bounds of the store.
     std::map< std::string, Gradient* > gradients;  ///< The gradients of the SVG
                                                    ///< file.
-    ViewBox viewbox;     ///< The viewbox of the SVG file.
-    Vector2Df viewport;  ///< The viewport of the SVG file.
+    std::unordered_map< std::string, GradientNode >
+        gradient_nodes;  ///< The gradients not built yet, by id.
+    std::vector< std::pair< SVGElement*, std::string > >
+        gradient_uses;          ///< The shapes using a gradient, with its id.
+    std::unordered_map< std::string, SymbolNode >
+        symbol_nodes;  ///< The symbols, by id.
+    std::vector< std::pair< Use*, std::string > >
+        symbol_uses;            ///< The <use> elements, with their symbol id.
+    std::mutex uses_mutex;      ///< Guards the uses of gradients and symbols.
+    StopPool stop_pool;         ///< The distinct stop lists of the gradients.
+    StyleSheet style_sheet;     ///< The rules of the <style> elements.
+    ViewBox viewbox;            ///< The viewbox of the SVG file.
+    Vector2Df viewport;         ///< The viewport of the SVG file.
+    LoadMode load_mode;         ///< The way the SVG file is loaded into memory.
+    unsigned int thread_count;  ///< Threads building the top-level groups.
+    std::string cache_file;     ///< The scene cache of the file, if any.
+    LoadStats load_stats;       ///< The statistics about the loading of the
+                                ///< file.
 };
 
 #endif  // PARSER_HPP_
\ No newline at end of file
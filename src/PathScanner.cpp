@@ -0,0 +1,107 @@
+#include "PathScanner.hpp"
+
+#include "NumberScanner.hpp"
+
+namespace {
+    // Whitespace characters allowed by the path data grammar
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+}  // namespace
+
+PathScanner::PathScanner(const char* begin, const char* end)
+    : cursor(begin), end(end), previous(0), error(false) {}
+
+int PathScanner::getArgumentCount(char type) {
+    switch (type) {
+        case 'Z':
+        case 'z':
+            return 0;
+        case 'H':
+        case 'h':
+        case 'V':
+        case 'v':
+            return 1;
+        case 'M':
+        case 'm':
+        case 'L':
+        case 'l':
+        case 'T':
+        case 't':
+            return 2;
+        case 'S':
+        case 's':
+        case 'Q':
+        case 'q':
+            return 4;
+        case 'C':
+        case 'c':
+            return 6;
+        case 'A':
+        case 'a':
+            return 7;
+        default:
+            return -1;
+    }
+}
+
+bool PathScanner::failed() const { return error; }
+
+void PathScanner::skipSeparators() {
+    while (cursor != end && isWhitespace(*cursor)) ++cursor;
+    if (cursor != end && *cursor == ',') {
+        ++cursor;
+        while (cursor != end && isWhitespace(*cursor)) ++cursor;
+    }
+}
+
+bool PathScanner::scanNumber(float& value) {
+    return NumberScanner::scan(cursor, end, value);
+}
+
+bool PathScanner::scanFlag(float& value) {
+    if (cursor == end || (*cursor != '0' && *cursor != '1')) return false;
+    value = *cursor == '1' ? 1.f : 0.f;
+    ++cursor;
+    return true;
+}
+
+bool PathScanner::next(PathCommand& command) {
+    if (error) return false;
+    skipSeparators();
+    if (cursor == end) return false;
+
+    char type;
+    if (getArgumentCount(*cursor) >= 0) {
+        type = *cursor++;
+    } else if (previous != 0 && previous != 'z' && previous != 'Z') {
+        // A number right after an argument group repeats the last command
+        type = previous;
+    } else {
+        error = true;
+        return false;
+    }
+
+    command.type = type;
+    command.count = getArgumentCount(type);
+    bool is_arc = type == 'a' || type == 'A';
+    for (int i = 0; i < command.count; ++i) {
+        skipSeparators();
+        bool scanned = is_arc && (i == 3 || i == 4)
+                           ? scanFlag(command.args[i])
+                           : scanNumber(command.args[i]);
+        if (!scanned) {
+            error = true;
+            return false;
+        }
+    }
+
+    // Extra coordinate pairs after a moveto are treated as lineto commands
+    if (type == 'M')
+        previous = 'L';
+    else if (type == 'm')
+        previous = 'l';
+    else
+        previous = type;
+    return true;
+}
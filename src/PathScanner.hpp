@@ -0,0 +1,91 @@
+#ifndef PATH_SCANNER_HPP_
+#define PATH_SCANNER_HPP_
+
+/**
+ * @brief A single drawing command read from the path data.
+ *
+ * The arguments are stored exactly as they are written in the path data, so
+ * relative commands still hold relative coordinates.
+ */
+struct PathCommand {
+    char type;      ///< Command letter, lowercase for relative commands
+    float args[7];  ///< Arguments of the command
+    int count;      ///< Number of arguments used by the command
+};
+
+/**
+ * @brief Single-pass tokenizer for the SVG path data ("d" attribute).
+ *
+ * The PathScanner walks the raw character buffer once and emits one
+ * PathCommand per argument group, without allocating or copying the buffer.
+ * It supports the whole path data grammar: implicit command repeats
+ * ("L 1 2 3 4" is two line commands, "M 1 2 3 4" is a move followed by a
+ * line), numbers packed without separators ("1.5.5", "1-2"), exponents
+ * ("1e-3") and packed arc flags ("a1 1 0 01 5 5").
+ *
+ * @note The scanner stops at the first malformed token, as required by the
+ * SVG error handling rules. Everything read before the error is kept.
+ */
+class PathScanner {
+public:
+    /**
+     * @brief Constructs a scanner over a character buffer.
+     *
+     * @param begin The first character of the path data.
+     * @param end One past the last character of the path data.
+     */
+    PathScanner(const char* begin, const char* end);
+
+    /**
+     * @brief Reads the next command of the path data.
+     *
+     * @param command The command to be filled.
+     * @return True if a command was read, false at the end of the data or on
+     * a malformed token.
+     */
+    bool next(PathCommand& command);
+
+    /**
+     * @brief Checks whether the scanner stopped on a malformed token.
+     *
+     * @return True if the path data contains an error.
+     */
+    bool failed() const;
+
+    /**
+     * @brief Gets the number of arguments taken by a command.
+     *
+     * @param type The command letter.
+     * @return The number of arguments, or -1 if the letter is not a command.
+     */
+    static int getArgumentCount(char type);
+
+private:
+    /**
+     * @brief Skips whitespaces and at most one comma.
+     */
+    void skipSeparators();
+
+    /**
+     * @brief Reads a number at the cursor.
+     *
+     * @param value The number that was read.
+     * @return True if a number was read.
+     */
+    bool scanNumber(float& value);
+
+    /**
+     * @brief Reads an arc flag, which is a single '0' or '1' character.
+     *
+     * @param value The flag that was read.
+     * @return True if a flag was read.
+     */
+    bool scanFlag(float& value);
+
+    const char* cursor;  ///< Current position in the path data
+    const char* end;     ///< End of the path data
+    char previous;       ///< Previous command, used for implicit repeats
+    bool error;          ///< Whether a malformed token was met
+};
+
+#endif  // PATH_SCANNER_HPP_
@@ -4,9 +4,21 @@
 #include <codecvt>
 #include <locale>
 
+namespace {
+    // Largest distance between a path and the lines drawing it, in pixels
+    constexpr float kFlatTolerance = 0.2f;
+
+    // Converted ramps held before those of closed documents are dropped
+    constexpr std::size_t kMinRamps = 256;
+
+    Gdiplus::Color toColor(const ColorShape& color) {
+        return Gdiplus::Color(color.a, color.r, color.g, color.b);
+    }
+}  // namespace
+
 Renderer* Renderer::instance = nullptr;
 
-Renderer::Renderer() {}
+Renderer::Renderer() : ramp_limit(kMinRamps) {}
 
 Renderer* Renderer::getInstance() {
     if (instance == nullptr) {
@@ -15,109 +27,149 @@ Renderer* Renderer::getInstance() {
     return instance;
 }
 
-// Function to extract translation values from a transform string
-std::pair< float, float > getTranslate(std::string transform_value) {
-    float trans_x = 0, trans_y = 0;
-    if (transform_value.find(",") != std::string::npos) {
-        sscanf(transform_value.c_str(), "translate(%f, %f)", &trans_x,
-               &trans_y);
-    } else {
-        sscanf(transform_value.c_str(), "translate(%f %f)", &trans_x, &trans_y);
-    }
-    return std::pair< float, float >(trans_x, trans_y);
-}
-
-// Function to extract rotation value from a transform string
-float getRotate(std::string transform_value) {
-    float degree = 0;
-    sscanf(transform_value.c_str(), "rotate(%f)", &degree);
-    return degree;
-}
-
-// Function to extract scale value from a transform string
-float getScale(std::string transform_value) {
-    float scale = 0;
-    sscanf(transform_value.c_str(), "scale(%f)", &scale);
-    return scale;
-}
-
-// Function to extract X and Y scale values from a transform string
-std::pair< float, float > getScaleXY(std::string transform_value) {
-    float scale_x = 0, scale_y = 0;
-    if (transform_value.find(",") != std::string::npos)
-        sscanf(transform_value.c_str(), "scale(%f, %f)", &scale_x, &scale_y);
-    else
-        sscanf(transform_value.c_str(), "scale(%f %f)", &scale_x, &scale_y);
-    return std::pair< float, float >(scale_x, scale_y);
-}
-
-// Apply transformations based on the specified order
-void Renderer::applyTransform(std::vector< std::string > transform_order,
+// Apply the transformation matrix of an element
+void Renderer::applyTransform(const AffineTransform& transform,
                               Gdiplus::Graphics& graphics) const {
-    for (auto type : transform_order) {
-        if (type.find("translate") != std::string::npos) {
-            float trans_x = getTranslate(type).first,
-                  trans_y = getTranslate(type).second;
-            graphics.TranslateTransform(trans_x, trans_y);
-        } else if (type.find("rotate") != std::string::npos) {
-            float degree = getRotate(type);
-            graphics.RotateTransform(degree);
-        } else if (type.find("scale") != std::string::npos) {
-            if (type.find(",") != std::string::npos) {
-                float scale_x = getScaleXY(type).first,
-                      scale_y = getScaleXY(type).second;
-                graphics.ScaleTransform(scale_x, scale_y);
-            } else {
-                float scale = getScale(type);
-                graphics.ScaleTransform(scale, scale);
-            }
-        }
-    }
+    if (transform.isIdentity()) return;
+    Gdiplus::Matrix matrix(transform.a, transform.b, transform.c, transform.d,
+                           transform.e, transform.f);
+    graphics.MultiplyTransform(&matrix);
 }
 
 // Draw shapes within a group, considering transformations
-void Renderer::draw(Gdiplus::Graphics& graphics, Group* group) const {
+void Renderer::draw(Gdiplus::Graphics& graphics, const Group* group) const {
     for (auto shape : group->getElements()) {
         // Store the original transformation matrix
         Gdiplus::Matrix original;
         graphics.GetTransform(&original);
 
         // Apply the transformations for the current shape
-        applyTransform(shape->getTransforms(), graphics);
-
-        // Draw the specific shape based on its class
-        if (shape->getClass() == "Group") {
-            Group* group = dynamic_cast< Group* >(shape);
-            draw(graphics, group);
-        } else if (shape->getClass() == "Polyline") {
-            Plyline* polyline = dynamic_cast< Plyline* >(shape);
-            drawPolyline(graphics, polyline);
-        } else if (shape->getClass() == "Text") {
-            Text* text = dynamic_cast< Text* >(shape);
-            drawText(graphics, text);
-        } else if (shape->getClass() == "Rect") {
-            Rect* rectangle = dynamic_cast< Rect* >(shape);
-            drawRectangle(graphics, rectangle);
-        } else if (shape->getClass() == "Circle") {
-            Circle* circle = dynamic_cast< Circle* >(shape);
-            drawCircle(graphics, circle);
-        } else if (shape->getClass() == "Ellipse") {
-            Ell* ellipse = dynamic_cast< Ell* >(shape);
-            drawEllipse(graphics, ellipse);
-        } else if (shape->getClass() == "Line") {
-            Line* line = dynamic_cast< Line* >(shape);
-            drawLine(graphics, line);
-        } else if (shape->getClass() == "Polygon") {
-            Plygon* polygon = dynamic_cast< Plygon* >(shape);
-            drawPolygon(graphics, polygon);
-        } else if (shape->getClass() == "Path") {
-            Path* path = dynamic_cast< Path* >(shape);
-            drawPath(graphics, path);
+        applyTransform(shape->getTransform(), graphics);
+
+        // Draw the specific shape based on its kind
+        switch (shape->getKind()) {
+            case ElementKind::Group:
+                draw(graphics, static_cast< Group* >(shape));
+                break;
+            case ElementKind::Use: {
+                // The subtree is shared by the instances, only the transform
+                // of the instance differs
+                const Use* use = static_cast< const Use* >(shape);
+                if (use->getSymbol() != NULL) draw(graphics, use->getSymbol());
+                break;
+            }
+            default:
+                drawShape(graphics, shape);
+                break;
         }
         graphics.SetTransform(&original);
     }
 }
 
+// Draw the shapes of a flattened scene, in paint order
+void Renderer::draw(Gdiplus::Graphics& graphics,
+                    const SceneStore& store) const {
+    if (store.size() == 0) return;
+    Gdiplus::Matrix original;
+    graphics.GetTransform(&original);
+    std::span< const ElementKind > kinds = store.getKinds();
+    std::span< const std::uint32_t > ends = store.getEnds();
+
+    // Each frame walks the tree or the subtree of a symbol for one instance
+    struct Frame {
+        std::uint32_t next;      // Next element to draw
+        std::uint32_t end;       // End of the subtree
+        AffineTransform matrix;  // Matrix of the instance
+    };
+    std::vector< Frame > stack = {{1, ends[0], AffineTransform()}};
+    AffineTransform current;
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (frame.next == frame.end) {
+            stack.pop_back();
+            continue;
+        }
+        std::uint32_t i = frame.next++;
+        // Groups only carry the matrices of their subtrees, and uses draw
+        // the subtree of their symbol through theirs
+        if (kinds[i] == ElementKind::Group) continue;
+        AffineTransform world = frame.matrix * store.getMatrix(i);
+        if (kinds[i] == ElementKind::Use) {
+            std::uint32_t symbol = store.getSymbol(i);
+            if (symbol != SceneStore::kNone)
+                stack.push_back({symbol + 1, ends[symbol], world});
+            continue;
+        }
+
+        // The transform is only set again when the world matrix changes
+        if (world != current) {
+            graphics.SetTransform(&original);
+            applyTransform(world, graphics);
+            current = world;
+        }
+        drawShape(graphics, store.getElement(i));
+    }
+    graphics.SetTransform(&original);
+}
+
+// Draw the shapes of a flattened scene that overlap the visible area
+void Renderer::draw(Gdiplus::Graphics& graphics, const SceneStore& store,
+                    const SceneBVH& bvh, const BoundingBox& visible) const {
+    visible_shapes.clear();
+    bvh.query(visible, visible_shapes);
+    frame_stats.drawn = visible_shapes.size();
+    frame_stats.culled = store.getShapeCount() - visible_shapes.size();
+
+    Gdiplus::Matrix original;
+    graphics.GetTransform(&original);
+    AffineTransform current;
+    for (const StoreShape& shape : visible_shapes) {
+        // The transform is only set again when the world matrix changes
+        if (shape.matrix != current) {
+            graphics.SetTransform(&original);
+            applyTransform(shape.matrix, graphics);
+            current = shape.matrix;
+        }
+        drawShape(graphics, store.getElement(shape.index));
+    }
+    graphics.SetTransform(&original);
+}
+
+const FrameStats& Renderer::getFrameStats() const { return frame_stats; }
+
+// Draw a shape based on its kind
+void Renderer::drawShape(Gdiplus::Graphics& graphics,
+                         SVGElement* shape) const {
+    switch (shape->getKind()) {
+        case ElementKind::Polyline:
+            drawPolyline(graphics, static_cast< Plyline* >(shape));
+            break;
+        case ElementKind::Text:
+            drawText(graphics, static_cast< Text* >(shape));
+            break;
+        case ElementKind::Rect:
+            drawRectangle(graphics, static_cast< Rect* >(shape));
+            break;
+        case ElementKind::Circle:
+            drawCircle(graphics, static_cast< Circle* >(shape));
+            break;
+        case ElementKind::Ellipse:
+            drawEllipse(graphics, static_cast< Ell* >(shape));
+            break;
+        case ElementKind::Line:
+            drawLine(graphics, static_cast< Line* >(shape));
+            break;
+        case ElementKind::Polygon:
+            drawPolygon(graphics, static_cast< Plygon* >(shape));
+            break;
+        case ElementKind::Path:
+            drawPath(graphics, static_cast< Path* >(shape));
+            break;
+        default:
+            break;
+    }
+}
+
 // Draw a line on the given graphics context
 void Renderer::drawLine(Gdiplus::Graphics& graphics, Line* line) const {
     // Extract color and thickness information from the Line object
@@ -277,16 +329,16 @@ void Renderer::drawPolygon(Gdiplus::Graphics& graphics, Plygon* polygon) const {
     // Extract vertices and create an array of Gdiplus::PointF
     Gdiplus::PointF* points = new Gdiplus::PointF[polygon->getPoints().size()];
     int idx = 0;
-    const std::vector< Vector2Df >& vertices = polygon->getPoints();
+    const std::pmr::vector< Vector2Df >& vertices = polygon->getPoints();
     for (const Vector2Df vertex : vertices) {
         points[idx++] = Gdiplus::PointF(vertex.x, vertex.y);
     }
 
     // Determine the fill mode based on the polygon's fill rule
     Gdiplus::FillMode fill_mode;
-    if (polygon->getFillRule() == "evenodd") {
+    if (polygon->getFillRule() == FillRule::EvenOdd) {
         fill_mode = Gdiplus::FillModeAlternate;
-    } else if (polygon->getFillRule() == "nonzero") {
+    } else {
         fill_mode = Gdiplus::FillModeWinding;
     }
 
@@ -336,10 +388,10 @@ void Renderer::drawText(Gdiplus::Graphics& graphics, Text* text) const {
 
     // Set text alignment based on anchor position
     Gdiplus::StringFormat string_format;
-    if (text->getAnchor() == "middle") {
+    if (text->getAnchor() == TextAnchor::Middle) {
         string_format.SetAlignment(Gdiplus::StringAlignmentCenter);
         position.X += 7;
-    } else if (text->getAnchor() == "end") {
+    } else if (text->getAnchor() == TextAnchor::End) {
         string_format.SetAlignment(Gdiplus::StringAlignmentFar);
         position.X += 14;
     } else {
@@ -348,7 +400,7 @@ void Renderer::drawText(Gdiplus::Graphics& graphics, Text* text) const {
 
     // Set font style based on text style
     Gdiplus::FontStyle font_style = Gdiplus::FontStyleRegular;
-    if (text->getFontStyle() == "italic" || text->getFontStyle() == "oblique") {
+    if (text->getFontStyle() != FontStyle::Normal) {
         font_style = Gdiplus::FontStyleItalic;
         position.Y -= 1;
     }
@@ -392,14 +444,14 @@ void Renderer::drawPolyline(Gdiplus::Graphics& graphics,
 
     // Determine the fill mode based on the polyline's fill rule
     Gdiplus::FillMode fill_mode;
-    if (polyline->getFillRule() == "evenodd") {
+    if (polyline->getFillRule() == FillRule::EvenOdd) {
         fill_mode = Gdiplus::FillModeAlternate;
-    } else if (polyline->getFillRule() == "nonzero") {
+    } else {
         fill_mode = Gdiplus::FillModeWinding;
     }
 
     Gdiplus::GraphicsPath path(fill_mode);
-    const std::vector< Vector2Df >& points = polyline->getPoints();
+    const std::pmr::vector< Vector2Df >& points = polyline->getPoints();
     if (points.size() < 2) {
         return;
     }
@@ -443,199 +495,43 @@ void Renderer::drawPath(Gdiplus::Graphics& graphics, Path* path) const {
 
     // Fill the path by rules
     Gdiplus::FillMode fill_mode;
-    if (path->getFillRule() == "evenodd") {
+    if (path->getFillRule() == FillRule::EvenOdd) {
         fill_mode = Gdiplus::FillModeAlternate;
-    } else if (path->getFillRule() == "nonzero") {
+    } else {
         fill_mode = Gdiplus::FillModeWinding;
     }
     Gdiplus::GraphicsPath gdi_path(fill_mode);
 
-    const std::vector< PathPoint >& points = path->getPoints();
-    int n = points.size();
-    Vector2Df first_point{0, 0}, cur_point{0, 0};
+    // The path is flattened to a fraction of a pixel at the current scale,
+    // the flattening being cached by the path across frames
+    Gdiplus::Matrix world;
+    graphics.GetTransform(&world);
+    Gdiplus::REAL elements[6];
+    world.GetElements(elements);
+    float scale = AffineTransform(elements[0], elements[1], elements[2],
+                                  elements[3], elements[4], elements[5])
+                      .getMaxScale();
+    if (scale == 0) return;
+    const FlatPath& flat = path->getFlatPath(kFlatTolerance / scale);
 
     // Construct the path
-    for (int i = 0; i < n; ++i) {
-        if (points[i].tc == 'm') {
-            // If the command is m, then start a new figure
-            first_point = points[i].point;
-            gdi_path.StartFigure();
-            cur_point = first_point;
-        } else if (points[i].tc == 'l' || points[i].tc == 'h' ||
-                   points[i].tc == 'v') {
-            // If the command is l, h, or v, then add a line to the path
-            gdi_path.AddLine(cur_point.x, cur_point.y, points[i].point.x,
-                             points[i].point.y);
-            cur_point = points[i].point;
-        } else if (points[i].tc == 'c') {
-            // If the command is c, then add a bezier curve to the path
-            if (i + 2 < n) {
-                Vector2Df control_point1 = points[i].point;
-                Vector2Df control_point2 = points[i + 1].point;
-                Vector2Df control_point3 = points[i + 2].point;
-                gdi_path.AddBezier(cur_point.x, cur_point.y, control_point1.x,
-                                   control_point1.y, control_point2.x,
-                                   control_point2.y, control_point3.x,
-                                   control_point3.y);
-                i += 2;
-                cur_point = control_point3;
-            }
-        } else if (points[i].tc == 'z') {
-            // If the command is z, then close the figure
-            gdi_path.CloseFigure();
-            cur_point = first_point;
-        } else if (points[i].tc == 's') {
-            // If the command is s, then add a bezier curve to the path
-            if (i + 1 < n) {
-                // Calculate the first control point
-                Vector2Df auto_control_point;
-                if (i > 0 &&
-                    (points[i - 1].tc == 'c' || points[i - 1].tc == 's')) {
-                    auto_control_point.x =
-                        cur_point.x * 2 - points[i - 2].point.x;
-                    auto_control_point.y =
-                        cur_point.y * 2 - points[i - 2].point.y;
-                } else {
-                    auto_control_point = cur_point;
-                }
-                // Calculate the rest control points
-                Vector2Df control_point2 = points[i].point;
-                Vector2Df control_point3 = points[i + 1].point;
-                gdi_path.AddBezier(cur_point.x, cur_point.y,
-                                   auto_control_point.x, auto_control_point.y,
-                                   control_point2.x, control_point2.y,
-                                   control_point3.x, control_point3.y);
-                i += 1;
-                cur_point = control_point3;
-            }
-        } else if (points[i].tc == 'q') {
-            // If the command is q, then add a quadratic bezier curve to the
-            if (i + 1 < n) {
-                // Calculate the control point and its end point
-                Vector2Df control_point = points[i].point;
-                Vector2Df end_point = points[i + 1].point;
-
-                // Add the curve to the path
-                Gdiplus::PointF q_points[3];
-                q_points[0] = Gdiplus::PointF{cur_point.x, cur_point.y};
-                q_points[1] = Gdiplus::PointF{control_point.x, control_point.y};
-                q_points[2] = Gdiplus::PointF{end_point.x, end_point.y};
-                gdi_path.AddCurve(q_points, 3);
-                cur_point = points[i + 1].point;
-                i += 1;
-            }
-        } else if (points[i].tc == 't') {
-            // Calculate reflection control point
-            Vector2Df auto_control_point;
-            if (i > 0 && (points[i - 1].tc == 'q' || points[i - 1].tc == 't')) {
-                // If the previous point is a quadratic bezier or a smooth
-                // quadratic bezier,
-                // calculate the reflection control point using the reflection
-                // formula
-                auto_control_point.x = cur_point.x * 2 - points[i - 2].point.x;
-                auto_control_point.y = cur_point.y * 2 - points[i - 2].point.y;
-            } else {
-                // Otherwise, use the current point as the control point
-                auto_control_point = cur_point;
-            }
-            Vector2Df end_point = points[i].point;
-            Gdiplus::PointF t_points[3];
-            t_points[0] = Gdiplus::PointF{cur_point.x, cur_point.y};
-            t_points[1] =
-                Gdiplus::PointF{auto_control_point.x, auto_control_point.y};
-            t_points[2] = Gdiplus::PointF{end_point.x, end_point.y};
-            // Add the cubic bezier curve to the path
-            gdi_path.AddCurve(t_points, 3);
-            cur_point = points[i].point;
-        } else if (points[i].tc == 'a') {
-            float rx = points[i].radius.x;
-            float ry = points[i].radius.y;
-            // If either radius is zero, treat it as a line segment
-            if (rx == 0 || ry == 0) {
-                gdi_path.AddLine(cur_point.x, cur_point.y, points[i].point.x,
-                                 points[i].point.y);
-                cur_point = points[i].point;
-                continue;
-            }
-            if (rx < 0) {
-                rx = std::fabs(rx);
-            }
-            if (ry < 0) {
-                ry = std::fabs(ry);
-            }
-
-            float x_axis_rotation = points[i].x_axis_rotation;
-            bool large_arc_flag = points[i].large_arc_flag;
-            bool sweep_flag = points[i].sweep_flag;
-            Vector2Df end_point{points[i].point.x, points[i].point.y};
-            // Calculate angles and points for the elliptical arc
-            float angle = x_axis_rotation * acos(-1) / 180.0;
-            float cosAngle = cos(angle);
-            float sinAngle = sin(angle);
-
-            Vector2Df point1;
-            float X = (cur_point.x - end_point.x) / 2.0;
-            float Y = (cur_point.y - end_point.y) / 2.0;
-            point1.x = (cosAngle * cosAngle + sinAngle * sinAngle) * X;
-            point1.y = (cosAngle * cosAngle + sinAngle * sinAngle) * Y;
-            // Correction of out-of-range radii
-            float radii_check = (point1.x * point1.x) / (rx * rx) +
-                                (point1.y * point1.y) / (ry * ry);
-            if (radii_check > 1.0) {
-                rx = std::sqrt(radii_check) * rx;
-                ry = std::sqrt(radii_check) * ry;
-            }
-
-            float sign = (large_arc_flag == sweep_flag ? -1.0 : 1.0);
-            Vector2Df point2;
-            float numo = (rx * rx) * (ry * ry) -
-                         (rx * rx) * (point1.y * point1.y) -
-                         (ry * ry) * (point1.x * point1.x);
-            float deno = (rx * rx) * (point1.y * point1.y) +
-                         (ry * ry) * (point1.x * point1.x);
-
-            if (numo < 0) {
-                numo = std::fabs(numo);
-            }
-
-            point2.x = sign * std::sqrt(numo / deno) * ((rx * point1.y) / ry);
-            point2.y = sign * std::sqrt(numo / deno) * ((-ry * point1.x) / rx);
-
-            Vector2Df center;
-            X = (cur_point.x + end_point.x) / 2.0;
-            Y = (cur_point.y + end_point.y) / 2.0;
-            center.x =
-                (cosAngle * cosAngle + sinAngle * sinAngle) * point2.x + X;
-            center.y =
-                (cosAngle * cosAngle + sinAngle * sinAngle) * point2.y + Y;
-
-            float start_angle =
-                atan2((point1.y - point2.y) / ry, (point1.x - point2.x) / rx);
-            float end_angle =
-                atan2((-point1.y - point2.y) / ry, (-point1.x - point2.x) / rx);
-
-            float delta_angle = end_angle - start_angle;
-
-            if (sweep_flag && delta_angle < 0) {
-                delta_angle += 2.0 * acos(-1);
-            } else if (!sweep_flag && delta_angle > 0) {
-                delta_angle -= 2.0 * acos(-1);
-            }
-
-            float start_angle_degree =
-                std::fmod((start_angle * 180.0) / acos(-1), 360);
-            float delta_angle_degree =
-                std::fmod((delta_angle * 180.0) / acos(-1), 360);
-            // Add the elliptical arc to the path
-            gdi_path.AddArc(center.x - rx, center.y - ry, 2.0 * rx, 2.0 * ry,
-                            start_angle_degree, delta_angle_degree);
-
-            cur_point = end_point;
+    for (const FlatFigure& figure : flat.figures) {
+        flat_points.clear();
+        for (std::uint32_t i = figure.first; i < figure.first + figure.count;
+             ++i) {
+            const Vector2Df& point = flat.points[i];
+            flat_points.push_back(Gdiplus::PointF(point.x, point.y));
         }
+        gdi_path.StartFigure();
+        gdi_path.AddLines(flat_points.data(), flat_points.size());
+        if (figure.closed) gdi_path.CloseFigure();
     }
 
-    Gdiplus::RectF bound;
-    gdi_path.GetBounds(&bound);
+    // Create a bounding rectangle for the path from its cached bounds
+    Vector2Df min_bound = path->getMinBound();
+    Vector2Df max_bound = path->getMaxBound();
+    Gdiplus::RectF bound(min_bound.x, min_bound.y, max_bound.x - min_bound.x,
+                         max_bound.y - min_bound.y);
     Gdiplus::Brush* path_fill = getBrush(path, bound);
     Gdiplus::Region region(&gdi_path);
 
@@ -645,7 +541,7 @@ void Renderer::drawPath(Gdiplus::Graphics& graphics, Path* path) const {
         Gdiplus::SolidBrush corner_fill(
             Gdiplus::Color(color.a, color.r, color.g, color.b));
 
-        if (path->getGradient()->getUnits() == "userSpaceOnUse") {
+        if (path->getGradient()->getUnits() == GradientUnits::UserSpaceOnUse) {
             float cx = path->getGradient()->getPoints().first.x;
             float cy = path->getGradient()->getPoints().first.y;
             float r = dynamic_cast< RadialGradient* >(path->getGradient())
@@ -654,19 +550,11 @@ void Renderer::drawPath(Gdiplus::Graphics& graphics, Path* path) const {
             Gdiplus::GraphicsPath fill_path(fill_mode);
             fill_path.AddEllipse(cx - r, cy - r, 2 * r, 2 * r);
 
-            for (auto type : path->getGradient()->getTransforms()) {
-                if (type.find("matrix") != std::string::npos) {
-                    float a = 0, b = 0, c = 0, d = 0, e = 0, f = 0;
-                    if (type.find(",") != std::string::npos) {
-                        type.erase(std::remove(type.begin(), type.end(), ','),
-                                   type.end());
-                    }
-                    sscanf(type.c_str(), "matrix(%f %f %f %f %f %f)", &a, &b,
-                           &c, &d, &e, &f);
-                    Gdiplus::Matrix matrix(a, b, c, d, e, f);
-                    fill_path.Transform(&matrix);
-                }
-            }
+            const AffineTransform& transform =
+                path->getGradient()->getTransform();
+            Gdiplus::Matrix matrix(transform.a, transform.b, transform.c,
+                                   transform.d, transform.e, transform.f);
+            fill_path.Transform(&matrix);
             region.Exclude(&fill_path);
         }
         graphics.FillRegion(&corner_fill, &region);
@@ -684,62 +572,40 @@ Gdiplus::Brush* Renderer::getBrush(SVGElement* shape,
                                    Gdiplus::RectF bound) const {
     Gradient* gradient = shape->getGradient();
     if (gradient != NULL) {
+        // Only the geometry of the brush depends on the shape, the colors
+        // are converted once per ramp
         std::pair< Vector2Df, Vector2Df > points = gradient->getPoints();
-        std::vector< Stop > stops = gradient->getStops();
-        int stop_size = stops.size() + 2;
-        Gdiplus::Color* colors = new Gdiplus::Color[stop_size];
-        float* offsets = new float[stop_size];
+        const RampColors& ramp = getRampColors(gradient->getSharedStops());
 
-        if (gradient->getClass() == "LinearGradient") {
+        if (gradient->getKind() == GradientKind::Linear) {
             // Brush linear gradient
-            if (gradient->getUnits() == "objectBoundingBox") {
+            if (gradient->getUnits() == GradientUnits::ObjectBoundingBox) {
                 points.first.x = bound.X;
                 points.first.y = bound.Y;
                 points.second.x = bound.X + bound.Width;
                 points.second.y = bound.Y + bound.Height;
             }
 
-            // Set the center color
-            offsets[0] = 0;
-            offsets[stop_size - 1] = 1;
-            colors[0] =
-                Gdiplus::Color(stops[0].getColor().a, stops[0].getColor().r,
-                               stops[0].getColor().g, stops[0].getColor().b);
-            colors[stop_size - 1] =
-                Gdiplus::Color(stops[stop_size - 3].getColor().a,
-                               stops[stop_size - 3].getColor().r,
-                               stops[stop_size - 3].getColor().g,
-                               stops[stop_size - 3].getColor().b);
-
-            // Reverse the order of the stops
-            for (size_t i = 1; i < stop_size - 1; ++i) {
-                colors[i] = Gdiplus::Color(
-                    stops[i - 1].getColor().a, stops[i - 1].getColor().r,
-                    stops[i - 1].getColor().g, stops[i - 1].getColor().b);
-                offsets[i] = stops[i - 1].getOffset();
-            }
-
             // Create the brush of linear gradient
             Gdiplus::LinearGradientBrush* fill =
                 new Gdiplus::LinearGradientBrush(
                     Gdiplus::PointF(points.first.x, points.first.y),
                     Gdiplus::PointF(points.second.x, points.second.y),
-                    colors[0], colors[stop_size - 1]);
+                    ramp.linear_colors.front(), ramp.linear_colors.back());
             fill->SetWrapMode(Gdiplus::WrapModeTileFlipX);
-            fill->SetInterpolationColors(colors, offsets, stop_size);
-            applyTransformsOnBrush(gradient->getTransforms(), fill);
-
-            delete[] colors;
-            delete[] offsets;
+            fill->SetInterpolationColors(ramp.linear_colors.data(),
+                                         ramp.linear_offsets.data(),
+                                         ramp.linear_colors.size());
+            applyTransformsOnBrush(gradient->getTransform(), fill);
             return fill;
-        } else if (gradient->getClass() == "RadialGradient") {
+        } else if (gradient->getKind() == GradientKind::Radial) {
             // Brush radiol gradient
             RadialGradient* radial_gradient =
-                dynamic_cast< RadialGradient* >(gradient);
+                static_cast< RadialGradient* >(gradient);
             Vector2Df radius = radial_gradient->getRadius();
 
             // If the gradient is in userSpaceOnUse, the radius is the distance
-            if (gradient->getUnits() == "userSpaceOnUse") {
+            if (gradient->getUnits() == GradientUnits::UserSpaceOnUse) {
                 bound.X = points.first.x - radius.x;
                 bound.Y = points.first.y - radius.x;
                 bound.Width = radius.x * 2;
@@ -750,32 +616,10 @@ Gdiplus::Brush* Renderer::getBrush(SVGElement* shape,
             path.AddEllipse(bound);
             Gdiplus::PathGradientBrush* fill =
                 new Gdiplus::PathGradientBrush(&path);
-
-            // Set the center color
-            offsets[0] = 0;
-            offsets[stop_size - 1] = 1;
-            colors[0] = Gdiplus::Color(stops[stop_size - 3].getColor().a,
-                                       stops[stop_size - 3].getColor().r,
-                                       stops[stop_size - 3].getColor().g,
-                                       stops[stop_size - 3].getColor().b);
-            colors[stop_size - 1] =
-                Gdiplus::Color(stops[0].getColor().a, stops[0].getColor().r,
-                               stops[0].getColor().g, stops[0].getColor().b);
-
-            // Reverse the order of the stops
-            for (size_t i = 1; i < stop_size - 1; ++i) {
-                colors[i] =
-                    Gdiplus::Color(stops[stop_size - 2 - i].getColor().a,
-                                   stops[stop_size - 2 - i].getColor().r,
-                                   stops[stop_size - 2 - i].getColor().g,
-                                   stops[stop_size - 2 - i].getColor().b);
-                offsets[i] = 1 - stops[stop_size - 2 - i].getOffset();
-            }
-
-            fill->SetInterpolationColors(colors, offsets, stop_size);
-            applyTransformsOnBrush(gradient->getTransforms(), fill);
-            delete[] colors;
-            delete[] offsets;
+            fill->SetInterpolationColors(ramp.radial_colors.data(),
+                                         ramp.radial_offsets.data(),
+                                         ramp.radial_colors.size());
+            applyTransformsOnBrush(gradient->getTransform(), fill);
             return fill;
         }
     } else {
@@ -787,76 +631,60 @@ Gdiplus::Brush* Renderer::getBrush(SVGElement* shape,
     return nullptr;
 }
 
-// Apply transformation matrix operations on a linear gradient brush
+// Get the brush colors of a ramp, converting its stops on its first use. The
+// cache holds the ramps it converted, so their addresses are not reused by
+// other ramps while they are keys
+const Renderer::RampColors& Renderer::getRampColors(
+    const StopRamp& ramp) const {
+    auto found = ramp_colors.find(ramp.get());
+    if (found != ramp_colors.end()) return found->second;
+
+    // The ramps only held by the cache belong to closed documents
+    if (ramp_colors.size() >= ramp_limit) {
+        std::erase_if(ramp_colors, [](const auto& entry) {
+            return entry.second.ramp.use_count() == 1;
+        });
+        ramp_limit = std::max(kMinRamps, ramp_colors.size() * 2);
+    }
+
+    // The first and last stops also fill the ends of the ramp
+    const std::vector< Stop >& stops = *ramp;
+    RampColors& colors = ramp_colors[ramp.get()];
+    colors.ramp = ramp;
+    colors.linear_colors.push_back(toColor(stops.front().getColor()));
+    colors.linear_offsets.push_back(0);
+    for (const Stop& stop : stops) {
+        colors.linear_colors.push_back(toColor(stop.getColor()));
+        colors.linear_offsets.push_back(stop.getOffset());
+    }
+    colors.linear_colors.push_back(toColor(stops.back().getColor()));
+    colors.linear_offsets.push_back(1);
+
+    // A radial brush goes from its center, the last stop, out to the first
+    colors.radial_colors.assign(colors.linear_colors.rbegin(),
+                                colors.linear_colors.rend());
+    for (auto offset = colors.linear_offsets.rbegin();
+         offset != colors.linear_offsets.rend(); ++offset)
+        colors.radial_offsets.push_back(1 - *offset);
+    return colors;
+}
+
+// Apply the transformation matrix of a gradient on a linear gradient brush
 void Renderer::applyTransformsOnBrush(
-    std::vector< std::string > transform_order,
+    const AffineTransform& transform,
     Gdiplus::LinearGradientBrush*& brush) const {
-    for (auto type : transform_order) {
-        if (type.find("translate") != std::string::npos) {
-            // Apply translation transformation
-            float trans_x = getTranslate(type).first,
-                  trans_y = getTranslate(type).second;
-            brush->TranslateTransform(trans_x, trans_y);
-        } else if (type.find("rotate") != std::string::npos) {
-            // Apply rotation transformation
-            float degree = getRotate(type);
-            brush->RotateTranform(degree);
-        } else if (type.find("scale") != std::string::npos) {
-            // Apply scaling transformation
-            if (type.find(",") != std::string::npos) {
-                float scale_x = getScaleXY(type).first,
-                      scale_y = getScaleXY(type).second;
-                brush->ScaleTransform(scale_x, scale_y);
-            } else {
-                float scale = getScale(type);
-                brush->ScaleTransform(scale, scale);
-            }
-        } else if (type.find("matrix") != std::string::npos) {
-            // Apply matrix transformation
-            float a = 0, b = 0, c = 0, d = 0, e = 0, f = 0;
-            if (type.find(",") != std::string::npos) {
-                type.erase(std::remove(type.begin(), type.end(), ','),
-                           type.end());
-            }
-            sscanf(type.c_str(), "matrix(%f %f %f %f %f %f)", &a, &b, &c, &d,
-                   &e, &f);
-            Gdiplus::Matrix matrix(a, b, c, d, e, f);
-            brush->SetTransform(&matrix);
-        }
-    }
+    if (transform.isIdentity()) return;
+    Gdiplus::Matrix matrix(transform.a, transform.b, transform.c, transform.d,
+                           transform.e, transform.f);
+    brush->MultiplyTransform(&matrix);
 }
 
-// Apply transformation matrix operations on a path gradient brush
+// Apply the transformation matrix of a gradient on a path gradient brush
 void Renderer::applyTransformsOnBrush(
-    std::vector< std::string > transform_order,
+    const AffineTransform& transform,
     Gdiplus::PathGradientBrush*& brush) const {
-    for (auto type : transform_order) {
-        if (type.find("translate") != std::string::npos) {
-            float trans_x = getTranslate(type).first,
-                  trans_y = getTranslate(type).second;
-            brush->TranslateTransform(trans_x, trans_y);
-        } else if (type.find("rotate") != std::string::npos) {
-            float degree = getRotate(type);
-            brush->RotateTransform(degree);
-        } else if (type.find("scale") != std::string::npos) {
-            if (type.find(",") != std::string::npos) {
-                float scale_x = getScaleXY(type).first,
-                      scale_y = getScaleXY(type).second;
-                brush->ScaleTransform(scale_x, scale_y);
-            } else {
-                float scale = getScale(type);
-                brush->ScaleTransform(scale, scale);
-            }
-        } else if (type.find("matrix") != std::string::npos) {
-            float a = 0, b = 0, c = 0, d = 0, e = 0, f = 0;
-            if (type.find(",") != std::string::npos) {
-                type.erase(std::remove(type.begin(), type.end(), ','),
-                           type.end());
-            }
-            sscanf(type.c_str(), "matrix(%f %f %f %f %f %f)", &a, &b, &c, &d,
-                   &e, &f);
-            Gdiplus::Matrix matrix(a, b, c, d, e, f);
-            brush->SetTransform(&matrix);
-        }
-    }
-}
\ No newline at end of file
+    if (transform.isIdentity()) return;
+    Gdiplus::Matrix matrix(transform.a, transform.b, transform.c, transform.d,
+                           transform.e, transform.f);
+    brush->MultiplyTransform(&matrix);
+}
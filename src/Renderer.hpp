@@ -8,6 +8,19 @@
 
 // clang-format on
 #include <Graphics.hpp>
+#include <SceneBVH.hpp>
+#include <SceneStore.hpp>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The shapes drawn and culled by the last frame.
+ */
+struct FrameStats {
+    std::size_t drawn = 0;   ///< Shapes overlapping the visible area
+    std::size_t culled = 0;  ///< Shapes skipped, outside of it
+};
+
 /**
  * @brief Singleton class responsible for rendering shapes using GDI+.
  *
@@ -46,19 +59,55 @@ public:
      * @param graphics The Gdiplus::Graphics context for drawing.
      * @param shape The SVGElement representing the shape to be drawn.
      */
-    void draw(Gdiplus::Graphics& graphics, Group* group) const;
+    void draw(Gdiplus::Graphics& graphics, const Group* group) const;
+
+    /**
+     * @brief Draws a flattened scene in one pass over its elements.
+     *
+     * @param graphics The Gdiplus::Graphics context for drawing.
+     * @param store The store of the scene, drawn in paint order, each shape
+     * with its world matrix and the subtree of a symbol once per use.
+     */
+    void draw(Gdiplus::Graphics& graphics, const SceneStore& store) const;
+
+    /**
+     * @brief Draws the shapes of a flattened scene that may be visible.
+     *
+     * @param graphics The Gdiplus::Graphics context for drawing.
+     * @param store The store of the scene, drawn in paint order, each shape
+     * with its world matrix.
+     * @param bvh The hierarchy of the bounds of the store.
+     * @param visible The visible area, in the coordinates of the document.
+     * @note The shapes whose bounds miss the area are not drawn, the
+     * counts are kept for getFrameStats().
+     */
+    void draw(Gdiplus::Graphics& graphics, const SceneStore& store,
+              const SceneBVH& bvh, const BoundingBox& visible) const;
+
+    /**
+     * @brief Gets the counts of the last frame drawn with a visible area.
+     *
+     * @return The number of shapes drawn and culled.
+     */
+    const FrameStats& getFrameStats() const;
 
 private:
     /**
-     * @brief Utility function to apply a series of transformations to the
-     * graphics context.
+     * @brief Draws a shape other than a group or a use.
+     *
+     * @param graphics The Gdiplus::Graphics context for drawing.
+     * @param shape The shape, drawn with the current transform.
+     */
+    void drawShape(Gdiplus::Graphics& graphics, SVGElement* shape) const;
+
+    /**
+     * @brief Utility function to apply the transformation matrix of an
+     * element to the graphics context.
      *
-     * @param transform_order The order in which transformations should be
-     * applied.
-     * @param graphics The Gdiplus::Graphics context to apply transformations
-     * to.
+     * @param transform The matrix resolved from the transform list.
+     * @param graphics The Gdiplus::Graphics context to apply the matrix to.
      */
-    void applyTransform(std::vector< std::string > transform_order,
+    void applyTransform(const AffineTransform& transform,
                         Gdiplus::Graphics& graphics) const;
 
     /**
@@ -122,6 +171,8 @@ private:
      *
      * @param graphics The Gdiplus::Graphics context for drawing.
      * @param path The Path object representing the path to be drawn.
+     * @note The curves and arcs are drawn as the lines of the flattening the
+     * path caches for the scale of the current transform.
      */
     void drawPath(Gdiplus::Graphics& graphics, Path* path) const;
 
@@ -135,26 +186,46 @@ private:
     Gdiplus::Brush* getBrush(SVGElement* shape, Gdiplus::RectF bound) const;
 
     /**
-     * @brief Utility function to apply a series of transformations to the brush
-     * object.
+     * @brief The stops of a ramp converted for the gradient brushes.
+     *
+     * The first and last stops are repeated at the offsets 0 and 1. A
+     * radial brush interpolates from its center out, so it takes the stops
+     * in reverse order.
+     */
+    struct RampColors {
+        StopRamp ramp;  ///< The ramp, kept alive while it is the key
+        std::vector< Gdiplus::Color > linear_colors;  ///< Colors, in order
+        std::vector< float > linear_offsets;          ///< Offsets, in order
+        std::vector< Gdiplus::Color > radial_colors;  ///< Colors, reversed
+        std::vector< float > radial_offsets;          ///< Offsets, reversed
+    };
+
+    /**
+     * @brief Gets the brush colors of a ramp, converted on its first use.
+     *
+     * @param ramp The stops of a gradient, not empty.
+     * @return The colors and offsets of the ramp.
+     */
+    const RampColors& getRampColors(const StopRamp& ramp) const;
+
+    /**
+     * @brief Utility function to apply the transformation matrix of a
+     * gradient to the brush object.
      *
-     * @param transform_order The order in which transformations should be
-     * applied.
+     * @param transform The matrix resolved from the gradientTransform list.
      * @param brush The Gdiplus::LinearGradientBrush object for the shape fill.
      */
-    void applyTransformsOnBrush(std::vector< std::string > transform_order,
+    void applyTransformsOnBrush(const AffineTransform& transform,
                                 Gdiplus::LinearGradientBrush*& brush) const;
 
     /**
-     * @brief Utility function to apply a series of transformations to the brush
-     * object.
+     * @brief Utility function to apply the transformation matrix of a
+     * gradient to the brush object.
      *
-     * @param transform_order The order in which transformations should be
-     * applied.
+     * @param transform The matrix resolved from the gradientTransform list.
      * @param brush The Gdiplus::PathGradientBrush object for the shape fill.
-     *
      */
-    void applyTransformsOnBrush(std::vector< std::string > transform_order,
+    void applyTransformsOnBrush(const AffineTransform& transform,
                                 Gdiplus::PathGradientBrush*& brush) const;
 
     /**
@@ -163,6 +234,14 @@ private:
     Renderer();
 
     static Renderer* instance;  ///< Singleton instance of the Renderer class
+    mutable FrameStats frame_stats;  ///< Counts of the last frame
+    mutable std::vector< StoreShape >
+        visible_shapes;  ///< Shapes of the last frame, reused by each frame
+    mutable std::vector< Gdiplus::PointF >
+        flat_points;  ///< Points of a flattened figure, reused by each path
+    mutable std::unordered_map< const std::vector< Stop >*, RampColors >
+        ramp_colors;  ///< Converted ramps, by the stops they were made from
+    mutable std::size_t ramp_limit;  ///< Ramps held before unused ones go
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "SceneArena.hpp"
+
+#include <atomic>
+#include <cstring>
+
+namespace {
+    // Ids are never reused, so a thread never mistakes a new arena at the
+    // address of a destroyed one for the arena it last allocated from
+    std::atomic< std::uint64_t > next_id{1};
+
+    // The arena the calling thread last allocated from, and its blocks
+    struct ThreadCache {
+        std::uint64_t arena = 0;
+        void* blocks = NULL;
+    };
+    thread_local ThreadCache cache;
+}  // namespace
+
+SceneArena::SceneArena() : id(next_id++) {}
+
+SceneArena::~SceneArena() {
+    // The blocks of every thread go back to the system here, the objects in
+    // them are simply forgotten
+    if (cache.arena == id) cache = ThreadCache();
+}
+
+SceneArena::ThreadBlocks* SceneArena::getThreadBlocks() {
+    if (cache.arena == id) return (ThreadBlocks*)cache.blocks;
+
+    // The cache only holds the last arena, so a thread alternating between
+    // two arenas looks its blocks up again rather than starting new ones
+    std::thread::id owner = std::this_thread::get_id();
+    std::lock_guard< std::mutex > lock(mutex);
+    ThreadBlocks* blocks = NULL;
+    for (const auto& thread : threads) {
+        if (thread->owner == owner) blocks = thread.get();
+    }
+    if (blocks == NULL) {
+        threads.push_back(std::make_unique< ThreadBlocks >());
+        blocks = threads.back().get();
+        blocks->owner = owner;
+    }
+    cache.arena = id;
+    cache.blocks = blocks;
+    return blocks;
+}
+
+std::string_view SceneArena::copy(std::string_view text) {
+    if (text.empty()) return std::string_view();
+    char* memory = (char*)allocate(text.size(), 1);
+    std::memcpy(memory, text.data(), text.size());
+    return std::string_view(memory, text.size());
+}
+
+std::pmr::polymorphic_allocator<> SceneArena::getAllocator() {
+    return std::pmr::polymorphic_allocator<>(this);
+}
+
+std::pmr::polymorphic_allocator<> SceneArena::getCacheAllocator() {
+    return std::pmr::polymorphic_allocator<>(&cache_pool);
+}
+
+std::size_t SceneArena::getBytesUsed() const {
+    std::lock_guard< std::mutex > lock(mutex);
+    std::size_t bytes = 0;
+    for (const auto& thread : threads)
+        bytes += thread->bytes.load(std::memory_order_relaxed);
+    return bytes;
+}
+
+// A container may be grown by another thread than the one that created it,
+// so every allocation goes to the blocks of the calling thread
+void* SceneArena::do_allocate(std::size_t size, std::size_t alignment) {
+    ThreadBlocks* thread = getThreadBlocks();
+    thread->bytes.fetch_add(size, std::memory_order_relaxed);
+    return thread->blocks.allocate(size, alignment);
+}
+
+void SceneArena::do_deallocate(void*, std::size_t, std::size_t) {
+    // Monotonic: the memory of a grown vector is reclaimed with the arena
+}
+
+bool SceneArena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,125 @@
+#ifndef SCENE_ARENA_HPP_
+#define SCENE_ARENA_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Monotonic memory of the scene of one document.
+ *
+ * The elements of a scene, their styles, points, children and strings are
+ * all carved out of large blocks by bumping a pointer, and the blocks are
+ * freed together with the arena. The destructors of the objects are never
+ * run, so everything created in the arena must keep its memory in the arena
+ * too: the containers use its allocator. Each thread allocating from the
+ * arena gets its own blocks, whichever container it grows, so the parser
+ * threads never contend on a lock when they build their groups. The caches
+ * filled while drawing, whose contents are replaced as the view changes,
+ * take their memory from a pool of the arena instead, which reuses what
+ * they free and returns everything with the arena.
+ */
+class SceneArena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructs an empty arena.
+     */
+    SceneArena();
+
+    /**
+     * @brief Deleted copy constructor, the arena owns its blocks.
+     */
+    SceneArena(const SceneArena&) = delete;
+
+    /**
+     * @brief Frees every block at once, without destroying the objects.
+     */
+    ~SceneArena();
+
+    /**
+     * @brief Constructs an object in the arena.
+     *
+     * @param args The arguments of the constructor.
+     * @return The object, which lives as long as the arena.
+     */
+    template< typename T, typename... Args >
+    T* create(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        return new (memory) T(std::forward< Args >(args)...);
+    }
+
+    /**
+     * @brief Copies a string into the arena.
+     *
+     * @param text The string to be copied.
+     * @return The copy, which lives as long as the arena.
+     */
+    std::string_view copy(std::string_view text);
+
+    /**
+     * @brief Gets an allocator for the containers of the scene.
+     *
+     * @return The allocator of the arena.
+     */
+    std::pmr::polymorphic_allocator<> getAllocator();
+
+    /**
+     * @brief Gets an allocator for the caches of the scene.
+     *
+     * @return The allocator of the pool of the arena, which frees memory.
+     * @note The pool is not locked, only the thread drawing the scene may
+     * allocate from it.
+     */
+    std::pmr::polymorphic_allocator<> getCacheAllocator();
+
+    /**
+     * @brief Gets the memory taken by the scene.
+     *
+     * @return The bytes allocated from the arena by all threads.
+     */
+    std::size_t getBytesUsed() const;
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t size,
+                       std::size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override;
+
+    /**
+     * @brief The blocks of one thread.
+     *
+     * Only the owner allocates from the blocks, but getBytesUsed() may read
+     * the count while the owner is still parsing.
+     */
+    struct ThreadBlocks {
+        std::thread::id owner;                       ///< Thread of the blocks
+        std::pmr::monotonic_buffer_resource blocks;  ///< Memory of the thread
+        std::atomic< std::size_t > bytes{0};  ///< Bytes allocated
+    };
+
+    /**
+     * @brief Gets the blocks of the calling thread.
+     *
+     * @return The blocks of the thread, created on its first allocation and
+     * found again when the thread comes back from another arena.
+     */
+    ThreadBlocks* getThreadBlocks();
+
+    std::uint64_t id;          ///< Unique id, matched by the thread caches
+    mutable std::mutex mutex;  ///< Guards the list of blocks
+    std::vector< std::unique_ptr< ThreadBlocks > >
+        threads;  ///< Blocks of the threads that allocated
+    std::pmr::unsynchronized_pool_resource
+        cache_pool;  ///< Memory of the caches, freed with the arena
+};
+
+#endif  // SCENE_ARENA_HPP_
@@ -0,0 +1,183 @@
+#include "SceneBVH.hpp"
+
+#include <algorithm>
+
+namespace {
+    constexpr std::uint32_t kLeafSize = 4;  // Most shapes held by a leaf
+    constexpr int kMaxDepth = 64;  // Most ancestors of a node
+
+    // Get twice the center of a box along an axis
+    float getCenter(const BoundingBox& box, int axis) {
+        return axis == 0 ? box.min.x + box.max.x : box.min.y + box.max.y;
+    }
+}  // namespace
+
+void SceneBVH::build(const SceneStore& store) {
+    *this = SceneBVH();
+    this->store = &store;
+    // The tree of the document and the subtree of each symbol follow each
+    // other in the store, each indexed by a tree of its own
+    std::vector< Item > items;
+    std::span< const ElementKind > kinds = store.getKinds();
+    std::span< const std::uint32_t > ends = store.getEnds();
+    std::span< const BoundingBox > store_bounds = store.getBounds();
+    for (std::uint32_t root = 0; root < kinds.size(); root = ends[root]) {
+        items.clear();
+        for (std::uint32_t i = root + 1; i < ends[root]; ++i) {
+            if (kinds[i] == ElementKind::Group || store_bounds[i].isEmpty())
+                continue;
+            items.push_back({store_bounds[i], i});
+        }
+        trees.push_back({root, addTree(items)});
+    }
+    trees.shrink_to_fit();
+    nodes.shrink_to_fit();
+    shapes.shrink_to_fit();
+    bounds.shrink_to_fit();
+}
+
+std::uint32_t SceneBVH::addTree(std::vector< Item >& items) {
+    if (items.empty()) return SceneStore::kNone;
+
+    // Split the shapes of each node in halves along the longer side of the
+    // box of their centers, until the leaves are small enough. The children
+    // of a node are stored next to each other
+    struct Task {
+        std::uint32_t node;   // Node to be filled
+        std::uint32_t first;  // First of its shapes
+        std::uint32_t count;  // Number of its shapes
+        int depth;            // Number of its ancestors
+    };
+    std::uint32_t root = nodes.size();
+    std::uint32_t offset = shapes.size();
+    std::vector< Task > tasks = {{root, 0, (std::uint32_t)items.size(), 0}};
+    nodes.emplace_back();
+    while (!tasks.empty()) {
+        Task task = tasks.back();
+        tasks.pop_back();
+        Item* begin = items.data() + task.first;
+        Item* end = begin + task.count;
+        if (task.count <= kLeafSize) {
+            for (Item* item = begin; item != end; ++item)
+                nodes[task.node].bounds.add(item->bounds);
+            nodes[task.node].first = offset + task.first;
+            nodes[task.node].count = task.count;
+            continue;
+        }
+        float min_x = getCenter(begin->bounds, 0), max_x = min_x;
+        float min_y = getCenter(begin->bounds, 1), max_y = min_y;
+        for (Item* item = begin + 1; item != end; ++item) {
+            float x = getCenter(item->bounds, 0);
+            float y = getCenter(item->bounds, 1);
+            min_x = std::min(min_x, x);
+            max_x = std::max(max_x, x);
+            min_y = std::min(min_y, y);
+            max_y = std::max(max_y, y);
+        }
+        int axis = max_x - min_x >= max_y - min_y ? 0 : 1;
+        float middle = axis == 0 ? (min_x + max_x) / 2 : (min_y + max_y) / 2;
+
+        // The shapes are split at the middle of the box in one pass. Shapes
+        // piled on one side, or a tree growing too deep, are split at their
+        // median instead, which keeps the depth within kMaxDepth
+        std::uint32_t half =
+            std::partition(begin, end,
+                           [axis, middle](const Item& item) {
+                               return getCenter(item.bounds, axis) < middle;
+                           }) -
+            begin;
+        if (half == 0 || half == task.count || task.depth >= kMaxDepth / 2) {
+            half = task.count / 2;
+            std::nth_element(begin, begin + half, end,
+                             [axis](const Item& a, const Item& b) {
+                                 return getCenter(a.bounds, axis) <
+                                        getCenter(b.bounds, axis);
+                             });
+        }
+        std::uint32_t child = nodes.size();
+        nodes[task.node].first = child;
+        nodes.resize(nodes.size() + 2);
+        tasks.push_back({child, task.first, half, task.depth + 1});
+        tasks.push_back(
+            {child + 1, task.first + half, task.count - half, task.depth + 1});
+    }
+
+    // The children come after their parent, so walking backwards bounds
+    // each inner node once its children are
+    for (std::size_t i = nodes.size(); i-- > root;) {
+        if (nodes[i].count != 0) continue;
+        nodes[i].bounds = nodes[nodes[i].first].bounds;
+        nodes[i].bounds.add(nodes[nodes[i].first + 1].bounds);
+    }
+
+    // The shapes are kept in the order of the leaves, their bounds apart
+    // from their indices to be read together
+    for (const Item& item : items) {
+        shapes.push_back(item.shape);
+        bounds.push_back(item.bounds);
+    }
+    return root;
+}
+
+std::size_t SceneBVH::size() const { return shapes.size(); }
+
+void SceneBVH::query(const BoundingBox& area,
+                     std::vector< StoreShape >& found) const {
+    if (trees.empty()) return;
+    std::vector< std::uint32_t > indices;
+    queryTree(trees[0].node, area, AffineTransform(), indices, found);
+}
+
+void SceneBVH::queryTree(std::uint32_t root, const BoundingBox& area,
+                         const AffineTransform& matrix,
+                         std::vector< std::uint32_t >& indices,
+                         std::vector< StoreShape >& found) const {
+    if (root == SceneStore::kNone) return;
+    std::size_t first = indices.size();
+    // Each node on the stack is the sibling of an ancestor of the visited
+    // one, or the root
+    std::uint32_t stack[kMaxDepth + 1];
+    int top = 0;
+    stack[top++] = root;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!node.bounds.intersects(area)) continue;
+        if (node.count == 0) {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+            continue;
+        }
+        for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+            if (bounds[i].intersects(area)) indices.push_back(shapes[i]);
+        }
+    }
+    // The store holds the shapes in paint order, and the shapes of an
+    // instance are painted in place of its use. The list grows with the
+    // instances, so it is read by index
+    std::sort(indices.begin() + first, indices.end());
+    std::size_t last = indices.size();
+    for (std::size_t k = first; k < last; ++k) {
+        std::uint32_t index = indices[k];
+        const AffineTransform& local = store->getMatrix(index);
+        if (store->getKinds()[index] != ElementKind::Use) {
+            found.push_back({index, matrix * local});
+            continue;
+        }
+        // A matrix flattening the instance leaves nothing to find
+        if (local.a * local.d - local.b * local.c == 0) continue;
+        auto tree = std::lower_bound(
+            trees.begin(), trees.end(), store->getSymbol(index),
+            [](const Tree& entry, std::uint32_t symbol) {
+                return entry.root < symbol;
+            });
+        queryTree(tree->node, area.transform(local.getInverse()),
+                  matrix * local, indices, found);
+    }
+    indices.resize(first);
+}
+
+std::size_t SceneBVH::getBytesUsed() const {
+    return trees.capacity() * sizeof(Tree) + nodes.capacity() * sizeof(Node) +
+           shapes.capacity() * sizeof(std::uint32_t) +
+           bounds.capacity() * sizeof(BoundingBox);
+}
@@ -0,0 +1,121 @@
+#ifndef SCENE_BVH_HPP_
+#define SCENE_BVH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SceneStore.hpp"
+
+/**
+ * @brief A bounding-volume hierarchy over the shapes of a SceneStore.
+ *
+ * The shapes and the uses, every element but the groups, are sorted into a
+ * binary tree of boxes by their bounds in the coordinates of the document,
+ * whatever group they belong to. The subtree of each symbol gets a tree of
+ * its own, in the coordinates of the symbol, which a query enters through
+ * the matrix of each use it meets. A query only visits the boxes
+ * overlapping its area, so finding the shapes of a small part of a large
+ * scene takes time in the number of shapes found rather than in the size
+ * of the scene. The trees are built once the store is, and refer to the
+ * shapes by their index in the store.
+ */
+class SceneBVH {
+public:
+    /**
+     * @brief Replaces the content of the hierarchy with the shapes of a
+     * store.
+     *
+     * @param store The store of the scene, whose bounds are indexed.
+     * @note The shapes with empty bounds draw nothing and are left out. The
+     * hierarchy keeps a reference to the store, it has to be rebuilt with
+     * it.
+     */
+    void build(const SceneStore& store);
+
+    /**
+     * @brief Gets the number of indexed elements.
+     *
+     * @return The number of shapes and uses with non-empty bounds, those of
+     * a symbol counted once.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Finds the shapes overlapping an area.
+     *
+     * @param area The area, in the coordinates of the document.
+     * @param found Receives the shapes whose bounds overlap the area, in
+     * paint order. A shape of a symbol is found once per instance
+     * overlapping the area.
+     */
+    void query(const BoundingBox& area,
+               std::vector< StoreShape >& found) const;
+
+    /**
+     * @brief Gets the memory taken by the hierarchy.
+     *
+     * @return The bytes of the nodes and of the shapes.
+     */
+    std::size_t getBytesUsed() const;
+
+private:
+    /**
+     * @brief Item of a tree sorted by the splits, a shape with its bounds.
+     */
+    struct Item {
+        BoundingBox bounds;   ///< Bounds of the shape
+        std::uint32_t shape;  ///< Index of the shape in the store
+    };
+
+    /**
+     * @brief The tree of boxes of the tree of the document or of the
+     * subtree of a symbol.
+     */
+    struct Tree {
+        std::uint32_t root;  ///< Index of the root of the subtree in the store
+        std::uint32_t node;  ///< Root node, SceneStore::kNone if empty
+    };
+
+    /**
+     * @brief A box of the hierarchy, a leaf if it holds shapes.
+     */
+    struct Node {
+        BoundingBox bounds;       ///< Bounds of the shapes under the node
+        std::uint32_t first = 0;  ///< First shape of a leaf, or first child
+        std::uint32_t count = 0;  ///< Number of shapes, 0 for an inner node
+    };
+
+    /**
+     * @brief Builds the tree of boxes of some shapes.
+     *
+     * @param items The shapes, reordered by the splits.
+     * @return The index of the root node, SceneStore::kNone if there are no
+     * shapes.
+     */
+    std::uint32_t addTree(std::vector< Item >& items);
+
+    /**
+     * @brief Finds the shapes of a tree overlapping an area, for one
+     * instance of it.
+     *
+     * @param root The root node of the tree.
+     * @param area The area, in the coordinates of the tree.
+     * @param matrix The matrix of the instance.
+     * @param indices Holds the store indices found, those of each instance
+     * taken off once it is done.
+     * @param found Receives the shapes, in paint order.
+     */
+    void queryTree(std::uint32_t root, const BoundingBox& area,
+                   const AffineTransform& matrix,
+                   std::vector< std::uint32_t >& indices,
+                   std::vector< StoreShape >& found) const;
+
+    const SceneStore* store = NULL;       ///< Store the shapes belong to
+    std::vector< Tree > trees;            ///< Trees, by the index of root
+    std::vector< Node > nodes;            ///< Nodes of all the trees
+    std::vector< std::uint32_t > shapes;  ///< Store index of each shape
+    std::vector< BoundingBox > bounds;    ///< Bounds of each shape
+};
+
+#endif  // SCENE_BVH_HPP_
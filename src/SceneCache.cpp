@@ -0,0 +1,687 @@
+#include "SceneCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ComputedStyle.hpp"
+#include "MappedFile.hpp"
+
+namespace {
+    constexpr char kMagic[4] = {'S', 'V', 'G', 'C'};
+
+    enum class Kind : std::uint8_t {
+        Group,
+        Line,
+        Rect,
+        Circle,
+        Ellipse,
+        Polygon,
+        Polyline,
+        Path,
+        Text,
+        Use,
+    };
+
+    // A string of the string pool
+    struct StringRef {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    struct ColorRecord {
+        std::uint8_t r, g, b, a;
+    };
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t source_hash;
+        std::uint64_t source_size;
+        std::uint32_t element_count;
+        std::uint32_t symbol_count;
+        std::uint32_t gradient_count;
+        std::uint32_t stop_count;
+        std::uint32_t point_count;
+        std::uint32_t path_point_count;
+        std::uint32_t arc_count;
+        std::uint32_t string_size;
+        float viewbox[4];
+        float viewport[2];
+    };
+
+    // One element, in document order. A group is followed by the records of
+    // its children and their descendants. The subtrees of the symbols come
+    // first, each one after the symbols it uses, then the tree of the
+    // document.
+    struct ElementRecord {
+        Kind kind;
+        std::uint8_t fill_rule;     // Polygons, polylines and paths
+        std::uint8_t anchor;        // Texts
+        std::uint8_t font_style;    // Texts
+        std::uint32_t child_count;  // Groups only
+        ColorRecord fill;
+        ColorRecord stroke;
+        float stroke_width;
+        float position[2];
+        float transform[6];
+        std::int32_t gradient;    // Index in the gradients, -1 if none
+        float data[4];            // Sizes, radii, line end or font size
+        std::uint32_t first;      // First point or path point, or symbol
+        std::uint32_t count;      // Number of points or path points, or 1 if
+                                  // a use has a symbol
+        std::uint32_t first_arc;  // First arc of a path
+        StringRef content;        // Text content
+    };
+
+    struct GradientRecord {
+        std::uint8_t radial;
+        std::uint8_t units;
+        std::uint8_t padding[2];
+        StringRef id;
+        float points[4];
+        float radius[2];
+        float transform[6];
+        std::uint32_t first_stop;
+        std::uint32_t stop_count;
+    };
+
+    struct StopRecord {
+        ColorRecord color;
+        float offset;
+    };
+
+    struct PointRecord {
+        float x, y;
+    };
+
+    // The vertices of the paths are point records, with their commands in
+    // a parallel section of bytes
+    struct ArcRecord {
+        float radius[2];
+        float x_axis_rotation;
+        std::uint8_t large_arc;
+        std::uint8_t sweep;
+        std::uint8_t padding[2];
+    };
+
+    static_assert(sizeof(Header) % 8 == 0, "Sections must stay aligned");
+    static_assert(std::is_trivially_copyable_v< ElementRecord > &&
+                      std::is_trivially_copyable_v< GradientRecord > &&
+                      std::is_trivially_copyable_v< ArcRecord >,
+                  "Records are written and read as raw bytes");
+
+    ColorRecord toRecord(const ColorShape& color) {
+        return {(std::uint8_t)color.r, (std::uint8_t)color.g,
+                (std::uint8_t)color.b, (std::uint8_t)color.a};
+    }
+
+    ColorShape fromRecord(const ColorRecord& color) {
+        return ColorShape(color.r, color.g, color.b, color.a);
+    }
+
+    void toRecord(const AffineTransform& transform, float* m) {
+        m[0] = transform.a;
+        m[1] = transform.b;
+        m[2] = transform.c;
+        m[3] = transform.d;
+        m[4] = transform.e;
+        m[5] = transform.f;
+    }
+
+    AffineTransform fromRecord(const float* m) {
+        return AffineTransform(m[0], m[1], m[2], m[3], m[4], m[5]);
+    }
+
+    // Collects the records of a scene before they are written
+    class Writer {
+    public:
+        explicit Writer(const std::map< std::string, Gradient* >& gradients) {
+            for (const auto& [id, gradient] : gradients)
+                addGradient(id, gradient);
+        }
+
+        void addElement(const SVGElement* element) {
+            ElementRecord record{};
+            record.fill = toRecord(element->getFillColor());
+            record.stroke = toRecord(element->getOutlineColor());
+            record.stroke_width = element->getOutlineThickness();
+            record.position[0] = element->getPosition().x;
+            record.position[1] = element->getPosition().y;
+            toRecord(element->getTransform(), record.transform);
+            auto gradient = gradient_index.find(element->getGradient());
+            record.gradient =
+                gradient != gradient_index.end() ? gradient->second : -1;
+
+            ElementKind type = element->getKind();
+            if (type == ElementKind::Group) {
+                const Group* group = static_cast< const Group* >(element);
+                record.kind = Kind::Group;
+                record.child_count = group->getElements().size();
+                elements.push_back(record);
+                for (const SVGElement* child : group->getElements())
+                    addElement(child);
+                return;
+            } else if (type == ElementKind::Line) {
+                const Line* line = static_cast< const Line* >(element);
+                record.kind = Kind::Line;
+                record.data[0] = line->getDirection().x;
+                record.data[1] = line->getDirection().y;
+            } else if (type == ElementKind::Rect) {
+                const Rect* rect = static_cast< const Rect* >(element);
+                record.kind = Kind::Rect;
+                record.data[0] = rect->getWidth();
+                record.data[1] = rect->getHeight();
+                record.data[2] = rect->getRadius().x;
+                record.data[3] = rect->getRadius().y;
+            } else if (type == ElementKind::Circle ||
+                       type == ElementKind::Ellipse) {
+                const Ell* ellipse = static_cast< const Ell* >(element);
+                record.kind =
+                    type == ElementKind::Circle ? Kind::Circle : Kind::Ellipse;
+                record.data[0] = ellipse->getRadius().x;
+                record.data[1] = ellipse->getRadius().y;
+            } else if (type == ElementKind::Polygon ||
+                       type == ElementKind::Polyline) {
+                const PolyShape* shape =
+                    static_cast< const PolyShape* >(element);
+                record.kind = type == ElementKind::Polygon ? Kind::Polygon
+                                                           : Kind::Polyline;
+                record.first = points.size();
+                for (const Vector2Df& point : shape->getPoints())
+                    points.push_back({point.x, point.y});
+                record.count = points.size() - record.first;
+                record.fill_rule = (std::uint8_t)shape->getFillRule();
+            } else if (type == ElementKind::Path) {
+                const Path* path = static_cast< const Path* >(element);
+                record.kind = Kind::Path;
+                PathView geometry = path->getGeometry();
+                record.first = path_points.size();
+                record.count = geometry.points.size();
+                record.first_arc = arcs.size();
+                for (const Vector2Df& point : geometry.points)
+                    path_points.push_back({point.x, point.y});
+                path_commands.insert(path_commands.end(),
+                                     geometry.commands.begin(),
+                                     geometry.commands.end());
+                for (const PathArc& arc : geometry.arcs) {
+                    arcs.push_back({{arc.radius.x, arc.radius.y},
+                                    arc.x_axis_rotation,
+                                    arc.large_arc_flag,
+                                    arc.sweep_flag,
+                                    {0, 0}});
+                }
+                record.fill_rule = (std::uint8_t)path->getFillRule();
+            } else if (type == ElementKind::Text) {
+                const Text* text = static_cast< const Text* >(element);
+                record.kind = Kind::Text;
+                record.data[0] = text->getFontSize();
+                record.content = addString(text->getContent());
+                record.anchor = (std::uint8_t)text->getAnchor();
+                record.font_style = (std::uint8_t)text->getFontStyle();
+            } else if (type == ElementKind::Use) {
+                const Use* use = static_cast< const Use* >(element);
+                record.kind = Kind::Use;
+                if (use->getSymbol() != NULL) {
+                    record.first = addSymbol(use->getSymbol());
+                    record.count = 1;
+                }
+            } else {
+                // Unknown elements are not drawn, so they are not cached
+                return;
+            }
+            elements.push_back(record);
+        }
+
+        // Writes the header and the sections, returns false on failure
+        bool save(std::ofstream& file, Header header) const {
+            header.element_count = symbol_elements.size() + elements.size();
+            header.symbol_count = symbol_index.size();
+            header.gradient_count = gradients.size();
+            header.stop_count = stops.size();
+            header.point_count = points.size();
+            header.path_point_count = path_points.size();
+            header.arc_count = arcs.size();
+            header.string_size = strings.size();
+            file.write((const char*)&header, sizeof(header));
+            writeSection(file, symbol_elements);
+            writeSection(file, elements);
+            writeSection(file, gradients);
+            writeSection(file, stops);
+            writeSection(file, points);
+            writeSection(file, path_points);
+            writeSection(file, arcs);
+            writeSection(file, path_commands);
+            file.write(strings.data(), strings.size());
+            return (bool)file;
+        }
+
+    private:
+        // Writes the subtree of a symbol once, returns its index
+        std::uint32_t addSymbol(const Group* symbol) {
+            auto found = symbol_index.find(symbol);
+            if (found != symbol_index.end()) return found->second;
+            // The records of the symbol go to their own list, after those of
+            // the symbols it uses
+            std::vector< ElementRecord > outer;
+            outer.swap(elements);
+            addElement(symbol);
+            symbol_elements.insert(symbol_elements.end(), elements.begin(),
+                                   elements.end());
+            elements.swap(outer);
+            std::uint32_t index = symbol_index.size();
+            symbol_index[symbol] = index;
+            return index;
+        }
+
+        StringRef addString(const std::string& text) {
+            StringRef ref = {(std::uint32_t)strings.size(),
+                             (std::uint32_t)text.size()};
+            strings += text;
+            return ref;
+        }
+
+        void addGradient(const std::string& id, const Gradient* gradient) {
+            GradientRecord record{};
+            record.radial = gradient->getKind() == GradientKind::Radial;
+            record.id = addString(id);
+            record.units = (std::uint8_t)gradient->getUnits();
+            record.points[0] = gradient->getPoints().first.x;
+            record.points[1] = gradient->getPoints().first.y;
+            record.points[2] = gradient->getPoints().second.x;
+            record.points[3] = gradient->getPoints().second.y;
+            if (record.radial) {
+                Vector2Df radius =
+                    static_cast< const RadialGradient* >(gradient)
+                        ->getRadius();
+                record.radius[0] = radius.x;
+                record.radius[1] = radius.y;
+            }
+            toRecord(gradient->getTransform(), record.transform);
+            // Gradients sharing their stops share their stop records
+            auto ramp = ramp_index.find(gradient->getSharedStops().get());
+            if (ramp != ramp_index.end()) {
+                record.first_stop = ramp->second;
+            } else {
+                record.first_stop = stops.size();
+                ramp_index[gradient->getSharedStops().get()] = stops.size();
+                for (const Stop& stop : gradient->getStops())
+                    stops.push_back(
+                        {toRecord(stop.getColor()), stop.getOffset()});
+            }
+            record.stop_count = gradient->getStops().size();
+            gradient_index[gradient] = gradients.size();
+            gradients.push_back(record);
+        }
+
+        template< typename Record >
+        static void writeSection(std::ofstream& file,
+                                 const std::vector< Record >& records) {
+            file.write((const char*)records.data(),
+                       records.size() * sizeof(Record));
+        }
+
+        std::vector< ElementRecord > elements;
+        std::vector< ElementRecord > symbol_elements;
+        std::vector< GradientRecord > gradients;
+        std::vector< StopRecord > stops;
+        std::vector< PointRecord > points;
+        std::vector< PointRecord > path_points;
+        std::vector< ArcRecord > arcs;
+        std::vector< char > path_commands;
+        std::string strings;
+        std::map< const Gradient*, std::int32_t > gradient_index;
+        std::map< const std::vector< Stop >*, std::uint32_t > ramp_index;
+        std::map< const Group*, std::uint32_t > symbol_index;
+    };
+
+    // The sections of a mapped cache file, used in place
+    struct Sections {
+        const Header* header;
+        const ElementRecord* elements;
+        const GradientRecord* gradients;
+        const StopRecord* stops;
+        const PointRecord* points;
+        const PointRecord* path_points;
+        const ArcRecord* arcs;
+        const char* path_commands;
+        const char* strings;
+
+        bool contains(const StringRef& ref) const {
+            return ref.offset <= header->string_size &&
+                   ref.size <= header->string_size - ref.offset;
+        }
+
+        bool contains(std::uint32_t first, std::uint32_t count,
+                      std::uint32_t total) const {
+            return first <= total && count <= total - first;
+        }
+
+        std::string string(const StringRef& ref) const {
+            return std::string(strings + ref.offset, ref.size);
+        }
+    };
+
+    // Builds the element of a record, returns NULL if the record is invalid
+    SVGElement* buildElement(const Sections& sections,
+                             const ElementRecord& record, SceneArena& arena,
+                             const std::vector< Gradient* >& gradients,
+                             const std::vector< const Group* >& symbols) {
+        const Header& header = *sections.header;
+        if (!sections.contains(record.content) ||
+            record.fill_rule > (std::uint8_t)FillRule::EvenOdd ||
+            record.anchor > (std::uint8_t)TextAnchor::End ||
+            record.font_style > (std::uint8_t)FontStyle::Oblique)
+            return NULL;
+        if (record.gradient >= (std::int32_t)gradients.size()) return NULL;
+
+        ColorShape fill = fromRecord(record.fill);
+        ColorShape stroke = fromRecord(record.stroke);
+        Vector2Df position(record.position[0], record.position[1]);
+        const float* data = record.data;
+        SVGElement* element = NULL;
+        switch (record.kind) {
+            case Kind::Group:
+                element = arena.create< Group >(arena.getAllocator());
+                break;
+            case Kind::Line:
+                element = arena.create< Line >(
+                    position, Vector2Df(data[0], data[1]), stroke,
+                    record.stroke_width);
+                break;
+            case Kind::Rect:
+                element = arena.create< Rect >(
+                    data[0], data[1], position, Vector2Df(data[2], data[3]),
+                    fill, stroke, record.stroke_width);
+                break;
+            case Kind::Circle:
+                element = arena.create< Circle >(data[0], position, fill,
+                                                 stroke, record.stroke_width);
+                break;
+            case Kind::Ellipse:
+                element = arena.create< Ell >(Vector2Df(data[0], data[1]),
+                                              position, fill, stroke,
+                                              record.stroke_width);
+                break;
+            case Kind::Polygon:
+            case Kind::Polyline: {
+                if (!sections.contains(record.first, record.count,
+                                       header.point_count))
+                    return NULL;
+                PolyShape* shape;
+                if (record.kind == Kind::Polygon)
+                    shape = arena.create< Plygon >(fill, stroke,
+                                                   record.stroke_width,
+                                                   arena.getAllocator());
+                else
+                    shape = arena.create< Plyline >(fill, stroke,
+                                                    record.stroke_width,
+                                                    arena.getAllocator());
+                const PointRecord* point = sections.points + record.first;
+                for (std::uint32_t i = 0; i < record.count; ++i, ++point)
+                    shape->addPoint(Vector2Df(point->x, point->y));
+                shape->setFillRule((FillRule)record.fill_rule);
+                element = shape;
+                break;
+            }
+            case Kind::Path: {
+                if (!sections.contains(record.first, record.count,
+                                       header.path_point_count))
+                    return NULL;
+                std::span< const char > commands(
+                    sections.path_commands + record.first, record.count);
+                std::uint32_t arc_count =
+                    std::count(commands.begin(), commands.end(), 'a');
+                if (!sections.contains(record.first_arc, arc_count,
+                                       header.arc_count))
+                    return NULL;
+                std::vector< Vector2Df > points;
+                points.reserve(record.count);
+                const PointRecord* point = sections.path_points + record.first;
+                for (std::uint32_t i = 0; i < record.count; ++i, ++point)
+                    points.push_back(Vector2Df(point->x, point->y));
+                std::vector< PathArc > arcs;
+                arcs.reserve(arc_count);
+                const ArcRecord* arc = sections.arcs + record.first_arc;
+                for (std::uint32_t i = 0; i < arc_count; ++i, ++arc) {
+                    arcs.push_back({Vector2Df(arc->radius[0], arc->radius[1]),
+                                    arc->x_axis_rotation, arc->large_arc != 0,
+                                    arc->sweep != 0});
+                }
+                Path* path = arena.create< Path >(
+                    fill, stroke, record.stroke_width, arena.getAllocator(),
+                    arena.getCacheAllocator());
+                if (!path->setGeometry({commands, points, arcs})) return NULL;
+                path->setFillRule((FillRule)record.fill_rule);
+                element = path;
+                break;
+            }
+            case Kind::Text: {
+                Text* text = arena.create< Text >(
+                    position, sections.string(record.content), data[0],
+                    fill, stroke, record.stroke_width, arena.getAllocator());
+                text->setAnchor((TextAnchor)record.anchor);
+                text->setFontStyle((FontStyle)record.font_style);
+                element = text;
+                break;
+            }
+            case Kind::Use: {
+                if (record.count != 0 && record.first >= symbols.size())
+                    return NULL;
+                Use* use = arena.create< Use >();
+                if (record.count != 0) use->setSymbol(symbols[record.first]);
+                element = use;
+                break;
+            }
+            default:
+                return NULL;
+        }
+        element->setFillColor(fill);
+        element->setOutlineColor(stroke);
+        element->setOutlineThickness(record.stroke_width);
+        element->setPosition(position);
+        element->setTransform(fromRecord(record.transform));
+        if (record.gradient >= 0)
+            element->setGradient(gradients[record.gradient]);
+        return element;
+    }
+
+    // Builds the tree whose group record is at next, and moves next past
+    // it. Returns NULL if a record is invalid, the elements already built
+    // are left to the arena.
+    Group* readTree(const Sections& sections, std::uint32_t& next,
+                    SceneArena& arena,
+                    const std::vector< Gradient* >& gradients,
+                    const std::vector< const Group* >& symbols) {
+        const Header& header = *sections.header;
+        if (next >= header.element_count) return NULL;
+        const ElementRecord& root_record = sections.elements[next++];
+        if (root_record.kind != Kind::Group) return NULL;
+        Group* root = arena.create< Group >(arena.getAllocator());
+        root->setTransform(fromRecord(root_record.transform));
+
+        // Each group takes the next child_count subtrees as its children
+        std::vector< std::pair< Group*, std::uint32_t > > open = {
+            {root, root_record.child_count}};
+        while (true) {
+            while (!open.empty() && open.back().second == 0) open.pop_back();
+            if (open.empty()) return root;
+            if (next >= header.element_count) break;
+            const ElementRecord& record = sections.elements[next++];
+            SVGElement* element =
+                buildElement(sections, record, arena, gradients, symbols);
+            if (element == NULL) break;
+            --open.back().second;
+            open.back().first->addElement(element);
+            if (record.kind == Kind::Group)
+                open.push_back({static_cast< Group* >(element),
+                                record.child_count});
+        }
+        return NULL;
+    }
+}  // namespace
+
+std::uint64_t SceneCache::hash(const char* data, std::size_t size) {
+    // Eight bytes per step: a bytewise hash would take longer than parsing
+    // the small documents
+    const std::uint64_t multiplier = 0xFF51AFD7ED558CCDull;
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * multiplier;
+        h ^= h >> 32;
+    }
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    h = (h ^ tail) * multiplier;
+    h ^= h >> 29;
+    return h;
+}
+
+bool SceneCache::write(const std::string& file_name, std::uint64_t source_hash,
+                       std::uint64_t source_size, const Group* root,
+                       const std::map< std::string, Gradient* >& gradients,
+                       const ViewBox& viewbox, const Vector2Df& viewport) {
+    Writer writer(gradients);
+    writer.addElement(root);
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.source_hash = source_hash;
+    header.source_size = source_size;
+    header.viewbox[0] = viewbox.getX();
+    header.viewbox[1] = viewbox.getY();
+    header.viewbox[2] = viewbox.getWidth();
+    header.viewbox[3] = viewbox.getHeight();
+    header.viewport[0] = viewport.x;
+    header.viewport[1] = viewport.y;
+
+    std::string temporary = file_name + ".tmp";
+    bool saved;
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        saved = file && writer.save(file, header);
+    }
+    std::error_code error;
+    if (saved) std::filesystem::rename(temporary, file_name, error);
+    if (!saved || error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+Group* SceneCache::read(const std::string& file_name,
+                        std::uint64_t source_hash, std::uint64_t source_size,
+                        SceneArena& arena,
+                        std::map< std::string, Gradient* >& gradients,
+                        ViewBox& viewbox, Vector2Df& viewport) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(file_name, error)) return NULL;
+    MappedFile file(file_name);
+    if (file.size() < sizeof(Header)) return NULL;
+
+    Sections sections;
+    const char* cursor = file.data();
+    sections.header = (const Header*)cursor;
+    const Header& header = *sections.header;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kVersion || header.source_hash != source_hash ||
+        header.source_size != source_size || header.element_count == 0)
+        return NULL;
+
+    std::size_t expected_size =
+        sizeof(Header) + header.element_count * sizeof(ElementRecord) +
+        header.gradient_count * sizeof(GradientRecord) +
+        header.stop_count * sizeof(StopRecord) +
+        header.point_count * sizeof(PointRecord) +
+        header.path_point_count * sizeof(PointRecord) +
+        header.arc_count * sizeof(ArcRecord) + header.path_point_count +
+        header.string_size;
+    if (file.size() != expected_size) return NULL;
+
+    cursor += sizeof(Header);
+    sections.elements = (const ElementRecord*)cursor;
+    cursor += header.element_count * sizeof(ElementRecord);
+    sections.gradients = (const GradientRecord*)cursor;
+    cursor += header.gradient_count * sizeof(GradientRecord);
+    sections.stops = (const StopRecord*)cursor;
+    cursor += header.stop_count * sizeof(StopRecord);
+    sections.points = (const PointRecord*)cursor;
+    cursor += header.point_count * sizeof(PointRecord);
+    sections.path_points = (const PointRecord*)cursor;
+    cursor += header.path_point_count * sizeof(PointRecord);
+    sections.arcs = (const ArcRecord*)cursor;
+    cursor += header.arc_count * sizeof(ArcRecord);
+    sections.path_commands = cursor;
+    cursor += header.path_point_count;
+    sections.strings = cursor;
+
+    // The gradients are built first, the elements refer to them by index
+    std::vector< Gradient* > built;
+    std::map< std::string, Gradient* > loaded;
+    std::map< std::pair< std::uint32_t, std::uint32_t >, StopRamp > ramps;
+    auto discard = [&]() {
+        for (Gradient* gradient : built) delete gradient;
+        return (Group*)NULL;
+    };
+    for (std::uint32_t i = 0; i < header.gradient_count; ++i) {
+        const GradientRecord& record = sections.gradients[i];
+        if (!sections.contains(record.id) ||
+            record.units > (std::uint8_t)GradientUnits::UserSpaceOnUse ||
+            !sections.contains(record.first_stop, record.stop_count,
+                               header.stop_count))
+            return discard();
+        StopRamp& ramp = ramps[{record.first_stop, record.stop_count}];
+        if (ramp == NULL) {
+            std::vector< Stop > stops;
+            for (std::uint32_t j = 0; j < record.stop_count; ++j) {
+                const StopRecord& stop =
+                    sections.stops[record.first_stop + j];
+                stops.push_back(Stop(fromRecord(stop.color), stop.offset));
+            }
+            ramp = std::make_shared< const std::vector< Stop > >(
+                std::move(stops));
+        }
+        std::pair< Vector2Df, Vector2Df > points = {
+            {record.points[0], record.points[1]},
+            {record.points[2], record.points[3]}};
+        GradientUnits units = (GradientUnits)record.units;
+        Gradient* gradient;
+        if (record.radial)
+            gradient = new RadialGradient(
+                ramp, points, Vector2Df(record.radius[0], record.radius[1]),
+                units);
+        else
+            gradient = new LinearGradient(ramp, points, units);
+        gradient->setTransform(fromRecord(record.transform));
+        built.push_back(gradient);
+        loaded[sections.string(record.id)] = gradient;
+    }
+
+    // The subtrees of the symbols are read first, the uses refer to them by
+    // index
+    std::vector< const Group* > symbols;
+    std::uint32_t next = 0;
+    for (std::uint32_t i = 0; i < header.symbol_count; ++i) {
+        Group* symbol = readTree(sections, next, arena, built, symbols);
+        if (symbol == NULL) return discard();
+        symbols.push_back(symbol);
+    }
+    Group* root = readTree(sections, next, arena, built, symbols);
+    if (root == NULL || next != header.element_count) return discard();
+    root->setStyle(arena.create< ComputedStyle >());
+
+    viewbox = ViewBox(header.viewbox[0], header.viewbox[1], header.viewbox[2],
+                      header.viewbox[3]);
+    viewport = Vector2Df(header.viewport[0], header.viewport[1]);
+    gradients.swap(loaded);
+    return root;
+}
@@ -0,0 +1,80 @@
+#ifndef SCENE_CACHE_HPP_
+#define SCENE_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "Graphics.hpp"
+#include "SceneArena.hpp"
+
+/**
+ * @brief Binary cache of a parsed scene.
+ *
+ * A cache file holds the tree of SVGElements of one document as flat,
+ * fixed-size records: the shapes in document order with their resolved
+ * colors and matrices, the subtrees of the symbols, written once however
+ * many times they are used, the points of the polygons and paths, the
+ * commands and arcs of the paths, the gradients with their stops, and a pool
+ * of the strings. It starts with a header holding a format version and the
+ * size and content hash of the source file, so a stale or foreign cache is
+ * detected and ignored.
+ *
+ * Reading a cache maps the file and builds the tree straight from the
+ * records, without any XML or text parsing.
+ */
+class SceneCache {
+public:
+    static constexpr std::uint32_t kVersion = 4;  ///< Version of the format
+
+    /**
+     * @brief Computes the content hash of a source file.
+     *
+     * @param data The content of the file.
+     * @param size The size of the file in bytes.
+     * @return The hash of the content.
+     */
+    static std::uint64_t hash(const char* data, std::size_t size);
+
+    /**
+     * @brief Writes the scene of a document to a cache file.
+     *
+     * @param file_name The name of the cache file.
+     * @param source_hash The content hash of the source file.
+     * @param source_size The size of the source file in bytes.
+     * @param root The root of the tree of SVGElements.
+     * @param gradients The gradients of the document, by id.
+     * @param viewbox The viewbox of the document.
+     * @param viewport The viewport of the document.
+     * @return True if the cache file was written.
+     * @note The file is written under a temporary name and renamed, so a
+     * reader never sees a partial cache.
+     */
+    static bool write(const std::string& file_name, std::uint64_t source_hash,
+                      std::uint64_t source_size, const Group* root,
+                      const std::map< std::string, Gradient* >& gradients,
+                      const ViewBox& viewbox, const Vector2Df& viewport);
+
+    /**
+     * @brief Reads the scene of a document from a cache file.
+     *
+     * @param file_name The name of the cache file.
+     * @param source_hash The content hash of the source file.
+     * @param source_size The size of the source file in bytes.
+     * @param arena The arena receiving the tree of SVGElements.
+     * @param gradients The map receiving the gradients of the document.
+     * @param viewbox The viewbox of the document.
+     * @param viewport The viewport of the document.
+     * @return The root of the tree of SVGElements, or NULL if the cache is
+     * missing, stale, of another version or corrupted.
+     * @note The elements read before a corrupted record stay in the arena
+     * until it is freed.
+     */
+    static Group* read(const std::string& file_name, std::uint64_t source_hash,
+                       std::uint64_t source_size, SceneArena& arena,
+                       std::map< std::string, Gradient* >& gradients,
+                       ViewBox& viewbox, Vector2Df& viewport);
+};
+
+#endif  // SCENE_CACHE_HPP_
@@ -0,0 +1,500 @@
+#include "ScenePicker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr int kMaxDepth = 24;        // Most halvings of a curve
+    constexpr float kTolerance = 0.01f;  // Flatness of the tested pieces,
+                                         // in units of the document
+    const float kPi = std::acos(-1.f);
+
+    // A piece of the outline of a shape
+    struct Curve {
+        enum Kind { Line, Cubic, Arc } kind;
+        Vector2Df p[4];     // Ends of a line, points of a Bezier curve, or
+                            // center and axes of an arc
+        float start_angle;  // Angle of the start of an arc
+        float sweep_angle;  // Signed angle of an arc
+        bool stroked;       // False for a line closing a figure for the fill
+    };
+
+    Curve makeLine(const Vector2Df& start, const Vector2Df& end,
+                   bool stroked = true) {
+        return {Curve::Line, {start, end}, 0, 0, stroked};
+    }
+
+    Vector2Df getArcPoint(const Curve& arc, float angle) {
+        return arc.p[0] + arc.p[1] * std::cos(angle) +
+               arc.p[2] * std::sin(angle);
+    }
+
+    Vector2Df getStart(const Curve& curve) {
+        if (curve.kind == Curve::Arc)
+            return getArcPoint(curve, curve.start_angle);
+        return curve.p[0];
+    }
+
+    Vector2Df getEnd(const Curve& curve) {
+        if (curve.kind == Curve::Arc)
+            return getArcPoint(curve, curve.start_angle + curve.sweep_angle);
+        return curve.kind == Curve::Line ? curve.p[1] : curve.p[3];
+    }
+
+    float getLength(const Vector2Df& v) { return std::hypot(v.x, v.y); }
+
+    // Get a box holding a curve: its control points, or the exact box of
+    // an arc
+    BoundingBox getHull(const Curve& curve) {
+        BoundingBox box;
+        if (curve.kind == Curve::Arc) {
+            box.addArc(curve.p[0], curve.p[1], curve.p[2], curve.start_angle,
+                       curve.sweep_angle);
+            return box;
+        }
+        for (int i = 0; i < (curve.kind == Curve::Line ? 2 : 4); ++i)
+            box.add(curve.p[i]);
+        return box;
+    }
+
+    // Get how far a curve strays from its chord. A cubic curve is its
+    // chord plus 3t(1 - t) at most of the offsets of its control points
+    // from the thirds of the chord
+    float getFlatness(const Curve& curve) {
+        if (curve.kind == Curve::Line) return 0;
+        if (curve.kind == Curve::Cubic) {
+            const Vector2Df* p = curve.p;
+            return 0.75f *
+                   std::max(getLength(p[1] - (p[0] * 2.f + p[3]) / 3.f),
+                            getLength(p[2] - (p[0] + p[3] * 2.f) / 3.f));
+        }
+        // An arc is a circular one mapped by its axes, its sagitta grows by
+        // the sum of their lengths at most
+        if (std::abs(curve.sweep_angle) > kPi)
+            return std::numeric_limits< float >::infinity();
+        return (getLength(curve.p[1]) + getLength(curve.p[2])) *
+               (1 - std::cos(curve.sweep_angle / 2));
+    }
+
+    // Split a curve in halves
+    void split(const Curve& curve, Curve& first, Curve& second) {
+        first = second = curve;
+        if (curve.kind == Curve::Arc) {
+            first.sweep_angle = curve.sweep_angle / 2;
+            second.start_angle = curve.start_angle + first.sweep_angle;
+            second.sweep_angle = curve.sweep_angle - first.sweep_angle;
+            return;
+        }
+        const Vector2Df* p = curve.p;
+        Vector2Df p01 = (p[0] + p[1]) * 0.5f, p12 = (p[1] + p[2]) * 0.5f;
+        Vector2Df p23 = (p[2] + p[3]) * 0.5f;
+        Vector2Df p012 = (p01 + p12) * 0.5f, p123 = (p12 + p23) * 0.5f;
+        Vector2Df middle = (p012 + p123) * 0.5f;
+        first.p[1] = p01;
+        first.p[2] = p012;
+        first.p[3] = middle;
+        second.p[0] = middle;
+        second.p[1] = p123;
+        second.p[2] = p23;
+    }
+
+    // Get on which side of the line through a and b a point is
+    double getSide(const Vector2Df& a, const Vector2Df& b,
+                   const Vector2Df& point) {
+        return ((double)b.x - a.x) * ((double)point.y - a.y) -
+               ((double)point.x - a.x) * ((double)b.y - a.y);
+    }
+
+    // Count the crossing of a line with the ray from a point to the right,
+    // signed by its direction. A crossing at an end is counted only for the
+    // line above it, so the lines meeting there count once
+    int getLineWinding(const Vector2Df& start, const Vector2Df& end,
+                       const Vector2Df& point) {
+        if (start.y <= point.y)
+            return end.y > point.y && getSide(start, end, point) > 0 ? 1 : 0;
+        return end.y <= point.y && getSide(start, end, point) < 0 ? -1 : 0;
+    }
+
+    // Count the crossings of a curve with the ray from a point to the right.
+    // A piece of the curve away from the ray, or wholly right of the point,
+    // crosses it as its chord does: only the pieces around the point are
+    // split, until they are flat
+    int getWinding(const Curve& curve, const Vector2Df& point,
+                   float tolerance, int depth = 0) {
+        if (curve.kind != Curve::Line) {
+            BoundingBox hull = getHull(curve);
+            if (hull.max.x < point.x || hull.min.y > point.y ||
+                hull.max.y < point.y)
+                return 0;
+            if (hull.min.x <= point.x && depth < kMaxDepth &&
+                getFlatness(curve) > tolerance) {
+                Curve first, second;
+                split(curve, first, second);
+                return getWinding(first, point, tolerance, depth + 1) +
+                       getWinding(second, point, tolerance, depth + 1);
+            }
+        }
+        return getLineWinding(getStart(curve), getEnd(curve), point);
+    }
+
+    // Get the distance from a point to a line
+    float getDistance(const Vector2Df& point, const Vector2Df& start,
+                      const Vector2Df& end) {
+        Vector2Df d = end - start, w = point - start;
+        float length = d.x * d.x + d.y * d.y;
+        float t = 0;
+        if (length > 0)
+            t = std::clamp((w.x * d.x + w.y * d.y) / length, 0.f, 1.f);
+        return getLength(w - d * t);
+    }
+
+    // Whether a curve comes within a distance of a point
+    bool isNear(const Curve& curve, const Vector2Df& point, float radius,
+                float tolerance, int depth = 0) {
+        if (curve.kind != Curve::Line) {
+            BoundingBox hull = getHull(curve);
+            hull.expand(radius);
+            if (point.x < hull.min.x || point.x > hull.max.x ||
+                point.y < hull.min.y || point.y > hull.max.y)
+                return false;
+            if (depth < kMaxDepth && getFlatness(curve) > tolerance) {
+                Curve first, second;
+                split(curve, first, second);
+                return isNear(first, point, radius, tolerance, depth + 1) ||
+                       isNear(second, point, radius, tolerance, depth + 1);
+            }
+        }
+        return getDistance(point, getStart(curve), getEnd(curve)) <= radius;
+    }
+
+    // An area of the document in the coordinates of a shape, a
+    // parallelogram
+    struct Area {
+        Vector2Df corners[4];  // Corners, in order around the area
+        BoundingBox box;       // Box of the corners
+    };
+
+    bool contains(const Area& area, const Vector2Df& point) {
+        if (point.x < area.box.min.x || point.x > area.box.max.x ||
+            point.y < area.box.min.y || point.y > area.box.max.y)
+            return false;
+        bool left = false, right = false;
+        for (int i = 0; i < 4; ++i) {
+            double side =
+                getSide(area.corners[i], area.corners[(i + 1) % 4], point);
+            left |= side > 0;
+            right |= side < 0;
+        }
+        return !(left && right);
+    }
+
+    // Whether two lines cross between their ends
+    bool crosses(const Vector2Df& a, const Vector2Df& b, const Vector2Df& c,
+                 const Vector2Df& d) {
+        double c_side = getSide(a, b, c), d_side = getSide(a, b, d);
+        double a_side = getSide(c, d, a), b_side = getSide(c, d, b);
+        return ((c_side > 0 && d_side < 0) || (c_side < 0 && d_side > 0)) &&
+               ((a_side > 0 && b_side < 0) || (a_side < 0 && b_side > 0));
+    }
+
+    // Get the distance from an area to a line
+    float getDistance(const Area& area, const Vector2Df& start,
+                      const Vector2Df& end) {
+        if (contains(area, start) || contains(area, end)) return 0;
+        float distance = std::numeric_limits< float >::infinity();
+        for (int i = 0; i < 4; ++i) {
+            const Vector2Df& a = area.corners[i];
+            const Vector2Df& b = area.corners[(i + 1) % 4];
+            if (crosses(start, end, a, b)) return 0;
+            distance = std::min({distance, getDistance(start, a, b),
+                                 getDistance(end, a, b),
+                                 getDistance(a, start, end)});
+        }
+        return distance;
+    }
+
+    // Whether a curve comes within a distance of an area
+    bool isNear(const Curve& curve, const Area& area, float radius,
+                float tolerance, int depth = 0) {
+        if (curve.kind != Curve::Line) {
+            BoundingBox hull = getHull(curve);
+            hull.expand(radius);
+            if (!hull.intersects(area.box)) return false;
+            if (depth < kMaxDepth && getFlatness(curve) > tolerance) {
+                Curve first, second;
+                split(curve, first, second);
+                return isNear(first, area, radius, tolerance, depth + 1) ||
+                       isNear(second, area, radius, tolerance, depth + 1);
+            }
+        }
+        return getDistance(area, getStart(curve), getEnd(curve)) <= radius;
+    }
+
+    // Collects the outline of a path, closing each figure for the fill
+    class OutlineVisitor : public PathVisitor {
+    public:
+        OutlineVisitor(std::vector< Curve >& curves) : curves(curves) {}
+
+        void moveTo(const Vector2Df& point) override {
+            finish();
+            first_point = cur_point = point;
+        }
+
+        void lineTo(const Vector2Df& start, const Vector2Df& end) override {
+            curves.push_back(makeLine(start, end));
+            cur_point = end;
+        }
+
+        // A quadratic curve is raised to the cubic curve drawing it
+        void quadraticTo(const Vector2Df& start, const Vector2Df& control,
+                         const Vector2Df& end) override {
+            cubicTo(start, start + (control - start) * (2.f / 3),
+                    end + (control - end) * (2.f / 3), end);
+        }
+
+        void cubicTo(const Vector2Df& start, const Vector2Df& control1,
+                     const Vector2Df& control2,
+                     const Vector2Df& end) override {
+            curves.push_back(
+                {Curve::Cubic, {start, control1, control2, end}, 0, 0, true});
+            cur_point = end;
+        }
+
+        void arcTo(const Vector2Df& start, const Vector2Df& end,
+                   const PathArc& arc) override {
+            CenterArc center_arc;
+            if (toCenterArc(start, end, arc, center_arc)) {
+                curves.push_back({Curve::Arc,
+                                  {center_arc.center, center_arc.u,
+                                   center_arc.v},
+                                  center_arc.start_angle,
+                                  center_arc.sweep_angle,
+                                  true});
+            } else if (start != end) {
+                curves.push_back(makeLine(start, end));
+            }
+            cur_point = end;
+        }
+
+        void close(const Vector2Df& start, const Vector2Df& end) override {
+            lineTo(start, end);
+        }
+
+        // Closes the last figure, for the fill only
+        void finish() {
+            if (cur_point != first_point)
+                curves.push_back(makeLine(cur_point, first_point, false));
+            cur_point = first_point;
+        }
+
+    private:
+        std::vector< Curve >& curves;
+        Vector2Df first_point{0, 0};  // First point of the figure
+        Vector2Df cur_point{0, 0};    // End of the last segment
+    };
+
+    // Collects the outline of a rectangle, rounded as its bounds are
+    void addRect(std::vector< Curve >& curves, const Vector2Df& position,
+                 const Vector2Df& size, const Vector2Df& radius) {
+        Vector2Df corner(std::abs(radius.x), std::abs(radius.y));
+        if (corner.x == 0 || corner.y == 0 || corner.x * 2 > std::abs(size.x) ||
+            corner.y * 2 > std::abs(size.y))
+            corner = Vector2Df(0, 0);
+        float left = position.x, top = position.y;
+        float right = left + size.x, bottom = top + size.y;
+        // The sides, clockwise from the top, each followed by its corner
+        Vector2Df sides[4][2] = {
+            {{left + corner.x, top}, {right - corner.x, top}},
+            {{right, top + corner.y}, {right, bottom - corner.y}},
+            {{right - corner.x, bottom}, {left + corner.x, bottom}},
+            {{left, bottom - corner.y}, {left, top + corner.y}}};
+        Vector2Df centers[4] = {{right - corner.x, top + corner.y},
+                                {right - corner.x, bottom - corner.y},
+                                {left + corner.x, bottom - corner.y},
+                                {left + corner.x, top + corner.y}};
+        for (int i = 0; i < 4; ++i) {
+            curves.push_back(makeLine(sides[i][0], sides[i][1]));
+            if (corner.x == 0) continue;
+            curves.push_back({Curve::Arc,
+                              {centers[i], Vector2Df(corner.x, 0),
+                               Vector2Df(0, corner.y)},
+                              kPi * (i - 1) / 2,
+                              kPi / 2,
+                              true});
+        }
+    }
+
+    // A shape of the store, ready to be tested in its own coordinates
+    struct Shape {
+        std::vector< Curve > curves;  // Outline of the shape
+        FillRule fill_rule;           // Fill rule of the outline
+        bool fill;                    // Whether the fill is painted
+        bool stroke;                  // Whether the outline is painted
+        float radius;                 // Half the thickness of the outline
+        float tolerance;              // Flatness of the tested pieces
+        AffineTransform inverse;      // Maps the document to the shape
+        bool ellipse;                 // Whether the shape is an ellipse
+        Vector2Df center;             // Center of an ellipse
+        Vector2Df axes;               // Radii of an ellipse
+    };
+
+    // Loads a shape of the store, returns false if nothing of it is painted
+    bool loadShape(const SceneStore& store, const StoreShape& found,
+                   Shape& shape) {
+        std::uint32_t index = found.index;
+        ElementKind kind = store.getKinds()[index];
+        const StoreStyle& style = store.getStyle(index);
+        shape.fill = style.fill.a > 0 || style.gradient != NULL;
+        shape.stroke = style.stroke.a > 0 && style.stroke_width > 0;
+        // A line has no inside, a text is hit anywhere in its box
+        if (kind == ElementKind::Line) shape.fill = false;
+        if (kind == ElementKind::Text) {
+            shape.fill = shape.fill || shape.stroke;
+            shape.stroke = false;
+        }
+        if (!shape.fill && !shape.stroke) return false;
+
+        // A matrix flattening the shape leaves nothing to hit
+        const AffineTransform& matrix = found.matrix;
+        if (matrix.a * matrix.d - matrix.b * matrix.c == 0) return false;
+        shape.inverse = matrix.getInverse();
+        shape.tolerance = kTolerance / matrix.getMaxScale();
+        shape.radius = style.stroke_width / 2;
+        shape.fill_rule = FillRule::NonZero;
+        shape.ellipse = false;
+
+        std::vector< Curve >& curves = shape.curves;
+        curves.clear();
+        std::span< const Vector2Df > points = store.getPoints(index);
+        const SVGElement* element = store.getElement(index);
+        switch (kind) {
+            case ElementKind::Line:
+                curves.push_back(makeLine(points[0], points[1]));
+                break;
+            case ElementKind::Rect:
+                addRect(curves, points[0], points[1], points[2]);
+                break;
+            case ElementKind::Circle:
+            case ElementKind::Ellipse:
+                shape.ellipse = true;
+                shape.center = points[0];
+                shape.axes = points[1];
+                curves.push_back({Curve::Arc,
+                                  {points[0], Vector2Df(points[1].x, 0),
+                                   Vector2Df(0, points[1].y)},
+                                  0,
+                                  2 * kPi,
+                                  true});
+                break;
+            case ElementKind::Polygon:
+            case ElementKind::Polyline: {
+                if (points.size() < 2) break;
+                for (std::size_t i = 1; i < points.size(); ++i)
+                    curves.push_back(makeLine(points[i - 1], points[i]));
+                // A polyline is filled as if closed, but not outlined so
+                curves.push_back(makeLine(points.back(), points[0],
+                                          kind == ElementKind::Polygon));
+                shape.fill_rule =
+                    static_cast< const PolyShape* >(element)->getFillRule();
+                break;
+            }
+            case ElementKind::Path: {
+                const Path* path = static_cast< const Path* >(element);
+                OutlineVisitor visitor(curves);
+                path->visit(visitor);
+                visitor.finish();
+                shape.fill_rule = path->getFillRule();
+                break;
+            }
+            case ElementKind::Text: {
+                const BoundingBox& box = element->getLocalBounds();
+                if (box.isEmpty()) break;
+                Vector2Df corners[4] = {box.min,
+                                        Vector2Df(box.max.x, box.min.y),
+                                        box.max,
+                                        Vector2Df(box.min.x, box.max.y)};
+                for (int i = 0; i < 4; ++i) {
+                    curves.push_back(
+                        makeLine(corners[i], corners[(i + 1) % 4], false));
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        return true;
+    }
+
+    // Whether a point, in the coordinates of a shape, is inside its fill
+    bool isInside(const Shape& shape, const Vector2Df& point) {
+        if (shape.ellipse) {
+            if (shape.axes.x <= 0 || shape.axes.y <= 0) return false;
+            float x = (point.x - shape.center.x) / shape.axes.x;
+            float y = (point.y - shape.center.y) / shape.axes.y;
+            return x * x + y * y <= 1;
+        }
+        int winding = 0;
+        for (const Curve& curve : shape.curves)
+            winding += getWinding(curve, point, shape.tolerance);
+        if (shape.fill_rule == FillRule::EvenOdd) return winding % 2 != 0;
+        return winding != 0;
+    }
+}  // namespace
+
+ScenePicker::ScenePicker(const SceneStore& store, const SceneBVH& bvh)
+    : store(store), bvh(bvh) {}
+
+void ScenePicker::hitTest(const Vector2Df& point,
+                          std::vector< StoreShape >& handles) const {
+    std::vector< StoreShape > candidates;
+    bvh.query(BoundingBox(point, point), candidates);
+    Shape shape;
+    for (const StoreShape& candidate : candidates) {
+        if (!loadShape(store, candidate, shape)) continue;
+        Vector2Df local = shape.inverse.apply(point);
+        bool hit = false;
+        if (shape.stroke) {
+            for (const Curve& curve : shape.curves) {
+                if (curve.stroked &&
+                    isNear(curve, local, shape.radius, shape.tolerance)) {
+                    hit = true;
+                    break;
+                }
+            }
+        }
+        if (!hit && shape.fill) hit = isInside(shape, local);
+        if (hit) handles.push_back(candidate);
+    }
+}
+
+void ScenePicker::query(const BoundingBox& area,
+                        std::vector< StoreShape >& handles) const {
+    std::vector< StoreShape > candidates;
+    bvh.query(area, candidates);
+    Shape shape;
+    for (const StoreShape& candidate : candidates) {
+        if (!loadShape(store, candidate, shape)) continue;
+        Area local;
+        Vector2Df corners[4] = {area.min, Vector2Df(area.max.x, area.min.y),
+                                area.max, Vector2Df(area.min.x, area.max.y)};
+        for (int i = 0; i < 4; ++i) {
+            local.corners[i] = shape.inverse.apply(corners[i]);
+            local.box.add(local.corners[i]);
+        }
+
+        // The area meets a shape if it crosses its painted outline or its
+        // fill boundary, or else lies inside the fill
+        bool hit = false;
+        for (const Curve& curve : shape.curves) {
+            if (curve.stroked && shape.stroke) {
+                hit = isNear(curve, local, shape.radius, shape.tolerance);
+            } else if (shape.fill) {
+                hit = isNear(curve, local, 0, shape.tolerance);
+            }
+            if (hit) break;
+        }
+        if (!hit && shape.fill) hit = isInside(shape, local.corners[0]);
+        if (hit) handles.push_back(candidate);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef SCENE_PICKER_HPP_
+#define SCENE_PICKER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "SceneBVH.hpp"
+
+/**
+ * @brief Finds the shapes of a parsed scene under a point or in an area.
+ *
+ * The SceneBVH gives the shapes whose bounds are hit, then the geometry of
+ * each is tested exactly in its own coordinates: the fill by the winding of
+ * its outline under its fill rule, the outline by the distance to it
+ * against half its thickness. Only the painted parts can be hit, a fill or
+ * an outline of a transparent color is left out. The shapes are returned
+ * as StoreShapes: the index in the SceneStore gives the element with
+ * SceneStore::getElement, and the matrix places the instance that was hit,
+ * the shapes of a symbol being stored once for all its uses.
+ *
+ * @note The curves and arcs follow the SVG definitions, as their bounds do.
+ * The texts are hit within the box their bounds estimate.
+ */
+class ScenePicker {
+public:
+    /**
+     * @brief Constructs a picker over a scene.
+     *
+     * @param store The store of the scene.
+     * @param bvh The hierarchy built over the store.
+     * @note The picker keeps references to both, it has to be dropped before
+     * they are rebuilt.
+     */
+    ScenePicker(const SceneStore& store, const SceneBVH& bvh);
+
+    /**
+     * @brief Finds the shapes painted under a point.
+     *
+     * @param point The point, in the coordinates of the document.
+     * @param handles Receives each shape hit, in paint order: the topmost
+     * one comes last.
+     */
+    void hitTest(const Vector2Df& point,
+                 std::vector< StoreShape >& handles) const;
+
+    /**
+     * @brief Finds the shapes painted in an area.
+     *
+     * @param area The area, in the coordinates of the document.
+     * @param handles Receives each shape with a painted part inside the
+     * area, in paint order.
+     */
+    void query(const BoundingBox& area,
+               std::vector< StoreShape >& handles) const;
+
+private:
+    const SceneStore& store;  ///< Store of the scene
+    const SceneBVH& bvh;      ///< Hierarchy over the store
+};
+
+#endif  // SCENE_PICKER_HPP_
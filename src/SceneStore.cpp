@@ -0,0 +1,362 @@
+#include "SceneStore.hpp"
+
+#include <array>
+#include <bit>
+#include <unordered_map>
+
+namespace {
+    // Hashes the words of a key
+    struct WordsHash {
+        template< std::size_t N >
+        std::size_t operator()(
+            const std::array< std::uint64_t, N >& words) const {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (std::uint64_t word : words) {
+                hash ^= word;
+                hash *= 1099511628211ull;
+                hash ^= hash >> 29;
+            }
+            return hash;
+        }
+    };
+
+    using StyleKey = std::array< std::uint64_t, 4 >;
+
+    // Packs the four channels of a color into one word
+    std::uint64_t pack(const ColorShape& color) {
+        return (std::uint64_t)(std::uint16_t)color.r << 48 |
+               (std::uint64_t)(std::uint16_t)color.g << 32 |
+               (std::uint64_t)(std::uint16_t)color.b << 16 |
+               (std::uint64_t)(std::uint16_t)color.a;
+    }
+}  // namespace
+
+struct SceneStore::Builder {
+    SceneStore& store;
+    std::unordered_map< StyleKey, std::uint32_t, WordsHash > style_ids;
+    std::unordered_map< const Group*, std::uint32_t >
+        symbol_roots;                     // Root of the subtree of each symbol
+    std::vector< const Group* > symbols;  // Symbols, in the order stored
+    std::unordered_map< std::uint32_t, std::size_t >
+        shape_counts;  // Shapes drawn by each bounded subtree, by root
+
+    // Get the index of the style of an element, adding it if it is new
+    std::uint32_t addStyle(const SVGElement* element) {
+        const ColorShape& fill = element->getFillColor();
+        const ColorShape& stroke = element->getOutlineColor();
+        float width = element->getOutlineThickness();
+        StyleKey key = {pack(fill), pack(stroke),
+                        std::bit_cast< std::uint32_t >(width),
+                        (std::uint64_t)(std::uintptr_t)element->getGradient()};
+        auto found = style_ids.try_emplace(key, store.styles.size());
+        if (found.second) {
+            store.styles.push_back(
+                {fill, stroke, width, element->getGradient()});
+        }
+        return found.first->second;
+    }
+
+    // Copy the geometry of an element
+    GeometryRange addGeometry(const SVGElement* element) {
+        std::vector< Vector2Df >& points = store.points;
+        GeometryRange range;
+        range.first = points.size();
+        switch (element->getKind()) {
+            case ElementKind::Line:
+                points.push_back(element->getPosition());
+                points.push_back(
+                    static_cast< const Line* >(element)->getDirection());
+                break;
+            case ElementKind::Rect: {
+                const Rect* rect = static_cast< const Rect* >(element);
+                points.push_back(rect->getPosition());
+                points.push_back(
+                    Vector2Df(rect->getWidth(), rect->getHeight()));
+                points.push_back(rect->getRadius());
+                break;
+            }
+            case ElementKind::Circle:
+            case ElementKind::Ellipse:
+                points.push_back(element->getPosition());
+                points.push_back(
+                    static_cast< const Ell* >(element)->getRadius());
+                break;
+            case ElementKind::Polygon:
+            case ElementKind::Polyline: {
+                const auto& vertices =
+                    static_cast< const PolyShape* >(element)->getPoints();
+                points.insert(points.end(), vertices.begin(), vertices.end());
+                break;
+            }
+            case ElementKind::Path: {
+                PathView path =
+                    static_cast< const Path* >(element)->getGeometry();
+                points.insert(points.end(), path.points.begin(),
+                              path.points.end());
+                break;
+            }
+            case ElementKind::Text:
+                points.push_back(element->getPosition());
+                break;
+            default:
+                break;
+        }
+        range.count = points.size() - range.first;
+        return range;
+    }
+
+    // Append one element, returns its index
+    std::uint32_t addElement(SVGElement* element, std::uint32_t parent,
+                             std::uint32_t parent_matrix) {
+        // An element without a transform shares the matrix of its parent.
+        // The other matrices are rarely equal, they are not looked up
+        std::uint32_t matrix = parent_matrix;
+        if (!element->getTransform().isIdentity()) {
+            AffineTransform world =
+                store.matrices[parent_matrix] * element->getTransform();
+            matrix = store.matrices.size();
+            store.matrices.push_back(world);
+        }
+        // The geometry is bounded through the matrix, as tight as the shape
+        // allows. Groups and uses are bounded by their subtree
+        const AffineTransform& world = store.matrices[matrix];
+        BoundingBox box;
+        if (element->getKind() != ElementKind::Group &&
+            element->getKind() != ElementKind::Use)
+            box = element->getBounds(world);
+
+        store.kinds.push_back(element->getKind());
+        store.parents.push_back(parent);
+        store.ends.push_back(store.kinds.size());
+        store.style_ids.push_back(addStyle(element));
+        store.matrix_ids.push_back(matrix);
+        store.bounds.push_back(box);
+        store.geometry.push_back(addGeometry(element));
+        store.elements.push_back(element);
+        store.symbol_ids.push_back(kNone);
+        return store.kinds.size() - 1;
+    }
+
+    // Append the root of the tree or of the subtree of a symbol, drawn
+    // without the transform of its group, as the renderer does
+    std::uint32_t addRoot(const Group* group) {
+        std::uint32_t index = store.kinds.size();
+        store.kinds.push_back(group->getKind());
+        store.parents.push_back(kNone);
+        store.ends.push_back(index + 1);
+        store.style_ids.push_back(addStyle(group));
+        store.matrix_ids.push_back(0);
+        store.bounds.push_back(BoundingBox());
+        store.geometry.push_back(GeometryRange());
+        store.elements.push_back(const_cast< Group* >(group));
+        store.symbol_ids.push_back(kNone);
+        return index;
+    }
+
+    // Append the subtree under an element, walking it depth first without
+    // recursion, as deep as the parser builds it. The symbols of the uses
+    // met are queued to be stored once, after the tree
+    void addChildren(const Group* group, std::uint32_t index) {
+        struct Frame {
+            const Group* group;   // Group whose children are appended
+            std::size_t next;     // Next child to append
+            std::uint32_t index;  // Element the children belong to
+        };
+        std::vector< Frame > stack = {{group, 0, index}};
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            const auto& children = frame.group->getElements();
+            if (frame.next == children.size()) {
+                store.ends[frame.index] = store.kinds.size();
+                stack.pop_back();
+                continue;
+            }
+            SVGElement* element = children[frame.next++];
+            std::uint32_t child = addElement(element, frame.index,
+                                             store.matrix_ids[frame.index]);
+            if (element->getKind() == ElementKind::Group) {
+                stack.push_back(
+                    {static_cast< const Group* >(element), 0, child});
+            } else if (element->getKind() == ElementKind::Use) {
+                const Group* symbol =
+                    static_cast< const Use* >(element)->getSymbol();
+                if (symbol != NULL &&
+                    symbol_roots.try_emplace(symbol, kNone).second)
+                    symbols.push_back(symbol);
+            }
+        }
+    }
+
+    // Complete the bounds of the subtree under a root, after those of the
+    // symbols its uses draw, returns the number of shapes it draws. The
+    // parser cuts the symbols using themselves, so this ends
+    std::size_t addBounds(std::uint32_t root) {
+        auto found = shape_counts.find(root);
+        if (found != shape_counts.end()) return found->second;
+        std::size_t count = 0;
+        std::uint32_t end = store.ends[root];
+        for (std::uint32_t i = root + 1; i < end; ++i) {
+            if (store.kinds[i] == ElementKind::Group) continue;
+            if (store.kinds[i] != ElementKind::Use) {
+                ++count;
+                continue;
+            }
+            std::uint32_t symbol = store.symbol_ids[i];
+            if (symbol == kNone) continue;
+            count += addBounds(symbol);
+            store.bounds[i] =
+                store.bounds[symbol].transform(store.getMatrix(i));
+        }
+        // The descendants of an element come after it, so walking backwards
+        // completes the bounds of each subtree before adding them to its
+        // parent
+        for (std::uint32_t i = end; i-- > root + 1;)
+            store.bounds[store.parents[i]].add(store.bounds[i]);
+        shape_counts.emplace(root, count);
+        return count;
+    }
+};
+
+void SceneStore::build(Group* root) {
+    *this = SceneStore();
+    if (root == NULL) return;
+    Builder builder{*this, {}, {}, {}, {}};
+    matrices.push_back(AffineTransform());
+
+    // The root is drawn without its own transform
+    builder.addChildren(root, builder.addRoot(root));
+
+    // Each symbol is stored once after the tree, queueing the symbols its
+    // own uses draw, then the uses are pointed at their subtree
+    for (std::size_t i = 0; i < builder.symbols.size(); ++i) {
+        const Group* symbol = builder.symbols[i];
+        std::uint32_t index = builder.addRoot(symbol);
+        builder.symbol_roots[symbol] = index;
+        builder.addChildren(symbol, index);
+    }
+    for (std::uint32_t i = 0; i < kinds.size(); ++i) {
+        if (kinds[i] != ElementKind::Use) continue;
+        const Group* symbol =
+            static_cast< const Use* >(elements[i])->getSymbol();
+        if (symbol != NULL) symbol_ids[i] = builder.symbol_roots[symbol];
+    }
+    shape_count = builder.addBounds(0);
+
+    // The arrays are kept as long as the document, without their slack
+    kinds.shrink_to_fit();
+    parents.shrink_to_fit();
+    ends.shrink_to_fit();
+    style_ids.shrink_to_fit();
+    matrix_ids.shrink_to_fit();
+    bounds.shrink_to_fit();
+    geometry.shrink_to_fit();
+    elements.shrink_to_fit();
+    symbol_ids.shrink_to_fit();
+    styles.shrink_to_fit();
+    matrices.shrink_to_fit();
+    points.shrink_to_fit();
+}
+
+std::size_t SceneStore::size() const { return kinds.size(); }
+
+std::size_t SceneStore::getTreeSize() const {
+    return ends.empty() ? 0 : ends[0];
+}
+
+std::size_t SceneStore::getShapeCount() const { return shape_count; }
+
+std::span< const ElementKind > SceneStore::getKinds() const { return kinds; }
+
+std::span< const std::uint32_t > SceneStore::getParents() const {
+    return parents;
+}
+
+std::span< const std::uint32_t > SceneStore::getEnds() const { return ends; }
+
+std::span< const BoundingBox > SceneStore::getBounds() const {
+    return bounds;
+}
+
+const StoreStyle& SceneStore::getStyle(std::uint32_t index) const {
+    return styles[style_ids[index]];
+}
+
+const AffineTransform& SceneStore::getMatrix(std::uint32_t index) const {
+    return matrices[matrix_ids[index]];
+}
+
+std::span< const std::uint32_t > SceneStore::getMatrixIndices() const {
+    return matrix_ids;
+}
+
+std::span< const Vector2Df > SceneStore::getPoints(std::uint32_t index) const {
+    const GeometryRange& range = geometry[index];
+    return std::span< const Vector2Df >(points.data() + range.first,
+                                        range.count);
+}
+
+SVGElement* SceneStore::getElement(std::uint32_t index) const {
+    return elements[index];
+}
+
+std::uint32_t SceneStore::getSymbol(std::uint32_t index) const {
+    return symbol_ids[index];
+}
+
+void SceneStore::query(const BoundingBox& area,
+                       std::vector< StoreShape >& shapes) const {
+    if (kinds.empty()) return;
+    // Each frame walks the tree or the subtree of a symbol for one instance,
+    // with the area mapped to the coordinates of the instance
+    struct Frame {
+        std::uint32_t next;      // Next element to visit
+        std::uint32_t end;       // End of the subtree
+        AffineTransform matrix;  // Matrix of the instance
+        BoundingBox area;        // Area, in the coordinates of the instance
+    };
+    std::vector< Frame > stack = {{0, ends[0], AffineTransform(), area}};
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (frame.next == frame.end) {
+            stack.pop_back();
+            continue;
+        }
+        // A subtree outside the area is skipped as a whole
+        std::uint32_t i = frame.next;
+        if (!bounds[i].intersects(frame.area)) {
+            frame.next = ends[i];
+            continue;
+        }
+        frame.next = i + 1;
+        if (kinds[i] == ElementKind::Group) continue;
+        const AffineTransform& matrix = getMatrix(i);
+        if (kinds[i] != ElementKind::Use) {
+            shapes.push_back({i, frame.matrix * matrix});
+            continue;
+        }
+        // A matrix flattening the instance leaves nothing to find
+        std::uint32_t symbol = symbol_ids[i];
+        if (symbol == kNone || matrix.a * matrix.d - matrix.b * matrix.c == 0)
+            continue;
+        Frame instance = {symbol + 1, ends[symbol], frame.matrix * matrix,
+                          frame.area.transform(matrix.getInverse())};
+        stack.push_back(instance);
+    }
+}
+
+std::size_t SceneStore::getStyleCount() const { return styles.size(); }
+
+std::size_t SceneStore::getMatrixCount() const { return matrices.size(); }
+
+std::size_t SceneStore::getBytesUsed() const {
+    return kinds.capacity() * sizeof(ElementKind) +
+           (parents.capacity() + ends.capacity() + style_ids.capacity() +
+            matrix_ids.capacity() + symbol_ids.capacity()) *
+               sizeof(std::uint32_t) +
+           bounds.capacity() * sizeof(BoundingBox) +
+           geometry.capacity() * sizeof(GeometryRange) +
+           elements.capacity() * sizeof(SVGElement*) +
+           styles.capacity() * sizeof(StoreStyle) +
+           matrices.capacity() * sizeof(AffineTransform) +
+           points.capacity() * sizeof(Vector2Df);
+}
@@ -0,0 +1,238 @@
+#ifndef SCENE_STORE_HPP_
+#define SCENE_STORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Graphics.hpp"
+#include "graphics/BoundingBox.hpp"
+
+/**
+ * @brief The paint of the elements of a SceneStore, shared by the elements
+ * drawn alike.
+ */
+struct StoreStyle {
+    ColorShape fill;                  ///< Fill color
+    ColorShape stroke;                ///< Outline color
+    float stroke_width = 0.f;         ///< Outline thickness
+    const Gradient* gradient = NULL;  ///< Fill gradient, NULL if none
+};
+
+/**
+ * @brief The points of one element in the geometry of a SceneStore.
+ *
+ * A line holds its two ends, a rectangle its position, size and radius, a
+ * circle or an ellipse its center and radius, a text its position, and a
+ * polygon, a polyline or a path its vertices. Groups and uses hold none.
+ */
+struct GeometryRange {
+    std::uint32_t first = 0;  ///< First point
+    std::uint32_t count = 0;  ///< Number of points
+};
+
+/**
+ * @brief A shape found in a SceneStore, with the matrix of its instance.
+ *
+ * The shapes of a symbol are stored once for all the <use> elements of it,
+ * so their index alone does not place them in the document: the matrix
+ * does, for the instance the shape was found in.
+ */
+struct StoreShape {
+    std::uint32_t index = 0;  ///< Index of the shape in the store
+    AffineTransform matrix;   ///< World matrix of the shape
+};
+
+/**
+ * @brief A flattened, structure-of-arrays copy of the tree of SVGElements.
+ *
+ * Element i of the store is the i-th element of the tree in paint order, up
+ * to getTreeSize(). The subtree of each symbol follows, stored once with its
+ * own root whatever the number of its instances: a <use> is a leaf holding
+ * the matrix of its instance, and getSymbol() gives the root of the subtree
+ * drawn through that matrix. Every property lives in its own contiguous
+ * array, so culling, bounds and drawing are linear scans over the few arrays
+ * they read. The descendants of element i are the elements i + 1 to
+ * getEnds()[i] - 1, so a scan skips a subtree by jumping to its end. The
+ * styles are stored once and referred to by index, and an element without a
+ * transform shares the matrix of its parent. The tree keeps owning the
+ * elements: getElement() leads back to the SVGElement of an index, for the
+ * code written against the Group API.
+ */
+class SceneStore {
+public:
+    static constexpr std::uint32_t kNone =
+        UINT32_MAX;  ///< Parent of the root element
+
+    /**
+     * @brief Replaces the content of the store with a tree.
+     *
+     * @param root The root of the tree, drawn without its own transform, as
+     * the renderer does.
+     */
+    void build(Group* root);
+
+    /**
+     * @brief Gets the number of elements.
+     *
+     * @return The number of elements, the root and the subtrees of the
+     * symbols included.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the number of elements of the tree of the document.
+     *
+     * @return The number of elements before the subtrees of the symbols.
+     */
+    std::size_t getTreeSize() const;
+
+    /**
+     * @brief Gets the number of shapes drawn by the document.
+     *
+     * @return The number of elements other than groups and uses, those of a
+     * symbol counted once per instance of it.
+     */
+    std::size_t getShapeCount() const;
+
+    /**
+     * @brief Gets the kind of every element.
+     *
+     * @return The kinds, by index.
+     */
+    std::span< const ElementKind > getKinds() const;
+
+    /**
+     * @brief Gets the parent of every element.
+     *
+     * @return The index of the parents, kNone for the root.
+     */
+    std::span< const std::uint32_t > getParents() const;
+
+    /**
+     * @brief Gets the end of the subtree of every element.
+     *
+     * @return One past the index of the last descendant, by index.
+     */
+    std::span< const std::uint32_t > getEnds() const;
+
+    /**
+     * @brief Gets the bounds of every element in the coordinates of the
+     * document, or of the symbol for the subtree of a symbol.
+     *
+     * @return The bounds, by index. A group bounds its subtree, and a use
+     * the subtree of its symbol mapped through its matrix.
+     *
+     * @note The geometry is mapped through the matrix before it is bounded,
+     * see SVGElement::getBounds(). The bounds of a text are estimated from
+     * its font size.
+     */
+    std::span< const BoundingBox > getBounds() const;
+
+    /**
+     * @brief Gets the style of an element.
+     *
+     * @param index The index of the element.
+     * @return The colors, outline thickness and gradient of the element.
+     */
+    const StoreStyle& getStyle(std::uint32_t index) const;
+
+    /**
+     * @brief Gets the matrix of an element.
+     *
+     * @param index The index of the element.
+     * @return The transforms of the element and of its ancestors, composed.
+     * In the subtree of a symbol, it maps to the coordinates of the symbol:
+     * the matrix of the instance is applied after it.
+     */
+    const AffineTransform& getMatrix(std::uint32_t index) const;
+
+    /**
+     * @brief Gets the index of the matrix of every element.
+     *
+     * @return The indices, equal for the elements drawn with the same matrix.
+     */
+    std::span< const std::uint32_t > getMatrixIndices() const;
+
+    /**
+     * @brief Gets the geometry of an element.
+     *
+     * @param index The index of the element.
+     * @return The points of the element, in its own coordinates.
+     */
+    std::span< const Vector2Df > getPoints(std::uint32_t index) const;
+
+    /**
+     * @brief Gets the SVGElement of an index.
+     *
+     * @param index The index of the element.
+     * @return The element of the tree, shared by the instances of a symbol.
+     */
+    SVGElement* getElement(std::uint32_t index) const;
+
+    /**
+     * @brief Gets the subtree drawn by a use.
+     *
+     * @param index The index of the use.
+     * @return The index of the root of the subtree of its symbol, kNone if
+     * the use draws nothing or the element is not a use.
+     */
+    std::uint32_t getSymbol(std::uint32_t index) const;
+
+    /**
+     * @brief Finds the shapes overlapping an area.
+     *
+     * @param area The area, in the coordinates of the document.
+     * @param shapes Receives the shapes, other than groups and uses, whose
+     * bounds overlap the area, in paint order. A shape of a symbol is found
+     * once per instance overlapping the area.
+     *
+     * @note The subtrees whose bounds miss the area are skipped.
+     */
+    void query(const BoundingBox& area,
+               std::vector< StoreShape >& shapes) const;
+
+    /**
+     * @brief Gets the number of distinct styles.
+     *
+     * @return The number of styles shared by the elements.
+     */
+    std::size_t getStyleCount() const;
+
+    /**
+     * @brief Gets the number of matrices.
+     *
+     * @return The number of matrices shared by the elements.
+     */
+    std::size_t getMatrixCount() const;
+
+    /**
+     * @brief Gets the memory taken by the store.
+     *
+     * @return The bytes of all the arrays.
+     */
+    std::size_t getBytesUsed() const;
+
+private:
+    /**
+     * @brief The state of build(), dropped once the store is built.
+     */
+    struct Builder;
+
+    std::vector< ElementKind > kinds;         ///< Kind of each element
+    std::vector< std::uint32_t > parents;     ///< Parent of each element
+    std::vector< std::uint32_t > ends;        ///< End of each subtree
+    std::vector< std::uint32_t > style_ids;   ///< Style of each element
+    std::vector< std::uint32_t > matrix_ids;  ///< Matrix of each element
+    std::vector< BoundingBox > bounds;        ///< Bounds of each element
+    std::vector< GeometryRange > geometry;    ///< Points of each element
+    std::vector< SVGElement* > elements;      ///< Element of each index
+    std::vector< std::uint32_t > symbol_ids;  ///< Subtree drawn by each use
+    std::vector< StoreStyle > styles;         ///< Distinct styles
+    std::vector< AffineTransform > matrices;  ///< Matrices of the elements
+    std::vector< Vector2Df > points;          ///< Geometry of the elements
+    std::size_t shape_count = 0;              ///< Shapes drawn by the tree
+};
+
+#endif  // SCENE_STORE_HPP_
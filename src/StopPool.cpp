@@ -0,0 +1,56 @@
+#include "StopPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Stops are equal when their colors and the bits of their offsets are
+    std::uint32_t offsetBits(float offset) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &offset, sizeof(bits));
+        return bits;
+    }
+
+    bool equal(const Stop& left, const Stop& right) {
+        ColorShape a = left.getColor(), b = right.getColor();
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a &&
+               offsetBits(left.getOffset()) == offsetBits(right.getOffset());
+    }
+}  // namespace
+
+std::uint64_t StopPool::hash(const std::vector< Stop >& stops) {
+    // FNV-1a over one word per stop
+    std::uint64_t result = 0xCBF29CE484222325ull;
+    for (const Stop& stop : stops) {
+        ColorShape color = stop.getColor();
+        std::uint64_t word =
+            std::uint64_t(color.r & 0xFF) | std::uint64_t(color.g & 0xFF) << 8 |
+            std::uint64_t(color.b & 0xFF) << 16 |
+            std::uint64_t(color.a & 0xFF) << 24 |
+            std::uint64_t(offsetBits(stop.getOffset())) << 32;
+        result = (result ^ word) * 0x100000001B3ull;
+    }
+    return result ^ (result >> 29);
+}
+
+StopRamp StopPool::intern(std::vector< Stop > stops) {
+    std::uint64_t key = hash(stops);
+    auto range = ramps.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        const std::vector< Stop >& ramp = *it->second;
+        if (std::equal(ramp.begin(), ramp.end(), stops.begin(), stops.end(),
+                       equal)) {
+            bytes_saved +=
+                sizeof(std::vector< Stop >) + stops.size() * sizeof(Stop);
+            return it->second;
+        }
+    }
+    StopRamp ramp =
+        std::make_shared< const std::vector< Stop > >(std::move(stops));
+    ramps.emplace(key, ramp);
+    return ramp;
+}
+
+std::size_t StopPool::getUniqueCount() const { return ramps.size(); }
+
+std::size_t StopPool::getBytesSaved() const { return bytes_saved; }
@@ -0,0 +1,57 @@
+#ifndef STOP_POOL_HPP_
+#define STOP_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/Stop.hpp"
+
+/**
+ * @brief Interning pool of the stop lists of the gradients of a document.
+ *
+ * Exported artwork often holds many gradients with identical stops. The
+ * StopPool hashes the content of every stop list it is given and returns the
+ * ramp already stored for an equal list, so each distinct list is stored
+ * once and shared by all the gradients using it.
+ */
+class StopPool {
+public:
+    /**
+     * @brief Gets the shared ramp holding a list of stops.
+     *
+     * @param stops The stops of a gradient.
+     * @return The ramp of the pool equal to the stops, stored on first use.
+     */
+    StopRamp intern(std::vector< Stop > stops);
+
+    /**
+     * @brief Gets the number of distinct ramps stored.
+     *
+     * @return The number of distinct ramps.
+     */
+    std::size_t getUniqueCount() const;
+
+    /**
+     * @brief Gets the memory saved by sharing the ramps.
+     *
+     * @return The bytes the duplicate lists would have taken.
+     */
+    std::size_t getBytesSaved() const;
+
+private:
+    /**
+     * @brief Hashes the colors and offsets of a list of stops.
+     *
+     * @param stops The stops to be hashed.
+     * @return The hash of the stops.
+     */
+    static std::uint64_t hash(const std::vector< Stop >& stops);
+
+    std::unordered_multimap< std::uint64_t, StopRamp > ramps;  ///< Ramps by
+                                                               ///< hash
+    std::size_t bytes_saved = 0;  ///< Bytes of the duplicate lists
+};
+
+#endif  // STOP_POOL_HPP_
@@ -0,0 +1,233 @@
+#include "StyleSheet.hpp"
+
+#include <algorithm>
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+        while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+        return text;
+    }
+
+    // Characters of a CSS identifier, enough for the names of the exports
+    bool isNameChar(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '-' || c == '_' ||
+               (unsigned char)c >= 0x80;
+    }
+
+    // Calls a function for every whitespace-separated class of a class
+    // attribute, until it returns true
+    template< typename Function >
+    bool anyClass(std::string_view classes, Function function) {
+        std::size_t i = 0;
+        while (i < classes.size()) {
+            while (i < classes.size() && isSpace(classes[i])) ++i;
+            std::size_t start = i;
+            while (i < classes.size() && !isSpace(classes[i])) ++i;
+            if (i > start && function(classes.substr(start, i - start)))
+                return true;
+        }
+        return false;
+    }
+
+    // The rules matching the element being styled, reused between elements
+    thread_local std::vector< std::size_t > candidates;
+}  // namespace
+
+bool StyleSheet::isProperty(AttributeId id) {
+    switch (id) {
+        case AttributeId::Fill:
+        case AttributeId::FillOpacity:
+        case AttributeId::FillRule:
+        case AttributeId::Stroke:
+        case AttributeId::StrokeOpacity:
+        case AttributeId::StrokeWidth:
+        case AttributeId::Opacity:
+        case AttributeId::Color:
+        case AttributeId::StopColor:
+        case AttributeId::StopOpacity:
+        case AttributeId::FontSize:
+        case AttributeId::FontStyle:
+        case AttributeId::TextAnchor:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void StyleSheet::parseDeclarations(std::string_view text,
+                                   std::vector< Declaration >& declarations) {
+    while (!text.empty()) {
+        std::size_t end = std::min(text.find(';'), text.size());
+        std::string_view declaration = text.substr(0, end);
+        text.remove_prefix(std::min(end + 1, text.size()));
+
+        std::size_t colon = declaration.find(':');
+        if (colon == std::string_view::npos) continue;
+        std::string_view name = trim(declaration.substr(0, colon));
+        AttributeId id = AttributeTable::lookup(name);
+        if (!isProperty(id)) continue;
+        std::string_view value = trim(declaration.substr(colon + 1));
+        std::size_t important = value.find('!');
+        if (important != std::string_view::npos)
+            value = trim(value.substr(0, important));
+        if (!value.empty()) declarations.push_back({id, value});
+    }
+}
+
+void StyleSheet::parse(std::string_view text) {
+    // The comments are blanked out once, so that the rules can be split on
+    // braces and semicolons
+    std::string& source = sources.emplace_back(text);
+    for (std::size_t start = source.find("/*"); start != std::string::npos;
+         start = source.find("/*", start)) {
+        std::size_t end = source.find("*/", start + 2);
+        end = end == std::string::npos ? source.size() : end + 2;
+        std::fill(source.begin() + start, source.begin() + end, ' ');
+    }
+
+    std::string_view css = source;
+    while (true) {
+        std::size_t open = css.find('{');
+        if (open == std::string_view::npos) break;
+        std::string_view prelude = trim(css.substr(0, open));
+
+        // At-rules with a block (@media, @font-face) are skipped with their
+        // nested blocks, those without one end at their semicolon
+        if (!prelude.empty() && prelude.front() == '@') {
+            std::size_t semicolon = prelude.find(';');
+            if (semicolon != std::string_view::npos) {
+                css.remove_prefix(css.find(';') + 1);
+                continue;
+            }
+            int depth = 0;
+            std::size_t i = open;
+            for (; i < css.size(); ++i) {
+                if (css[i] == '{') ++depth;
+                if (css[i] == '}' && --depth == 0) break;
+            }
+            css.remove_prefix(std::min(i + 1, css.size()));
+            continue;
+        }
+
+        std::size_t close = css.find('}', open);
+        if (close == std::string_view::npos) close = css.size();
+        std::size_t first = declarations.size();
+        parseDeclarations(css.substr(open + 1, close - open - 1),
+                          declarations);
+        std::size_t count = declarations.size() - first;
+        css.remove_prefix(std::min(close + 1, css.size()));
+        if (count == 0) continue;
+
+        while (!prelude.empty()) {
+            std::size_t comma = std::min(prelude.find(','), prelude.size());
+            addRule(trim(prelude.substr(0, comma)), first, count);
+            prelude.remove_prefix(std::min(comma + 1, prelude.size()));
+        }
+    }
+}
+
+void StyleSheet::addRule(std::string_view selector, std::size_t first,
+                         std::size_t count) {
+    Rule rule{};
+    rule.first = first;
+    rule.count = count;
+    std::size_t i = 0;
+    if (i < selector.size() && selector[i] == '*') {
+        ++i;
+    } else {
+        while (i < selector.size() && isNameChar(selector[i])) ++i;
+        rule.type = selector.substr(0, i);
+    }
+    while (i < selector.size()) {
+        char prefix = selector[i++];
+        std::size_t start = i;
+        while (i < selector.size() && isNameChar(selector[i])) ++i;
+        std::string_view name = selector.substr(start, i - start);
+        if (name.empty()) return;
+        if (prefix == '.') {
+            rule.classes.push_back(name);
+        } else if (prefix == '#' && rule.id.empty()) {
+            rule.id = name;
+        } else {
+            // Combinators, attribute selectors and pseudo-classes
+            return;
+        }
+    }
+    if (selector.empty()) return;
+
+    rule.specificity = (rule.id.empty() ? 0 : 10000) +
+                       100 * (int)rule.classes.size() +
+                       (rule.type.empty() ? 0 : 1);
+    std::size_t index = rules.size();
+    if (!rule.id.empty())
+        by_id[rule.id].push_back(index);
+    else if (!rule.classes.empty())
+        by_class[rule.classes.front()].push_back(index);
+    else if (!rule.type.empty())
+        by_type[rule.type].push_back(index);
+    else
+        universal.push_back(index);
+    rules.push_back(std::move(rule));
+}
+
+bool StyleSheet::matches(const Rule& rule, std::string_view type,
+                         std::string_view id, std::string_view classes) {
+    if (!rule.type.empty() && rule.type != type) return false;
+    if (!rule.id.empty() && rule.id != id) return false;
+    for (std::string_view name : rule.classes) {
+        if (!anyClass(classes,
+                      [name](std::string_view other) { return other == name; }))
+            return false;
+    }
+    return true;
+}
+
+void StyleSheet::match(std::string_view type, std::string_view id,
+                       std::string_view classes,
+                       std::vector< Declaration >& declarations) const {
+    candidates.clear();
+    auto collect = [this, type, id, classes](const Index& index,
+                                             std::string_view key) {
+        auto found = index.find(key);
+        if (found == index.end()) return;
+        for (std::size_t rule : found->second) {
+            if (matches(rules[rule], type, id, classes))
+                candidates.push_back(rule);
+        }
+    };
+    if (!id.empty()) collect(by_id, id);
+    anyClass(classes, [&](std::string_view name) {
+        collect(by_class, name);
+        return false;
+    });
+    collect(by_type, type);
+    for (std::size_t rule : universal) candidates.push_back(rule);
+    if (candidates.empty()) return;
+
+    // Less specific rules first, then document order, so that the winning
+    // declarations come last. A class listed twice matches its rules twice,
+    // which does not change the result.
+    std::sort(candidates.begin(), candidates.end(),
+              [this](std::size_t left, std::size_t right) {
+                  if (rules[left].specificity != rules[right].specificity)
+                      return rules[left].specificity <
+                             rules[right].specificity;
+                  return left < right;
+              });
+    for (std::size_t rule : candidates) {
+        const Rule& matched = rules[rule];
+        declarations.insert(
+            declarations.end(), this->declarations.begin() + matched.first,
+            this->declarations.begin() + matched.first + matched.count);
+    }
+}
+
+bool StyleSheet::empty() const { return rules.empty(); }
+
+std::size_t StyleSheet::getRuleCount() const { return rules.size(); }
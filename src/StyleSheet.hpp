@@ -0,0 +1,137 @@
+#ifndef STYLE_SHEET_HPP_
+#define STYLE_SHEET_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "AttributeTable.hpp"
+
+/**
+ * @brief The CSS rules of the <style> elements of a document.
+ *
+ * The declarations of every rule are parsed once, when the style sheet is
+ * read, into the interned attribute ids of the AttributeTable. The rules are
+ * indexed by the id, the first class or the type of their selector, so an
+ * element only looks up its own id, classes and type in hash maps instead of
+ * testing every rule. Selectors made of a type, an id and classes are
+ * supported ("rect", ".st0", "#logo", "path.st1.st2", "*"); selectors with
+ * combinators, attributes or pseudo-classes are ignored.
+ */
+class StyleSheet {
+public:
+    /**
+     * @brief A property set by a rule or by a style attribute.
+     */
+    struct Declaration {
+        AttributeId id;          ///< The property
+        std::string_view value;  ///< The value, without !important
+    };
+
+    /**
+     * @brief Adds the rules of a style sheet.
+     *
+     * @param text The content of a <style> element.
+     * @note Rules added later win over earlier rules of the same
+     * specificity, as in CSS.
+     */
+    void parse(std::string_view text);
+
+    /**
+     * @brief Checks whether the style sheet has no rule.
+     *
+     * @return True if no rule was added.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the number of rules, one per selector.
+     *
+     * @return The number of rules.
+     */
+    std::size_t getRuleCount() const;
+
+    /**
+     * @brief Finds the declarations of the rules matching an element.
+     *
+     * @param type The name of the element.
+     * @param id The id of the element, empty if none.
+     * @param classes The class attribute of the element, empty if none.
+     * @param declarations The list receiving the declarations, in the order
+     * they apply: a later declaration overrides an earlier one.
+     */
+    void match(std::string_view type, std::string_view id,
+               std::string_view classes,
+               std::vector< Declaration >& declarations) const;
+
+    /**
+     * @brief Parses a list of declarations, such as a style attribute.
+     *
+     * @param text The declarations, separated by semicolons.
+     * @param declarations The list receiving the declarations of the
+     * properties the parser reads.
+     * @note The values point into the text.
+     */
+    static void parseDeclarations(std::string_view text,
+                                  std::vector< Declaration >& declarations);
+
+    /**
+     * @brief Checks whether an attribute can be set from CSS.
+     *
+     * @param id The attribute to be checked.
+     * @return True if the attribute is a presentation property.
+     */
+    static bool isProperty(AttributeId id);
+
+private:
+    /**
+     * @brief A rule with a single selector.
+     */
+    struct Rule {
+        std::string_view type;                    ///< Type, or empty
+        std::string_view id;                      ///< Id, or empty
+        std::vector< std::string_view > classes;  ///< Required classes
+        int specificity;                          ///< CSS specificity
+        std::size_t first;                        ///< First declaration
+        std::size_t count;                        ///< Number of declarations
+    };
+
+    /**
+     * @brief Adds a rule for one selector.
+     *
+     * @param selector The selector, without leading or trailing whitespaces.
+     * @param first The first declaration of the rule.
+     * @param count The number of declarations of the rule.
+     */
+    void addRule(std::string_view selector, std::size_t first,
+                 std::size_t count);
+
+    /**
+     * @brief Checks whether a rule matches an element.
+     *
+     * @param rule The rule to be checked.
+     * @param type The name of the element.
+     * @param id The id of the element.
+     * @param classes The class attribute of the element.
+     * @return True if every part of the selector matches.
+     */
+    static bool matches(const Rule& rule, std::string_view type,
+                        std::string_view id, std::string_view classes);
+
+    using Index = std::unordered_map< std::string_view,
+                                      std::vector< std::size_t > >;
+
+    std::deque< std::string > sources;  ///< Text of the sheets, with the
+                                        ///< comments blanked out
+    std::vector< Declaration > declarations;  ///< Declarations of the rules
+    std::vector< Rule > rules;                ///< Rules in document order
+    Index by_id;                        ///< Rules keyed by their id
+    Index by_class;                     ///< Rules keyed by their first class
+    Index by_type;                      ///< Rules keyed by their type
+    std::vector< std::size_t > universal;  ///< Rules matching any element
+};
+
+#endif  // STYLE_SHEET_HPP_
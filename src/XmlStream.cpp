@@ -0,0 +1,283 @@
+#include "XmlStream.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    // Whitespace characters allowed between the parts of a tag
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    // Characters ending a name inside a tag
+    bool isNameEnd(char c) {
+        return isWhitespace(c) || c == '=' || c == '/' || c == '>';
+    }
+
+    // Writes a code point as UTF-8, returns one past the last byte written
+    char* writeUtf8(char* out, unsigned long code) {
+        if (code < 0x80) {
+            *out++ = (char)code;
+        } else if (code < 0x800) {
+            *out++ = (char)(0xC0 | (code >> 6));
+            *out++ = (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            *out++ = (char)(0xE0 | (code >> 12));
+            *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (code & 0x3F));
+        } else {
+            *out++ = (char)(0xF0 | (code >> 18));
+            *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+            *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+            *out++ = (char)(0x80 | (code & 0x3F));
+        }
+        return out;
+    }
+}  // namespace
+
+XmlStream::XmlStream(const std::string& file_name, std::size_t chunk_size)
+    : file(file_name, std::ios::binary), chunk_size(chunk_size),
+      bytes_read(0) {
+    // Compressed files are inflated chunk by chunk as they are read
+    if (GzipReader::isGzip(file_name)) {
+        file.close();
+        gzip = std::make_unique< GzipReader >(file_name, chunk_size);
+    }
+}
+
+std::size_t XmlStream::getBytesRead() const { return bytes_read; }
+
+std::size_t XmlStream::getCompressedBytesRead() const {
+    return gzip ? gzip->getBytesRead() : 0;
+}
+
+bool XmlStream::fill() {
+    if (!file && !gzip) return false;
+    std::size_t size = buffer.size();
+    buffer.resize(size + chunk_size);
+    std::size_t count;
+    if (gzip) {
+        count = gzip->read(buffer.data() + size, chunk_size);
+    } else {
+        file.read(buffer.data() + size, chunk_size);
+        count = file.gcount();
+    }
+    buffer.resize(size + count);
+    bytes_read += count;
+    return count > 0;
+}
+
+void XmlStream::discard(std::size_t& position) {
+    // Moving the unread characters is cheap as long as at least a chunk was
+    // consumed, and keeps the buffer from growing with the document
+    if (position < chunk_size) return;
+    buffer.erase(buffer.begin(), buffer.begin() + position);
+    position = 0;
+}
+
+std::size_t XmlStream::find(const char* pattern, std::size_t from) {
+    std::size_t length = std::strlen(pattern);
+    while (true) {
+        auto hit = std::search(buffer.begin() + from, buffer.end(), pattern,
+                               pattern + length);
+        if (hit != buffer.end()) return hit - buffer.begin();
+        // The pattern may start at the end of the buffer and continue in the
+        // next chunk
+        if (buffer.size() >= from + length) from = buffer.size() - length + 1;
+        if (!fill()) return std::string::npos;
+    }
+}
+
+std::size_t XmlStream::findTagEnd(std::size_t from) {
+    char quote = 0;
+    for (std::size_t i = from + 1;; ++i) {
+        if (i == buffer.size() && !fill()) return std::string::npos;
+        char c = buffer[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return i;
+        }
+    }
+}
+
+std::size_t XmlStream::findDeclarationEnd(std::size_t from) {
+    int depth = 0;
+    char quote = 0;
+    for (std::size_t i = from + 2;; ++i) {
+        if (i == buffer.size() && !fill()) return std::string::npos;
+        char c = buffer[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']') {
+            --depth;
+        } else if (c == '>' && depth <= 0) {
+            return i;
+        }
+    }
+}
+
+char* XmlStream::decode(char* begin, char* end) {
+    char* out = begin;
+    for (char* in = begin; in != end;) {
+        if (*in != '&') {
+            *out++ = *in++;
+            continue;
+        }
+        char* semicolon = std::find(in, end, ';');
+        std::size_t length = semicolon - in;
+        if (semicolon == end) {
+            *out++ = *in++;
+        } else if (length == 3 && std::strncmp(in, "&lt", 3) == 0) {
+            *out++ = '<';
+            in = semicolon + 1;
+        } else if (length == 3 && std::strncmp(in, "&gt", 3) == 0) {
+            *out++ = '>';
+            in = semicolon + 1;
+        } else if (length == 4 && std::strncmp(in, "&amp", 4) == 0) {
+            *out++ = '&';
+            in = semicolon + 1;
+        } else if (length == 5 && std::strncmp(in, "&quot", 5) == 0) {
+            *out++ = '"';
+            in = semicolon + 1;
+        } else if (length == 5 && std::strncmp(in, "&apos", 5) == 0) {
+            *out++ = '\'';
+            in = semicolon + 1;
+        } else if (length > 2 && in[1] == '#') {
+            bool hex = in[2] == 'x';
+            char* digits = in + (hex ? 3 : 2);
+            char* digits_end;
+            unsigned long code =
+                std::strtoul(digits, &digits_end, hex ? 16 : 10);
+            if (digits_end != semicolon || digits == semicolon) {
+                *out++ = *in++;
+                continue;
+            }
+            out = writeUtf8(out, code);
+            in = semicolon + 1;
+        } else {
+            // Unknown entities are kept as they are
+            *out++ = *in++;
+        }
+    }
+    return out;
+}
+
+bool XmlStream::parseStartTag(XmlHandler& handler, char* begin, char* end) {
+    bool empty = end > begin && end[-1] == '/';
+    if (empty) --end;
+
+    char* name = begin;
+    char* cursor = name;
+    while (cursor != end && !isNameEnd(*cursor)) ++cursor;
+    if (cursor == name) return false;
+    char* name_end = cursor;
+
+    attributes.clear();
+    while (true) {
+        while (cursor != end && isWhitespace(*cursor)) ++cursor;
+        if (cursor == end) break;
+
+        char* attribute_name = cursor;
+        while (cursor != end && !isNameEnd(*cursor)) ++cursor;
+        if (cursor == attribute_name) return false;
+        char* attribute_name_end = cursor;
+
+        while (cursor != end && isWhitespace(*cursor)) ++cursor;
+        if (cursor == end || *cursor != '=') return false;
+        ++cursor;
+        while (cursor != end && isWhitespace(*cursor)) ++cursor;
+        if (cursor == end || (*cursor != '"' && *cursor != '\'')) return false;
+
+        char quote = *cursor++;
+        char* value = cursor;
+        cursor = std::find(cursor, end, quote);
+        if (cursor == end) return false;
+        char* value_end = decode(value, cursor);
+        ++cursor;
+
+        // Both terminators land on characters that were already read
+        *attribute_name_end = '\0';
+        *value_end = '\0';
+        attributes.push_back({attribute_name, value,
+                              (std::size_t)(value_end - value)});
+    }
+
+    *name_end = '\0';
+    handler.startElement(name, attributes);
+    if (empty) handler.endElement(name);
+    return true;
+}
+
+bool XmlStream::parse(XmlHandler& handler) {
+    if (!file && !gzip) return false;
+    std::size_t position = 0;
+    while (true) {
+        discard(position);
+        if (position == buffer.size() && !fill()) return !gzip || gzip->good();
+
+        if (buffer[position] != '<') {
+            std::size_t next = find("<", position);
+            if (next == std::string::npos) next = buffer.size();
+            char* data = buffer.data() + position;
+            char* data_end = decode(data, buffer.data() + next);
+            handler.characterData(data, data_end - data);
+            position = next;
+            continue;
+        }
+
+        // Enough characters to tell the kind of markup apart
+        while (buffer.size() < position + 9 && fill()) {
+        }
+        const char* markup = buffer.data() + position;
+        std::size_t available = buffer.size() - position;
+        auto startsWith = [&](const char* prefix) {
+            std::size_t length = std::strlen(prefix);
+            return available >= length &&
+                   std::strncmp(markup, prefix, length) == 0;
+        };
+
+        if (startsWith("<!--")) {
+            std::size_t end = find("-->", position + 4);
+            if (end == std::string::npos) return false;
+            position = end + 3;
+        } else if (startsWith("<![CDATA[")) {
+            std::size_t end = find("]]>", position + 9);
+            if (end == std::string::npos) return false;
+            handler.characterData(buffer.data() + position + 9,
+                                  end - position - 9);
+            position = end + 3;
+        } else if (startsWith("<?")) {
+            std::size_t end = find("?>", position + 2);
+            if (end == std::string::npos) return false;
+            position = end + 2;
+        } else if (startsWith("<!")) {
+            std::size_t end = findDeclarationEnd(position);
+            if (end == std::string::npos) return false;
+            position = end + 1;
+        } else if (startsWith("</")) {
+            std::size_t end = find(">", position + 2);
+            if (end == std::string::npos) return false;
+            char* name = buffer.data() + position + 2;
+            char* name_end =
+                std::find_if(name, buffer.data() + end, isWhitespace);
+            *name_end = '\0';
+            handler.endElement(name);
+            position = end + 1;
+        } else {
+            std::size_t end = findTagEnd(position);
+            if (end == std::string::npos) return false;
+            if (!parseStartTag(handler, buffer.data() + position + 1,
+                               buffer.data() + end))
+                return false;
+            position = end + 1;
+        }
+    }
+}
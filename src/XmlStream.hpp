@@ -0,0 +1,182 @@
+#ifndef XML_STREAM_HPP_
+#define XML_STREAM_HPP_
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GzipReader.hpp"
+
+/**
+ * @brief An attribute of an element reported by the XmlStream.
+ *
+ * The name and the value are NUL-terminated and entity references in the
+ * value are already decoded. Both only stay valid during the callback.
+ */
+struct XmlAttribute {
+    const char* name;        ///< Name of the attribute
+    const char* value;       ///< Decoded value of the attribute
+    std::size_t value_size;  ///< Size of the decoded value
+};
+
+/**
+ * @brief Receives the events of an XmlStream.
+ *
+ * The pointers given to the callbacks point into the buffer of the stream and
+ * only stay valid until the callback returns.
+ */
+class XmlHandler {
+public:
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~XmlHandler() = default;
+
+    /**
+     * @brief Called for every start tag, and for every empty-element tag.
+     *
+     * @param name The name of the element.
+     * @param attributes The attributes of the element, in document order.
+     */
+    virtual void startElement(
+        const char* name, const std::vector< XmlAttribute >& attributes) = 0;
+
+    /**
+     * @brief Called for every end tag, and after the start of every
+     * empty-element tag.
+     *
+     * @param name The name of the element.
+     */
+    virtual void endElement(const char* name) = 0;
+
+    /**
+     * @brief Called for character data between tags, including CDATA
+     * sections.
+     *
+     * @param data The decoded characters.
+     * @param size The number of characters.
+     */
+    virtual void characterData(const char* data, std::size_t size) = 0;
+};
+
+/**
+ * @brief Event-based XML reader for documents that do not fit in memory.
+ *
+ * The XmlStream reads the file in fixed-size chunks and reports each tag and
+ * each run of character data to an XmlHandler exactly once, in document
+ * order. Only the chunk being scanned (and the markup spanning a chunk
+ * boundary) is kept in memory, so the memory used does not depend on the
+ * size of the document. Comments, processing instructions and the document
+ * type declaration are skipped. Gzip-compressed files are decompressed as
+ * they are read.
+ */
+class XmlStream {
+public:
+    /**
+     * @brief Opens a file for streaming.
+     *
+     * @param file_name The name of the file to be read.
+     * @param chunk_size The number of bytes read from the file at once.
+     */
+    XmlStream(const std::string& file_name, std::size_t chunk_size = 1 << 16);
+
+    /**
+     * @brief Reads the whole document and reports its content to a handler.
+     *
+     * @param handler The handler receiving the events.
+     * @return True if the document was read until the end, false if the file
+     * could not be opened, the markup is malformed or the compressed data is
+     * corrupted.
+     */
+    bool parse(XmlHandler& handler);
+
+    /**
+     * @brief Gets the number of bytes read from the file so far.
+     *
+     * @return The number of bytes read, after decompression.
+     */
+    std::size_t getBytesRead() const;
+
+    /**
+     * @brief Gets the number of compressed bytes read from the file so far.
+     *
+     * @return The number of compressed bytes read, or 0 if the file is not
+     * compressed.
+     */
+    std::size_t getCompressedBytesRead() const;
+
+private:
+    /**
+     * @brief Appends the next chunk of the file to the buffer.
+     *
+     * @return False if the end of the file was reached.
+     */
+    bool fill();
+
+    /**
+     * @brief Drops the characters before a position of the buffer.
+     *
+     * @param position The first character to be kept.
+     */
+    void discard(std::size_t& position);
+
+    /**
+     * @brief Finds a sequence of characters, reading more of the file when
+     * needed.
+     *
+     * @param pattern The sequence to be found.
+     * @param from The position where the search starts.
+     * @return The position of the sequence, or std::string::npos at the end
+     * of the file.
+     */
+    std::size_t find(const char* pattern, std::size_t from);
+
+    /**
+     * @brief Finds the end of a tag, skipping the '>' inside quoted values.
+     *
+     * @param from The position of the '<' starting the tag.
+     * @return The position of the closing '>', or std::string::npos if the
+     * tag is not closed.
+     */
+    std::size_t findTagEnd(std::size_t from);
+
+    /**
+     * @brief Finds the end of the document type declaration, skipping its
+     * internal subset.
+     *
+     * @param from The position of the "<!" starting the declaration.
+     * @return The position of the closing '>', or std::string::npos if the
+     * declaration is not closed.
+     */
+    std::size_t findDeclarationEnd(std::size_t from);
+
+    /**
+     * @brief Reports a start tag or an empty-element tag.
+     *
+     * @param handler The handler receiving the events.
+     * @param begin The first character after the '<'.
+     * @param end The position of the closing '>'.
+     * @return False if the tag is malformed.
+     */
+    bool parseStartTag(XmlHandler& handler, char* begin, char* end);
+
+    /**
+     * @brief Decodes the entity references of a run of characters in place.
+     *
+     * @param begin The first character of the run.
+     * @param end One past the last character of the run.
+     * @return One past the last decoded character.
+     */
+    static char* decode(char* begin, char* end);
+
+    std::ifstream file;                    ///< File being read
+    std::unique_ptr< GzipReader > gzip;    ///< Decompressor, if compressed
+    std::size_t chunk_size;                ///< Bytes read at once
+    std::size_t bytes_read;                ///< Bytes read so far
+    std::vector< char > buffer;            ///< Characters not consumed yet
+    std::vector< XmlAttribute > attributes;  ///< Attributes of the tag
+};
+
+#endif  // XML_STREAM_HPP_
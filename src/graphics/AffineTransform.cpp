@@ -0,0 +1,67 @@
+#include "AffineTransform.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Converts an angle from degrees to radians
+    float toRadians(float degree) { return degree * acos(-1.0f) / 180; }
+}  // namespace
+
+AffineTransform::AffineTransform() : a(1), b(0), c(0), d(1), e(0), f(0) {}
+
+AffineTransform::AffineTransform(float a, float b, float c, float d, float e,
+                                 float f)
+    : a(a), b(b), c(c), d(d), e(e), f(f) {}
+
+AffineTransform AffineTransform::translate(float tx, float ty) {
+    return AffineTransform(1, 0, 0, 1, tx, ty);
+}
+
+AffineTransform AffineTransform::scale(float sx, float sy) {
+    return AffineTransform(sx, 0, 0, sy, 0, 0);
+}
+
+AffineTransform AffineTransform::rotate(float degree) {
+    float cos_a = cos(toRadians(degree));
+    float sin_a = sin(toRadians(degree));
+    return AffineTransform(cos_a, sin_a, -sin_a, cos_a, 0, 0);
+}
+
+AffineTransform AffineTransform::skewX(float degree) {
+    return AffineTransform(1, 0, tan(toRadians(degree)), 1, 0, 0);
+}
+
+AffineTransform AffineTransform::skewY(float degree) {
+    return AffineTransform(1, tan(toRadians(degree)), 0, 1, 0, 0);
+}
+
+AffineTransform AffineTransform::operator*(
+    const AffineTransform& right) const {
+    return AffineTransform(a * right.a + c * right.b, b * right.a + d * right.b,
+                           a * right.c + c * right.d, b * right.c + d * right.d,
+                           a * right.e + c * right.f + e,
+                           b * right.e + d * right.f + f);
+}
+
+Vector2Df AffineTransform::apply(const Vector2Df& point) const {
+    return Vector2Df(a * point.x + c * point.y + e,
+                     b * point.x + d * point.y + f);
+}
+
+bool AffineTransform::isIdentity() const {
+    return a == 1 && b == 0 && c == 0 && d == 1 && e == 0 && f == 0;
+}
+
+float AffineTransform::getMaxScale() const {
+    float sum = a * a + b * b + c * c + d * d;
+    float det = a * d - b * c;
+    return sqrt((sum + sqrt(std::max(sum * sum - 4 * det * det, 0.f))) / 2);
+}
+
+AffineTransform AffineTransform::getInverse() const {
+    float det = a * d - b * c;
+    if (det == 0) return AffineTransform();
+    return AffineTransform(d / det, -b / det, -c / det, a / det,
+                           (c * f - d * e) / det, (b * e - a * f) / det);
+}
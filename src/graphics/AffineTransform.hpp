@@ -0,0 +1,137 @@
+#ifndef AFFINE_TRANSFORM_HPP_
+#define AFFINE_TRANSFORM_HPP_
+
+#include "Vector2D.hpp"
+
+/**
+ * @brief A 2x3 affine transformation matrix.
+ *
+ * The AffineTransform class stores the six coefficients of an SVG
+ * transformation matrix:
+ *
+ *     | a c e |
+ *     | b d f |
+ *     | 0 0 1 |
+ *
+ * A point (x, y) is mapped to (a * x + c * y + e, b * x + d * y + f), which is
+ * also the layout of Gdiplus::Matrix. A transform list such as
+ * "translate(10) rotate(45)" is resolved into one matrix at parse time, so the
+ * renderer only has to multiply matrices.
+ */
+class AffineTransform {
+public:
+    /**
+     * @brief Constructs the identity transform.
+     */
+    AffineTransform();
+
+    /**
+     * @brief Constructs a transform from its coefficients.
+     *
+     * @param a The x scale.
+     * @param b The y skew.
+     * @param c The x skew.
+     * @param d The y scale.
+     * @param e The x translation.
+     * @param f The y translation.
+     */
+    AffineTransform(float a, float b, float c, float d, float e, float f);
+
+    /**
+     * @brief Constructs a translation.
+     *
+     * @param tx The x translation.
+     * @param ty The y translation.
+     * @return The translation matrix.
+     */
+    static AffineTransform translate(float tx, float ty);
+
+    /**
+     * @brief Constructs a scaling.
+     *
+     * @param sx The x scale.
+     * @param sy The y scale.
+     * @return The scaling matrix.
+     */
+    static AffineTransform scale(float sx, float sy);
+
+    /**
+     * @brief Constructs a rotation around the origin.
+     *
+     * @param degree The angle of the rotation, in degrees.
+     * @return The rotation matrix.
+     */
+    static AffineTransform rotate(float degree);
+
+    /**
+     * @brief Constructs a skew along the x axis.
+     *
+     * @param degree The skew angle, in degrees.
+     * @return The skew matrix.
+     */
+    static AffineTransform skewX(float degree);
+
+    /**
+     * @brief Constructs a skew along the y axis.
+     *
+     * @param degree The skew angle, in degrees.
+     * @return The skew matrix.
+     */
+    static AffineTransform skewY(float degree);
+
+    /**
+     * @brief Composes two transforms.
+     *
+     * @param right The transform applied first.
+     * @return The transform applying right, then this transform.
+     */
+    AffineTransform operator*(const AffineTransform& right) const;
+
+    /**
+     * @brief Maps a point through the transform.
+     *
+     * @param point The point to be mapped.
+     * @return The transformed point.
+     */
+    Vector2Df apply(const Vector2Df& point) const;
+
+    /**
+     * @brief Compares two transforms.
+     *
+     * @param other The transform to be compared with.
+     * @return True if all the coefficients are equal.
+     */
+    bool operator==(const AffineTransform& other) const = default;
+
+    /**
+     * @brief Checks whether the transform is the identity.
+     *
+     * @return True if the transform leaves every point unchanged.
+     */
+    bool isIdentity() const;
+
+    /**
+     * @brief Gets the largest factor the transform scales a length by.
+     *
+     * @return The largest singular value of the linear part, the radius of a
+     * unit circle once transformed.
+     */
+    float getMaxScale() const;
+
+    /**
+     * @brief Gets the transform undoing this one.
+     *
+     * @return The inverse transform, or the identity if the transform
+     * flattens the plane and cannot be undone.
+     */
+    AffineTransform getInverse() const;
+
+    float a;  ///< X scale
+    float b;  ///< Y skew
+    float c;  ///< X skew
+    float d;  ///< Y scale
+    float e;  ///< X translation
+    float f;  ///< Y translation
+};
+
+#endif  // AFFINE_TRANSFORM_HPP_
@@ -0,0 +1,152 @@
+#include "BoundingBox.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr float kInfinity = std::numeric_limits< float >::infinity();
+    const float kPi = std::acos(-1.0f);
+
+    // Get the point of a quadratic Bezier curve at t
+    Vector2Df getQuadraticPoint(const Vector2Df& p0, const Vector2Df& p1,
+                                const Vector2Df& p2, float t) {
+        float s = 1 - t;
+        return p0 * (s * s) + p1 * (2 * s * t) + p2 * (t * t);
+    }
+
+    // Get the point of a cubic Bezier curve at t
+    Vector2Df getCubicPoint(const Vector2Df& p0, const Vector2Df& p1,
+                            const Vector2Df& p2, const Vector2Df& p3,
+                            float t) {
+        float s = 1 - t;
+        return p0 * (s * s * s) + p1 * (3 * s * s * t) +
+               p2 * (3 * s * t * t) + p3 * (t * t * t);
+    }
+
+    // Find the roots of a * t^2 + b * t + c inside (0, 1), returns their
+    // number
+    int solveInUnit(float a, float b, float c, float roots[2]) {
+        int count = 0;
+        auto keep = [&](float t) {
+            if (t > 0 && t < 1) roots[count++] = t;
+        };
+        if (std::abs(a) < 1e-12f) {
+            if (b != 0) keep(-c / b);
+            return count;
+        }
+        float discriminant = b * b - 4 * a * c;
+        if (discriminant < 0) return 0;
+        float root = std::sqrt(discriminant);
+        keep((-b + root) / (2 * a));
+        keep((-b - root) / (2 * a));
+        return count;
+    }
+
+    // Check whether an angle lies on an arc
+    bool isOnArc(float angle, float start_angle, float sweep_angle) {
+        float offset = sweep_angle >= 0 ? angle - start_angle
+                                        : start_angle - angle;
+        offset = std::fmod(offset, 2 * kPi);
+        if (offset < 0) offset += 2 * kPi;
+        return offset <= std::abs(sweep_angle);
+    }
+}  // namespace
+
+BoundingBox::BoundingBox()
+    : min(kInfinity, kInfinity), max(-kInfinity, -kInfinity) {}
+
+BoundingBox::BoundingBox(const Vector2Df& min, const Vector2Df& max)
+    : min(min), max(max) {}
+
+bool BoundingBox::isEmpty() const { return min.x > max.x || min.y > max.y; }
+
+void BoundingBox::add(const Vector2Df& point) {
+    min.x = std::min(min.x, point.x);
+    min.y = std::min(min.y, point.y);
+    max.x = std::max(max.x, point.x);
+    max.y = std::max(max.y, point.y);
+}
+
+void BoundingBox::add(const BoundingBox& box) {
+    min.x = std::min(min.x, box.min.x);
+    min.y = std::min(min.y, box.min.y);
+    max.x = std::max(max.x, box.max.x);
+    max.y = std::max(max.y, box.max.y);
+}
+
+void BoundingBox::addQuadratic(const Vector2Df& start,
+                               const Vector2Df& control,
+                               const Vector2Df& end) {
+    add(start);
+    add(end);
+    // The derivative of each coordinate is linear, zero at one t at most
+    Vector2Df denominator = start - control * 2.f + end;
+    float t[2] = {denominator.x != 0 ? (start.x - control.x) / denominator.x
+                                     : -1,
+                  denominator.y != 0 ? (start.y - control.y) / denominator.y
+                                     : -1};
+    for (float root : t) {
+        if (root > 0 && root < 1)
+            add(getQuadraticPoint(start, control, end, root));
+    }
+}
+
+void BoundingBox::addCubic(const Vector2Df& start, const Vector2Df& control1,
+                           const Vector2Df& control2, const Vector2Df& end) {
+    add(start);
+    add(end);
+    // The derivative of each coordinate is a quadratic in t
+    Vector2Df a = (control1 - control2) * 3.f + end - start;
+    Vector2Df b = (start - control1 * 2.f + control2) * 2.f;
+    Vector2Df c = control1 - start;
+    float roots[2];
+    int count = solveInUnit(a.x, b.x, c.x, roots);
+    for (int i = 0; i < count; ++i)
+        add(getCubicPoint(start, control1, control2, end, roots[i]));
+    count = solveInUnit(a.y, b.y, c.y, roots);
+    for (int i = 0; i < count; ++i)
+        add(getCubicPoint(start, control1, control2, end, roots[i]));
+}
+
+void BoundingBox::addArc(const Vector2Df& center, const Vector2Df& u,
+                         const Vector2Df& v, float start_angle,
+                         float sweep_angle) {
+    auto getPoint = [&](float angle) {
+        return center + u * std::cos(angle) + v * std::sin(angle);
+    };
+    add(getPoint(start_angle));
+    add(getPoint(start_angle + sweep_angle));
+    // Each coordinate is extreme where its derivative, -u sin t + v cos t,
+    // is zero: at atan2(v, u) and half a turn further
+    float extrema[2] = {std::atan2(v.x, u.x), std::atan2(v.y, u.y)};
+    for (float angle : extrema) {
+        for (float extremum : {angle, angle + kPi}) {
+            if (isOnArc(extremum, start_angle, sweep_angle))
+                add(getPoint(extremum));
+        }
+    }
+}
+
+void BoundingBox::expand(float margin) {
+    if (isEmpty()) return;
+    min.x -= margin;
+    min.y -= margin;
+    max.x += margin;
+    max.y += margin;
+}
+
+bool BoundingBox::intersects(const BoundingBox& box) const {
+    return min.x <= box.max.x && box.min.x <= max.x && min.y <= box.max.y &&
+           box.min.y <= max.y;
+}
+
+BoundingBox BoundingBox::transform(const AffineTransform& transform) const {
+    if (isEmpty() || transform.isIdentity()) return *this;
+    BoundingBox result;
+    result.add(transform.apply(min));
+    result.add(transform.apply(max));
+    result.add(transform.apply(Vector2Df(min.x, max.y)));
+    result.add(transform.apply(Vector2Df(max.x, min.y)));
+    return result;
+}
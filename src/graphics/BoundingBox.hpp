@@ -0,0 +1,114 @@
+#ifndef BOUNDING_BOX_HPP_
+#define BOUNDING_BOX_HPP_
+
+#include "AffineTransform.hpp"
+#include "Vector2D.hpp"
+
+/**
+ * @brief An axis-aligned box, empty until a point is added to it.
+ */
+class BoundingBox {
+public:
+    /**
+     * @brief Constructs an empty box.
+     */
+    BoundingBox();
+
+    /**
+     * @brief Constructs the box spanning two corners.
+     *
+     * @param min The corner of the smallest coordinates.
+     * @param max The corner of the largest coordinates.
+     */
+    BoundingBox(const Vector2Df& min, const Vector2Df& max);
+
+    /**
+     * @brief Checks whether the box contains no point.
+     *
+     * @return True if no point was added to the box.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Grows the box to contain a point.
+     *
+     * @param point The point to be contained.
+     */
+    void add(const Vector2Df& point);
+
+    /**
+     * @brief Grows the box to contain another box.
+     *
+     * @param box The box to be contained.
+     */
+    void add(const BoundingBox& box);
+
+    /**
+     * @brief Grows the box to contain a quadratic Bezier curve.
+     *
+     * @param start The start point.
+     * @param control The control point.
+     * @param end The end point.
+     * @note The extrema of the curve are solved exactly, the control point is
+     * only contained if the curve passes through it.
+     */
+    void addQuadratic(const Vector2Df& start, const Vector2Df& control,
+                      const Vector2Df& end);
+
+    /**
+     * @brief Grows the box to contain a cubic Bezier curve.
+     *
+     * @param start The start point.
+     * @param control1 The first control point.
+     * @param control2 The second control point.
+     * @param end The end point.
+     * @note The extrema of the curve are solved exactly, the control points
+     * are only contained if the curve passes through them.
+     */
+    void addCubic(const Vector2Df& start, const Vector2Df& control1,
+                  const Vector2Df& control2, const Vector2Df& end);
+
+    /**
+     * @brief Grows the box to contain an elliptical arc.
+     *
+     * The arc is the set of the points center + u * cos(t) + v * sin(t) for t
+     * from start_angle to start_angle + sweep_angle, which describes any
+     * ellipse mapped through an affine transform.
+     *
+     * @param center The center of the ellipse.
+     * @param u The point of angle 0, relative to the center.
+     * @param v The point of angle pi / 2, relative to the center.
+     * @param start_angle The angle of the start of the arc, in radians.
+     * @param sweep_angle The signed angle of the arc, in radians.
+     */
+    void addArc(const Vector2Df& center, const Vector2Df& u,
+                const Vector2Df& v, float start_angle, float sweep_angle);
+
+    /**
+     * @brief Grows the box on every side.
+     *
+     * @param margin The distance added on each side.
+     */
+    void expand(float margin);
+
+    /**
+     * @brief Checks whether the box overlaps another one.
+     *
+     * @param box The other box.
+     * @return True if the boxes share at least one point.
+     */
+    bool intersects(const BoundingBox& box) const;
+
+    /**
+     * @brief Maps the box through a transform.
+     *
+     * @param transform The transform to be applied.
+     * @return The smallest box containing the four transformed corners.
+     */
+    BoundingBox transform(const AffineTransform& transform) const;
+
+    Vector2Df min;  ///< Corner of the smallest coordinates
+    Vector2Df max;  ///< Corner of the largest coordinates
+};
+
+#endif  // BOUNDING_BOX_HPP_
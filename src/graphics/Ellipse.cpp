@@ -4,22 +4,31 @@
 
 Ell::Ell(const Vector2Df &radius, const Vector2Df &center, ColorShape fill,
          ColorShape stroke, float stroke_thickness)
-    : SVGElement(fill, stroke, stroke_thickness, center), radius(radius) {}
+    : Ell(ElementKind::Ellipse, radius, center, fill, stroke,
+          stroke_thickness) {}
+
+Ell::Ell(ElementKind kind, const Vector2Df &radius, const Vector2Df &center,
+         ColorShape fill, ColorShape stroke, float stroke_thickness)
+    : SVGElement(kind, fill, stroke, stroke_thickness, center),
+      radius(radius) {}
 
 std::string Ell::getClass() const { return "Ellipse"; }
 
-void Ell::setRadius(const Vector2Df &radius) { this->radius = radius; }
+void Ell::setRadius(const Vector2Df &radius) {
+    this->radius = radius;
+    invalidateBounds();
+}
 
 Vector2Df Ell::getRadius() const { return radius; }
 
-Vector2Df Ell::getMinBound() const {
-    return Vector2Df(getPosition().x - getRadius().x,
-                     getPosition().y - getRadius().y);
-}
-
-Vector2Df Ell::getMaxBound() const {
-    return Vector2Df(getPosition().x + getRadius().x,
-                     getPosition().y + getRadius().y);
+BoundingBox Ell::computeBounds(const AffineTransform &matrix) const {
+    // The mapped ellipse reaches from its center as far as its mapped axes
+    // combined
+    float rx = std::abs(radius.x), ry = std::abs(radius.y);
+    Vector2Df extent(std::hypot(matrix.a * rx, matrix.c * ry),
+                     std::hypot(matrix.b * rx, matrix.d * ry));
+    Vector2Df center = matrix.apply(getPosition());
+    return BoundingBox(center - extent, center + extent);
 }
 
 void Ell::printData() const {
@@ -26,6 +26,22 @@ public:
     Ell(const Vector2Df &radius, const Vector2Df &center, ColorShape fill,
         ColorShape stroke, float stroke_width);
 
+protected:
+    /**
+     * @brief Constructs an ellipse of a derived kind.
+     *
+     * @param kind The kind of the shape.
+     * @param radius The radii of the ellipse in the x and y directions.
+     * @param center The center of the ellipse.
+     * @param fill Fill color of the ellipse.
+     * @param stroke Outline color of the ellipse.
+     * @param stroke_width Thickness of the ellipse outline.
+     */
+    Ell(ElementKind kind, const Vector2Df &radius, const Vector2Df &center,
+        ColorShape fill, ColorShape stroke, float stroke_width);
+
+public:
+
     /**
      * @brief Gets the type of the shape.
      *
@@ -50,18 +66,12 @@ public:
     Vector2Df getRadius() const;
 
     /**
-     * @brief Gets the minimum bounding box of the shape.
-     *
-     * @return The minimum bounding box of the shape.
-     */
-    Vector2Df getMinBound() const override;
-
-    /**
-     * @brief Gets the maximum bounding box of the shape.
+     * @brief Computes the bounds of the ellipse mapped through a matrix.
      *
-     * @return The maximum bounding box of the shape.
+     * @param matrix The matrix mapping the coordinates of the ellipse.
+     * @return The box of the mapped ellipse, from the extents of its axes.
      */
-    Vector2Df getMaxBound() const override;
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
 
     /**
      * @brief Prints the data of the shape.
@@ -0,0 +1,138 @@
+#include "FlatPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Path.hpp"
+
+namespace {
+    constexpr int kMaxDepth = 16;          // Most halvings of a curve
+    constexpr int kMaxArcLines = 1 << 16;  // Most lines of an arc
+    const float kPi = std::acos(-1.f);
+
+    float getLength(const Vector2Df& v) { return std::hypot(v.x, v.y); }
+
+    // Appends the segments of a path to a flattening, a figure per subpath
+    class Flattener : public PathVisitor {
+    public:
+        Flattener(FlatPath& flat, float tolerance)
+            : flat(flat), tolerance(tolerance) {}
+
+        void moveTo(const Vector2Df&) override { finish(); }
+
+        void lineTo(const Vector2Df& start, const Vector2Df& end) override {
+            begin(start);
+            flat.points.push_back(end);
+        }
+
+        // A quadratic curve is raised to the cubic curve drawing it
+        void quadraticTo(const Vector2Df& start, const Vector2Df& control,
+                         const Vector2Df& end) override {
+            cubicTo(start, start + (control - start) * (2.f / 3),
+                    end + (control - end) * (2.f / 3), end);
+        }
+
+        void cubicTo(const Vector2Df& start, const Vector2Df& control1,
+                     const Vector2Df& control2,
+                     const Vector2Df& end) override {
+            begin(start);
+            addCubic(start, control1, control2, end, 0);
+        }
+
+        // An arc is the unit circle mapped by its axes: the chord of an
+        // angle a strays from it by (1 - cos(a / 2)) times the largest
+        // radius at most, which gives the angle of the lines
+        void arcTo(const Vector2Df& start, const Vector2Df& end,
+                   const PathArc& arc) override {
+            CenterArc center_arc;
+            if (!toCenterArc(start, end, arc, center_arc)) {
+                if (start != end) lineTo(start, end);
+                return;
+            }
+            const Vector2Df& u = center_arc.u;
+            const Vector2Df& v = center_arc.v;
+            float radius = AffineTransform(u.x, u.y, v.x, v.y, 0, 0)
+                               .getMaxScale();
+            float angle = kPi;
+            if (tolerance < radius)
+                angle = 2 * std::acos(1 - tolerance / radius);
+            float sweep = std::abs(center_arc.sweep_angle);
+            int lines = std::clamp((int)std::ceil(sweep / angle), 1,
+                                   kMaxArcLines);
+            begin(start);
+            for (int i = 1; i < lines; ++i) {
+                float t = center_arc.start_angle +
+                          center_arc.sweep_angle * i / lines;
+                flat.points.push_back(center_arc.center + u * std::cos(t) +
+                                      v * std::sin(t));
+            }
+            flat.points.push_back(end);
+        }
+
+        void close(const Vector2Df&, const Vector2Df&) override {
+            if (!open) return;
+            finish();
+            if (!flat.figures.empty() &&
+                flat.figures.back().first == figure_first)
+                flat.figures.back().closed = true;
+        }
+
+        // Ends the current figure, dropped if it is a single point
+        void finish() {
+            if (!open) return;
+            open = false;
+            std::uint32_t count = flat.points.size() - figure_first;
+            if (count < 2) {
+                flat.points.pop_back();
+                return;
+            }
+            flat.figures.push_back({figure_first, count, false});
+        }
+
+    private:
+        // Starts a figure at the start of a segment, if none is open
+        void begin(const Vector2Df& start) {
+            if (open) return;
+            open = true;
+            figure_first = flat.points.size();
+            flat.points.push_back(start);
+        }
+
+        // Appends the points of a cubic curve after its start, splitting it
+        // in halves until it is within the tolerance of its chord. The
+        // curve strays from its chord by 3t(1 - t) at most of the offsets of
+        // its control points from the thirds of the chord
+        void addCubic(const Vector2Df& p0, const Vector2Df& p1,
+                      const Vector2Df& p2, const Vector2Df& p3, int depth) {
+            float flatness =
+                0.75f * std::max(getLength(p1 - (p0 * 2.f + p3) / 3.f),
+                                 getLength(p2 - (p0 + p3 * 2.f) / 3.f));
+            if (flatness <= tolerance || depth == kMaxDepth) {
+                flat.points.push_back(p3);
+                return;
+            }
+            Vector2Df p01 = (p0 + p1) * 0.5f, p12 = (p1 + p2) * 0.5f;
+            Vector2Df p23 = (p2 + p3) * 0.5f;
+            Vector2Df p012 = (p01 + p12) * 0.5f, p123 = (p12 + p23) * 0.5f;
+            Vector2Df middle = (p012 + p123) * 0.5f;
+            addCubic(p0, p01, p012, middle, depth + 1);
+            addCubic(middle, p123, p23, p3, depth + 1);
+        }
+
+        FlatPath& flat;
+        float tolerance;
+        bool open = false;               // Whether a figure is being added
+        std::uint32_t figure_first = 0;  // First point of the figure
+    };
+}  // namespace
+
+FlatPath::FlatPath(const std::pmr::polymorphic_allocator<>& allocator)
+    : points(allocator), figures(allocator) {}
+
+void flattenPath(const Path& path, float tolerance, FlatPath& flat) {
+    flat.points.clear();
+    flat.figures.clear();
+    Flattener flattener(flat, tolerance);
+    path.visit(flattener);
+    flattener.finish();
+}
@@ -0,0 +1,57 @@
+#ifndef FLAT_PATH_HPP_
+#define FLAT_PATH_HPP_
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "Vector2D.hpp"
+
+class Path;
+
+/**
+ * @brief A figure of a flattened path, a polyline.
+ */
+struct FlatFigure {
+    std::uint32_t first = 0;  ///< Index of its first point
+    std::uint32_t count = 0;  ///< Number of its points, 2 at least
+    bool closed = false;      ///< Whether it is closed by a 'z'
+};
+
+/**
+ * @brief A path flattened into polylines.
+ *
+ * The curves and arcs are replaced by lines straying from them by the
+ * tolerance at most, the points of the figures packed in one array. The
+ * containers use the allocator of the path they belong to.
+ */
+struct FlatPath {
+    std::pmr::vector< Vector2Df > points;    ///< Points of every figure
+    std::pmr::vector< FlatFigure > figures;  ///< Figures, in order
+
+    /**
+     * @brief Constructs an empty flattening.
+     *
+     * @param allocator The allocator of the points and the figures.
+     */
+    FlatPath(const std::pmr::polymorphic_allocator<>& allocator = {});
+};
+
+/**
+ * @brief Flattens a path into polylines.
+ *
+ * Each Bezier curve is split in halves until its control points are within
+ * the tolerance of its chord, so the flat parts of a curve take few lines
+ * and its bends take more. Each arc is split into equal angles, as few as
+ * its largest radius allows.
+ *
+ * @param path The path to be flattened.
+ * @param tolerance The largest distance between the path and its lines, in
+ * the coordinates of the path.
+ * @param flat Receives the figures, replacing its content.
+ * @note The curves and arcs follow the SVG definitions, as the bounds of the
+ * path do. The figures of a single point are dropped.
+ */
+void flattenPath(const Path& path, float tolerance, FlatPath& flat);
+
+#endif  // FLAT_PATH_HPP_
@@ -1,23 +1,24 @@
 #include "Gradient.hpp"
 
-Gradient::Gradient(std::vector< Stop > stops,
-                   std::pair< Vector2Df, Vector2Df > points, std::string units)
-    : stops(stops), points(points), units(units) {}
+Gradient::Gradient(GradientKind kind, StopRamp stops,
+                   std::pair< Vector2Df, Vector2Df > points,
+                   GradientUnits units)
+    : kind(kind), stops(std::move(stops)), points(points), units(units) {}
 
-std::vector< Stop > Gradient::getStops() const { return stops; }
+GradientKind Gradient::getKind() const { return kind; }
 
-std::pair< Vector2Df, Vector2Df > Gradient::getPoints() const { return points; }
+const std::vector< Stop >& Gradient::getStops() const { return *stops; }
+
+const StopRamp& Gradient::getSharedStops() const { return stops; }
 
-void Gradient::setUnits(std::string units) { this->units = units; }
+std::pair< Vector2Df, Vector2Df > Gradient::getPoints() const { return points; }
 
-std::string Gradient::getUnits() const { return units; }
+void Gradient::setUnits(GradientUnits units) { this->units = units; }
 
-void Gradient::setTransforms(std::vector< std::string > transforms) {
-    this->transforms = transforms;
-}
+GradientUnits Gradient::getUnits() const { return units; }
 
-std::vector< std::string > Gradient::getTransforms() const {
-    return transforms;
+void Gradient::setTransform(const AffineTransform& transform) {
+    this->transform = transform;
 }
 
-void Gradient::addStop(Stop stop) { stops.push_back(stop); }
\ No newline at end of file
+const AffineTransform& Gradient::getTransform() const { return transform; }
\ No newline at end of file
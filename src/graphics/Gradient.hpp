@@ -1,12 +1,30 @@
 #ifndef GRADIENT_HPP_
 #define GRADIENT_HPP_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "AffineTransform.hpp"
 #include "Stop.hpp"
 #include "Vector2D.hpp"
 
+/**
+ * @brief The kind of a Gradient, fixed when the gradient is constructed.
+ */
+enum class GradientKind : std::uint8_t {
+    Linear,
+    Radial,
+};
+
+/**
+ * @brief The gradientUnits of a Gradient, parsed once when it is built.
+ */
+enum class GradientUnits : std::uint8_t {
+    ObjectBoundingBox,  ///< "objectBoundingBox", the default
+    UserSpaceOnUse,     ///< "userSpaceOnUse"
+};
+
 /**
  * @brief A class that represents a gradient.
  *
@@ -20,12 +38,14 @@ public:
     /**
      * @brief Constructs a Gradient object.
      *
-     * @param stops The stops of the gradient.
+     * @param kind The kind of the gradient.
+     * @param stops The stops of the gradient, possibly shared with other
+     * gradients.
      * @param points The start and end points of the gradient.
      * @param units The units of the gradient.
      */
-    Gradient(std::vector< Stop > stops,
-             std::pair< Vector2Df, Vector2Df > points, std::string units);
+    Gradient(GradientKind kind, StopRamp stops,
+             std::pair< Vector2Df, Vector2Df > points, GradientUnits units);
 
     /**
      * @brief Destructs a Gradient object.
@@ -39,12 +59,26 @@ public:
      */
     virtual std::string getClass() const = 0;
 
+    /**
+     * @brief Gets the kind of the gradient.
+     *
+     * @return The kind of the gradient.
+     */
+    GradientKind getKind() const;
+
     /**
      * @brief Gets the stops of the gradient.
      *
      * @return The stops of the gradient.
      */
-    std::vector< Stop > getStops() const;
+    const std::vector< Stop >& getStops() const;
+
+    /**
+     * @brief Gets the stops of the gradient, to be shared with another one.
+     *
+     * @return The stops of the gradient.
+     */
+    const StopRamp& getSharedStops() const;
 
     /**
      * @brief Gets the start and end points of the gradient.
@@ -54,46 +88,40 @@ public:
     std::pair< Vector2Df, Vector2Df > getPoints() const;
 
     /**
-     * @brief Gets the units of the gradient.
+     * @brief Sets the units of the gradient.
      *
-     * @return The units of the gradient.
+     * @param units The new units of the gradient.
      */
-    void setUnits(std::string units);
+    void setUnits(GradientUnits units);
 
     /**
      * @brief Gets the units of the gradient.
      *
      * @return The units of the gradient.
      */
-    std::string getUnits() const;
-
-    /**
-     * @brief Gets the transforms of the gradient.
-     *
-     * @return The transforms of the gradient.
-     */
-    void setTransforms(std::vector< std::string > transforms);
+    GradientUnits getUnits() const;
 
     /**
-     * @brief Gets the transforms of the gradient.
+     * @brief Sets the transform of the gradient.
      *
-     * @return The transforms of the gradient.
+     * @param transform The gradientTransform list resolved into one matrix.
      */
-    std::vector< std::string > getTransforms() const;
+    void setTransform(const AffineTransform& transform);
 
     /**
-     * @brief Adds a stop to the gradient.
+     * @brief Gets the transform of the gradient.
      *
-     * @param stop The stop to be added to the gradient.
+     * @return The transform of the gradient.
      */
-    void addStop(Stop stop);
+    const AffineTransform& getTransform() const;
 
 private:
-    std::vector< Stop > stops;  ///< Stops of the gradient
+    GradientKind kind;  ///< Kind of the gradient
+    StopRamp stops;     ///< Stops of the gradient
     std::pair< Vector2Df, Vector2Df >
-        points;         ///< Start and end points of the gradient
-    std::string units;  ///< Units of the gradient
-    std::vector< std::string > transforms;  ///< Transforms of the gradient
+        points;           ///< Start and end points of the gradient
+    GradientUnits units;  ///< Units of the gradient
+    AffineTransform transform;  ///< Transform of the gradient
 };
 
 #endif
\ No newline at end of file
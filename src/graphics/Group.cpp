@@ -1,25 +1,26 @@
 #include "Group.hpp"
 
-Group::Group() {}
-
-Group::Group(Attributes attributes) : attributes(attributes) {}
-
-Group::~Group() {
-    for (auto& shape : shapes) {
-        delete shape;
-    }
-}
+Group::Group(const std::pmr::polymorphic_allocator<>& allocator)
+    : SVGElement(ElementKind::Group), shapes(allocator) {}
 
 std::string Group::getClass() const { return "Group"; }
 
-Attributes Group::getAttributes() const { return attributes; }
-
 void Group::addElement(SVGElement* shape) {
     shapes.push_back(shape);
     shape->setParent(this);
+    invalidateBounds();
+}
+
+const std::pmr::vector< SVGElement* >& Group::getElements() const {
+    return shapes;
 }
 
-std::vector< SVGElement* > Group::getElements() const { return shapes; }
+BoundingBox Group::computeBounds(const AffineTransform& matrix) const {
+    BoundingBox box;
+    for (const SVGElement* shape : shapes)
+        box.add(shape->getBounds().transform(matrix));
+    return box;
+}
 
 void Group::printData() const {
     std::cout << "Group: " << std::endl;
@@ -1,13 +1,11 @@
 #ifndef GROUP_HPP_
 #define GROUP_HPP_
 
+#include <memory_resource>
 #include <vector>
 
 #include "SVGElement.hpp"
 
-typedef std::vector< std::pair< std::string, std::string > >
-    Attributes;  ///< Attributes of the shape
-
 /**
  * @brief A composite class that contains a vector of shape pointers
  * (polymorphic).
@@ -15,26 +13,17 @@ typedef std::vector< std::pair< std::string, std::string > >
  * The Group class is derived from the SVGElement class and defines a group of
  * SVGElements. The Group class is a composite class that contains a vector of
  * SVGElement pointers (polymorphic). The Group class is used to group
- * SVGElements together.
+ * SVGElements together. The group does not own its shapes: they live in the
+ * arena of the scene, like the group itself.
  */
 class Group : public SVGElement {
 public:
-    /**
-     * @brief Constructs a Group object.
-     */
-    Group();
-
     /**
      * @brief Constructs a Group object.
      *
-     * @param attributes The attributes of the group.
+     * @param allocator The allocator of the vector of shapes.
      */
-    Group(Attributes attributes);
-
-    /**
-     * @brief Destructs a Group object.
-     */
-    ~Group();
+    Group(const std::pmr::polymorphic_allocator<>& allocator = {});
 
     /**
      * @brief Gets the type of the shape.
@@ -43,16 +32,6 @@ public:
      */
     std::string getClass() const override;
 
-    /**
-     * @brief Gets the attributes of the shape.
-     *
-     * @note This function uses rapidXML to parse the SVG file and get the
-     * attributes of the shape.
-     *
-     * @return The attributes of the shape that parsed from the SVG file.
-     */
-    Attributes getAttributes() const;
-
     /**
      * @brief Adds a shape to the composite group.
      *
@@ -65,7 +44,16 @@ public:
      *
      * @return The vector of shapes in the composite group.
      */
-    std::vector< SVGElement* > getElements() const;
+    const std::pmr::vector< SVGElement* >& getElements() const;
+
+    /**
+     * @brief Computes the bounds of the group mapped through a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the group.
+     * @return The union of the cached bounds of the shapes, each mapped
+     * through the matrix.
+     */
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
 
     /**
      * @brief Prints the data of the shape.
@@ -75,8 +63,7 @@ public:
     void printData() const override;
 
 private:
-    std::vector< SVGElement* > shapes;  ///< Vector of shapes in the group
-    Attributes attributes;              ///< Attributes of the group
+    std::pmr::vector< SVGElement* > shapes;  ///< Vector of shapes in the group
 };
 
 #endif  // GROUP_HPP_
\ No newline at end of file
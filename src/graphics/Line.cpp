@@ -4,17 +4,26 @@
 
 Line::Line(const Vector2Df& point1, const Vector2Df& point2, ColorShape stroke,
            float stroke_width)
-    : SVGElement(ColorShape::Transparent, stroke, stroke_width, point1),
+    : SVGElement(ElementKind::Line, ColorShape::Transparent, stroke,
+                 stroke_width, point1),
       direction(point2) {}
 
 std::string Line::getClass() const { return "Line"; }
 
 void Line::setDirection(const Vector2Df& direction) {
     this->direction = direction;
+    invalidateBounds();
 }
 
 Vector2Df Line::getDirection() const { return direction; }
 
 float Line::getLength() const {
     return std::sqrt(direction.x * direction.x + direction.y * direction.y);
+}
+
+BoundingBox Line::computeBounds(const AffineTransform& matrix) const {
+    BoundingBox box;
+    box.add(matrix.apply(getPosition()));
+    box.add(matrix.apply(direction));
+    return box;
 }
\ No newline at end of file
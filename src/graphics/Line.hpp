@@ -52,6 +52,14 @@ public:
      * @return The length of the line.
      */
     float getLength() const;
+
+    /**
+     * @brief Computes the bounds of the line mapped through a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the line.
+     * @return The box of the two mapped ends.
+     */
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
 };
 
 #endif
\ No newline at end of file
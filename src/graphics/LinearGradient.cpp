@@ -1,8 +1,8 @@
 #include "LinearGradient.hpp"
 
-LinearGradient::LinearGradient(std::vector< Stop > stops,
+LinearGradient::LinearGradient(StopRamp stops,
                                std::pair< Vector2Df, Vector2Df > points,
-                               std::string units)
-    : Gradient(stops, points, units) {}
+                               GradientUnits units)
+    : Gradient(GradientKind::Linear, std::move(stops), points, units) {}
 
 std::string LinearGradient::getClass() const { return "LinearGradient"; }
\ No newline at end of file
@@ -20,8 +20,8 @@ public:
      * @param points The start and end points of the gradient.
      * @param units The units of the gradient.
      */
-    LinearGradient(std::vector< Stop > stops,
-                   std::pair< Vector2Df, Vector2Df > points, std::string units);
+    LinearGradient(StopRamp stops, std::pair< Vector2Df, Vector2Df > points,
+                   GradientUnits units);
 
     /**
      * @brief Gets the type of the gradient.
@@ -1,23 +1,238 @@
 #include "Path.hpp"
 
-Path::Path(const ColorShape& fill, const ColorShape& stroke, float stroke_width)
-    : SVGElement(fill, stroke, stroke_width) {}
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr std::size_t kFlatCacheSize = 4;  // Most cached flattenings
+    constexpr int kMinBucket = -20;  // Finest tolerance flattened, 2^-20
+    constexpr int kMaxBucket = 20;   // Coarsest tolerance flattened, 2^20
+
+    // Maps a vector through the linear part of a matrix
+    Vector2Df mapVector(const AffineTransform& matrix, const Vector2Df& v) {
+        return Vector2Df(matrix.a * v.x + matrix.c * v.y,
+                         matrix.b * v.x + matrix.d * v.y);
+    }
+
+    // Bounds the segments of a path mapped through a matrix
+    class BoundsVisitor : public PathVisitor {
+    public:
+        BoundsVisitor(const AffineTransform& matrix) : matrix(matrix) {}
+
+        void moveTo(const Vector2Df& point) override {
+            box.add(matrix.apply(point));
+        }
+
+        void lineTo(const Vector2Df&, const Vector2Df& end) override {
+            box.add(matrix.apply(end));
+        }
+
+        void quadraticTo(const Vector2Df& start, const Vector2Df& control,
+                         const Vector2Df& end) override {
+            box.addQuadratic(matrix.apply(start), matrix.apply(control),
+                             matrix.apply(end));
+        }
+
+        void cubicTo(const Vector2Df& start, const Vector2Df& control1,
+                     const Vector2Df& control2,
+                     const Vector2Df& end) override {
+            box.addCubic(matrix.apply(start), matrix.apply(control1),
+                         matrix.apply(control2), matrix.apply(end));
+        }
+
+        void arcTo(const Vector2Df& start, const Vector2Df& end,
+                   const PathArc& arc) override {
+            box.add(matrix.apply(end));
+            CenterArc center_arc;
+            if (!toCenterArc(start, end, arc, center_arc)) return;
+            // The mapped ellipse spans the mapped ends of its rotated axes
+            box.addArc(matrix.apply(center_arc.center),
+                       mapVector(matrix, center_arc.u),
+                       mapVector(matrix, center_arc.v),
+                       center_arc.start_angle, center_arc.sweep_angle);
+        }
+
+        void close(const Vector2Df&, const Vector2Df&) override {}
+
+        BoundingBox box;  // Box of the segments walked so far
+
+    private:
+        const AffineTransform& matrix;
+    };
+}  // namespace
+
+// The arc is converted in double precision: the terms cancel out when the
+// radii are just large enough
+bool toCenterArc(const Vector2Df& start, const Vector2Df& end,
+                 const PathArc& arc, CenterArc& center_arc) {
+    double rx = std::abs(arc.radius.x), ry = std::abs(arc.radius.y);
+    if (rx == 0 || ry == 0 || (start.x == end.x && start.y == end.y))
+        return false;
+    double angle = arc.x_axis_rotation * std::acos(-1.0) / 180;
+    double cos_a = std::cos(angle), sin_a = std::sin(angle);
+
+    // The start point in the axes of the ellipse, relative to the middle of
+    // the chord
+    double half_x = ((double)start.x - end.x) / 2;
+    double half_y = ((double)start.y - end.y) / 2;
+    double x1 = cos_a * half_x + sin_a * half_y;
+    double y1 = -sin_a * half_x + cos_a * half_y;
+
+    // Radii too small to join the ends are scaled up, the center is then the
+    // middle of the chord
+    double ratio = x1 * x1 / (rx * rx) + y1 * y1 / (ry * ry);
+    double factor = 0;
+    if (ratio >= 1) {
+        rx *= std::sqrt(ratio);
+        ry *= std::sqrt(ratio);
+    } else {
+        factor = std::sqrt((1 - ratio) / ratio);
+    }
+    if (arc.large_arc_flag == arc.sweep_flag) factor = -factor;
+    double cx1 = factor * rx * y1 / ry, cy1 = -factor * ry * x1 / rx;
+    center_arc.center =
+        Vector2Df(cos_a * cx1 - sin_a * cy1 + (start.x + end.x) / 2.0,
+                  sin_a * cx1 + cos_a * cy1 + (start.y + end.y) / 2.0);
+    center_arc.u = Vector2Df(rx * cos_a, rx * sin_a);
+    center_arc.v = Vector2Df(-ry * sin_a, ry * cos_a);
+
+    double start_angle = std::atan2((y1 - cy1) / ry, (x1 - cx1) / rx);
+    double end_angle = std::atan2((-y1 - cy1) / ry, (-x1 - cx1) / rx);
+    double sweep_angle = end_angle - start_angle;
+    if (arc.sweep_flag && sweep_angle < 0) {
+        sweep_angle += 2 * std::acos(-1.0);
+    } else if (!arc.sweep_flag && sweep_angle > 0) {
+        sweep_angle -= 2 * std::acos(-1.0);
+    }
+    center_arc.start_angle = start_angle;
+    center_arc.sweep_angle = sweep_angle;
+    return true;
+}
+
+Path::Path(const ColorShape& fill, const ColorShape& stroke, float stroke_width,
+           const std::pmr::polymorphic_allocator<>& allocator,
+           const std::pmr::polymorphic_allocator<>& cache_allocator)
+    : SVGElement(ElementKind::Path, fill, stroke, stroke_width),
+      commands(allocator), points(allocator), arcs(allocator),
+      fill_rule(FillRule::NonZero), flat_cache(cache_allocator) {}
 
 std::string Path::getClass() const { return "Path"; }
 
-void Path::addPoint(PathPoint point) { points.push_back(point); }
+void Path::addPoint(char command, const Vector2Df& point) {
+    commands.push_back(command);
+    points.push_back(point);
+    flat_cache.clear();
+    invalidateBounds();
+}
+
+void Path::addArc(const Vector2Df& point, const PathArc& arc) {
+    addPoint('a', point);
+    arcs.push_back(arc);
+}
+
+bool Path::setGeometry(const PathView& geometry) {
+    // visit() reads an arc for each 'a' command, without checking
+    if (geometry.commands.size() != geometry.points.size() ||
+        std::count(geometry.commands.begin(), geometry.commands.end(), 'a') !=
+            (std::ptrdiff_t)geometry.arcs.size())
+        return false;
+    commands.assign(geometry.commands.begin(), geometry.commands.end());
+    points.assign(geometry.points.begin(), geometry.points.end());
+    arcs.assign(geometry.arcs.begin(), geometry.arcs.end());
+    flat_cache.clear();
+    invalidateBounds();
+    return true;
+}
 
-std::vector< PathPoint > Path::getPoints() const { return points; }
+PathView Path::getGeometry() const { return {commands, points, arcs}; }
 
-void Path::setFillRule(std::string fill_rule) { this->fill_rule = fill_rule; }
+const FlatPath& Path::getFlatPath(float tolerance) const {
+    int bucket = std::clamp(std::ilogb(tolerance), kMinBucket, kMaxBucket);
+    auto found =
+        std::find_if(flat_cache.begin(), flat_cache.end(),
+                     [bucket](const FlatEntry& entry) {
+                         return entry.bucket == bucket;
+                     });
+    if (found != flat_cache.end()) {
+        std::rotate(flat_cache.begin(), found, found + 1);
+        return flat_cache.front().flat;
+    }
+
+    // A new bucket takes the place of the least recently used one, reusing
+    // its memory
+    if (flat_cache.size() < kFlatCacheSize) {
+        flat_cache.reserve(kFlatCacheSize);
+        flat_cache.emplace_back(bucket, flat_cache.get_allocator());
+    } else {
+        flat_cache.back().bucket = bucket;
+    }
+    std::rotate(flat_cache.begin(), flat_cache.end() - 1, flat_cache.end());
+    flattenPath(*this, std::ldexp(1.f, bucket), flat_cache.front().flat);
+    return flat_cache.front().flat;
+}
+
+void Path::setFillRule(FillRule fill_rule) { this->fill_rule = fill_rule; }
+
+FillRule Path::getFillRule() const { return fill_rule; }
+
+void Path::visit(PathVisitor& visitor) const {
+    std::size_t n = points.size(), next_arc = 0;
+    Vector2Df first_point(0, 0), cur_point(0, 0);
+    Vector2Df control_point(0, 0);  // Last control point, for s and t
+    char previous = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        char command = commands[i];
+        if (command == 'm') {
+            first_point = cur_point = points[i];
+            visitor.moveTo(cur_point);
+        } else if (command == 'c' || command == 's') {
+            std::size_t count = command == 'c' ? 3 : 2;
+            if (i + count > n) continue;
+            Vector2Df control1 = cur_point;
+            if (command == 'c') {
+                control1 = points[i++];
+            } else if (previous == 'c' || previous == 's') {
+                control1 = cur_point * 2.f - control_point;
+            }
+            control_point = points[i];
+            visitor.cubicTo(cur_point, control1, control_point, points[i + 1]);
+            cur_point = points[++i];
+        } else if (command == 'q' || command == 't') {
+            if (command == 'q') {
+                if (i + 2 > n) continue;
+                control_point = points[i++];
+            } else if (previous == 'q' || previous == 't') {
+                control_point = cur_point * 2.f - control_point;
+            } else {
+                control_point = cur_point;
+            }
+            visitor.quadraticTo(cur_point, control_point, points[i]);
+            cur_point = points[i];
+        } else if (command == 'a') {
+            visitor.arcTo(cur_point, points[i], arcs[next_arc++]);
+            cur_point = points[i];
+        } else if (command == 'z') {
+            visitor.close(cur_point, first_point);
+            cur_point = first_point;
+        } else {
+            visitor.lineTo(cur_point, points[i]);
+            cur_point = points[i];
+        }
+        previous = command;
+    }
+}
 
-std::string Path::getFillRule() const { return fill_rule; }
+BoundingBox Path::computeBounds(const AffineTransform& matrix) const {
+    BoundsVisitor visitor(matrix);
+    visit(visitor);
+    return visitor.box;
+}
 
 void Path::printData() const {
     SVGElement::printData();
     std::cout << "Points: ";
-    for (auto point : points) {
-        std::cout << point.tc << " " << point.point.x << " " << point.point.y
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        std::cout << commands[i] << " " << points[i].x << " " << points[i].y
                   << " ";
     }
 }
\ No newline at end of file
@@ -1,28 +1,140 @@
 #ifndef PATH_HPP_
 #define PATH_HPP_
 
+#include <memory_resource>
+#include <span>
+
+#include "FlatPath.hpp"
 #include "SVGElement.hpp"
 
 /**
- * @brief A struct that contains a point and a type of point.
+ * @brief The parameters of an elliptical arc of a path.
  */
-
-struct PathPoint {
-    Vector2Df point;              ///< Point in 2D space
-    char tc;                      ///< Type of point
+struct PathArc {
     Vector2Df radius{0, 0};       ///< Radius of the arc
     float x_axis_rotation = 0.f;  ///< Rotation of the arc
     bool large_arc_flag = false;  ///< Flag for large arc
     bool sweep_flag = false;      ///< Flag for sweep
 };
 
+/**
+ * @brief An elliptical arc in center form.
+ *
+ * The point of the arc at angle t is center + u * cos(t) + v * sin(t), the
+ * axes u and v holding the radii and the rotation of the ellipse.
+ */
+struct CenterArc {
+    Vector2Df center;   ///< Center of the ellipse
+    Vector2Df u;        ///< Point at angle 0, relative to the center
+    Vector2Df v;        ///< Point at angle pi / 2, relative to the center
+    float start_angle;  ///< Angle of the start point, in radians
+    float sweep_angle;  ///< Signed angle from the start to the end point
+};
+
+/**
+ * @brief Converts an arc of a path from its end points to its center.
+ *
+ * @param start The point the arc starts from.
+ * @param end The point the arc ends at.
+ * @param arc The parameters of the arc.
+ * @param center_arc Receives the arc in center form.
+ * @return False if the arc is a line, with a zero radius, or nothing, ending
+ * where it starts.
+ * @note Radii too small to join the ends are scaled up, as in the appendix
+ * of the SVG specification.
+ */
+bool toCenterArc(const Vector2Df& start, const Vector2Df& end,
+                 const PathArc& arc, CenterArc& center_arc);
+
+/**
+ * @brief Receives the segments of a path, walked by Path::visit.
+ *
+ * The segments come in absolute coordinates with the control points the
+ * SVG definitions give them, the reflected ones of 's' and 't' included.
+ */
+class PathVisitor {
+public:
+    virtual ~PathVisitor() = default;
+
+    /**
+     * @brief Starts a subpath.
+     *
+     * @param point The first point of the subpath.
+     */
+    virtual void moveTo(const Vector2Df& point) = 0;
+
+    /**
+     * @brief Receives a straight line.
+     *
+     * @param start The start point of the line.
+     * @param end The end point of the line.
+     */
+    virtual void lineTo(const Vector2Df& start, const Vector2Df& end) = 0;
+
+    /**
+     * @brief Receives a quadratic Bezier curve.
+     *
+     * @param start The start point of the curve.
+     * @param control The control point of the curve.
+     * @param end The end point of the curve.
+     */
+    virtual void quadraticTo(const Vector2Df& start, const Vector2Df& control,
+                             const Vector2Df& end) = 0;
+
+    /**
+     * @brief Receives a cubic Bezier curve.
+     *
+     * @param start The start point of the curve.
+     * @param control1 The first control point of the curve.
+     * @param control2 The second control point of the curve.
+     * @param end The end point of the curve.
+     */
+    virtual void cubicTo(const Vector2Df& start, const Vector2Df& control1,
+                         const Vector2Df& control2, const Vector2Df& end) = 0;
+
+    /**
+     * @brief Receives an elliptical arc.
+     *
+     * @param start The start point of the arc.
+     * @param end The end point of the arc.
+     * @param arc The parameters of the arc.
+     */
+    virtual void arcTo(const Vector2Df& start, const Vector2Df& end,
+                       const PathArc& arc) = 0;
+
+    /**
+     * @brief Closes the subpath with a line back to its first point.
+     *
+     * @param start The current point.
+     * @param end The first point of the subpath.
+     * @note The next segment starts a new subpath from the first point, if
+     * no moveTo comes before it.
+     */
+    virtual void close(const Vector2Df& start, const Vector2Df& end) = 0;
+};
+
+/**
+ * @brief A non-owning view of the geometry of a path.
+ *
+ * Vertex i has the lowercase command commands[i] and the absolute position
+ * points[i]. A curve command spans several vertices, one per control point
+ * and one for its end point. The arcs hold the parameters of the 'a'
+ * vertices, in the order they appear.
+ */
+struct PathView {
+    std::span< const char > commands;    ///< Command of each vertex
+    std::span< const Vector2Df > points;  ///< Position of each vertex
+    std::span< const PathArc > arcs;      ///< Parameters of the arcs
+};
+
 /**
  * @brief Represents a path element in 2D space.
  *
  * The Path class is derived from the SVGElement class and represents a path
  * element in 2D space. The Path class is used to draw lines, curves, arcs, and
- * other shapes. The Path class contains a vector of PathPoints that represent
- * the points in the path.
+ * other shapes. The geometry is stored as a stream of command bytes, a packed
+ * array of vertex coordinates and the parameters of the arcs only, about a
+ * third of the memory of a full record per vertex.
  *
  */
 class Path : public SVGElement {
@@ -33,8 +145,14 @@ public:
      * @param fill Fill color of the path.
      * @param stroke Outline color of the path.
      * @param stroke_width Thickness of the path outline.
+     * @param allocator The allocator of the geometry.
+     * @param cache_allocator The allocator of the cached flattenings, which
+     * must free memory: they are replaced as the path is drawn at other
+     * scales.
      */
-    Path(const ColorShape& fill, const ColorShape& stroke, float stroke_width);
+    Path(const ColorShape& fill, const ColorShape& stroke, float stroke_width,
+         const std::pmr::polymorphic_allocator<>& allocator = {},
+         const std::pmr::polymorphic_allocator<>& cache_allocator = {});
 
     /**
      * @brief Gets the type of the shape.
@@ -44,20 +162,63 @@ public:
     std::string getClass() const override;
 
     /**
-     * @brief Adds a point to the path.
+     * @brief Adds a vertex to the path.
      *
-     * @param point The point to be added to the path.
+     * @param command The lowercase command of the vertex, other than 'a'.
+     * @param point The absolute position of the vertex.
+     */
+    void addPoint(char command, const Vector2Df& point);
+
+    /**
+     * @brief Adds an elliptical arc to the path.
      *
-     * @note This function is used for adding points to the path.
+     * @param point The absolute end point of the arc.
+     * @param arc The parameters of the arc.
      */
-    void addPoint(PathPoint point);
+    void addArc(const Vector2Df& point, const PathArc& arc);
 
     /**
-     * @brief Gets the vector of points in the path.
+     * @brief Replaces the geometry of the path.
      *
-     * @return The vector of points in the path.
+     * @param geometry The commands, vertices and arcs to be copied.
+     * @return False if the view has not one command per vertex and one arc
+     * per 'a' command, the path is then left unchanged.
+     *
+     * @note The storage is allocated once, at the exact size.
      */
-    std::vector< PathPoint > getPoints() const;
+    bool setGeometry(const PathView& geometry);
+
+    /**
+     * @brief Gets the geometry of the path.
+     *
+     * @return A view of the geometry, valid until the path is modified.
+     */
+    PathView getGeometry() const;
+
+    /**
+     * @brief Walks the segments of the path.
+     *
+     * @param visitor The visitor receiving each segment in order.
+     * @note The vertices of a curve missing its end are skipped, as the
+     * renderer does.
+     */
+    void visit(PathVisitor& visitor) const;
+
+    /**
+     * @brief Gets the path flattened into polylines.
+     *
+     * @param tolerance The largest distance between the path and its lines,
+     * in the coordinates of the path.
+     * @return The flattening, valid until the path is modified or flattened
+     * again.
+     * @note The tolerances are bucketed by powers of two, each flattened at
+     * the bottom of its bucket, and the flattenings of the last few buckets
+     * are cached: drawing at up to twice the scale reuses them. The cache is
+     * not locked, the path is drawn from one thread. Its memory comes from
+     * the cache allocator, so a flattening that outgrows its buffer at a
+     * finer tolerance frees the old one.
+     */
+    const FlatPath& getFlatPath(float tolerance) const;
 
     /**
      * @brief Sets the fill rule of the path.
@@ -65,19 +226,28 @@ public:
      * @param fill_rule The new fill rule of the path.
      *
      * @note This function is used for setting the fill rule of the path.
-     * @note The fill rule can be either "nonzero" or "evenodd".
      */
-    void setFillRule(std::string fill_rule);
+    void setFillRule(FillRule fill_rule);
 
     /**
      * @brief Gets the current fill rule of the path.
      *
      * @return The current fill rule of the path.
      *
-     * @note The fill rule can be either "nonzero" or "evenodd".
-     * @note The default fill rule is "nonzero".
+     * @note The default fill rule is FillRule::NonZero.
      */
-    std::string getFillRule() const;
+    FillRule getFillRule() const;
+
+    /**
+     * @brief Computes the bounds of the path mapped through a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the path.
+     * @return The box of the mapped path. The control points are mapped, then
+     * the extrema of each Bezier curve and of each arc are solved exactly.
+     * @note The curves and arcs follow the SVG definitions: quadratic curves
+     * are bounded as Bezier curves and arcs with their x-axis rotation.
+     */
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
 
     /**
      * @brief Prints the data of the shape.
@@ -87,8 +257,24 @@ public:
     void printData() const override;
 
 private:
-    std::vector< PathPoint > points;  ///< Vector of points in the path
-    std::string fill_rule;            ///< Fill rule of the path
+    /**
+     * @brief A flattening cached for a bucket of tolerances.
+     */
+    struct FlatEntry {
+        int bucket;     ///< Power of two of the tolerance
+        FlatPath flat;  ///< Flattening at that tolerance
+
+        FlatEntry(int bucket,
+                  const std::pmr::polymorphic_allocator<>& allocator)
+            : bucket(bucket), flat(allocator) {}
+    };
+
+    std::pmr::vector< char > commands;    ///< Command of each vertex
+    std::pmr::vector< Vector2Df > points;  ///< Position of each vertex
+    std::pmr::vector< PathArc > arcs;      ///< Parameters of the arcs
+    FillRule fill_rule;                    ///< Fill rule of the path
+    mutable std::pmr::vector< FlatEntry >
+        flat_cache;  ///< Flattenings, the most recently used first
 };
 
-#endif
\ No newline at end of file
+#endif
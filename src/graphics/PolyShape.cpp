@@ -1,37 +1,30 @@
 #include "PolyShape.hpp"
 
-PolyShape::PolyShape(const ColorShape& fill, const ColorShape& stroke,
-                     float stroke_width)
-    : SVGElement(fill, stroke, stroke_width) {}
-
-void PolyShape::addPoint(const Vector2Df& point) { points.push_back(point); }
+PolyShape::PolyShape(ElementKind kind, const ColorShape& fill,
+                     const ColorShape& stroke, float stroke_width,
+                     const std::pmr::polymorphic_allocator<>& allocator)
+    : SVGElement(kind, fill, stroke, stroke_width), points(allocator),
+      fill_rule(FillRule::NonZero) {}
+
+void PolyShape::addPoint(const Vector2Df& point) {
+    points.push_back(point);
+    invalidateBounds();
+}
 
-const std::vector< Vector2Df >& PolyShape::getPoints() const { return points; }
+const std::pmr::vector< Vector2Df >& PolyShape::getPoints() const {
+    return points;
+}
 
-void PolyShape::setFillRule(std::string fill_rule) {
+void PolyShape::setFillRule(FillRule fill_rule) {
     this->fill_rule = fill_rule;
 }
 
-std::string PolyShape::getFillRule() const { return fill_rule; }
+FillRule PolyShape::getFillRule() const { return fill_rule; }
 
-Vector2Df PolyShape::getMinBound() const {
-    float min_x = points[0].x;
-    float min_y = points[0].y;
-    for (auto& point : points) {
-        min_x = std::min(min_x, point.x);
-        min_y = std::min(min_y, point.y);
-    }
-    return Vector2Df(min_x, min_y);
-}
-
-Vector2Df PolyShape::getMaxBound() const {
-    float max_x = points[0].x;
-    float max_y = points[0].y;
-    for (auto& point : points) {
-        max_x = std::max(max_x, point.x);
-        max_y = std::max(max_y, point.y);
-    }
-    return Vector2Df(max_x, max_y);
+BoundingBox PolyShape::computeBounds(const AffineTransform& matrix) const {
+    BoundingBox box;
+    for (const Vector2Df& point : points) box.add(matrix.apply(point));
+    return box;
 }
 
 void PolyShape::printData() const {
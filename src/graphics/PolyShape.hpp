@@ -1,6 +1,8 @@
 #ifndef POLYSHAPE_HPP_
 #define POLYSHAPE_HPP_
 
+#include <memory_resource>
+
 #include "SVGElement.hpp"
 
 /**
@@ -11,20 +13,23 @@
  */
 class PolyShape : public SVGElement {
 protected:
-    std::vector< Vector2Df > points;  ///< Vertices of the polyshape
-    std::string fill_rule;            ///< Fill rule of the polyshape
+    std::pmr::vector< Vector2Df > points;  ///< Vertices of the polyshape
+    FillRule fill_rule;                    ///< Fill rule of the polyshape
 
     /**
      * @brief Constructs a PolyShape object.
      *
+     * @param kind The kind of the polyshape.
      * @param fill Fill color of the polyshape (default is
      * sf::Color::Transparent).
      * @param stroke Outline color of the polyshape (default is
      * sf::Color::White).
      * @param stroke_width Thickness of the polyshape outline (default is 0).
+     * @param allocator The allocator of the vertices.
      */
-    PolyShape(const ColorShape &fill, const ColorShape &stroke,
-              float stroke_width);
+    PolyShape(ElementKind kind, const ColorShape &fill,
+              const ColorShape &stroke, float stroke_width,
+              const std::pmr::polymorphic_allocator<> &allocator);
 
 public:
     /**
@@ -47,35 +52,29 @@ public:
      *
      * @return The number of vertices representing the shape.
      */
-    const std::vector< Vector2Df > &getPoints() const;
+    const std::pmr::vector< Vector2Df > &getPoints() const;
 
     /**
      * @brief Sets the fill rule of the polyshape.
      *
      * @param fill_rule The new fill rule of the polyshape.
      */
-    void setFillRule(std::string fill_rule);
+    void setFillRule(FillRule fill_rule);
 
     /**
      * @brief Gets the fill rule of the polyshape.
      *
      * @return The fill rule of the polyshape.
      */
-    std::string getFillRule() const;
-
-    /**
-     * @brief Gets the minimum bounding box of the shape.
-     *
-     * @return The minimum bounding box of the shape.
-     */
-    Vector2Df getMinBound() const override;
+    FillRule getFillRule() const;
 
     /**
-     * @brief Gets the maximum bounding box of the shape.
+     * @brief Computes the bounds of the shape mapped through a matrix.
      *
-     * @return The maximum bounding box of the shape.
+     * @param matrix The matrix mapping the coordinates of the shape.
+     * @return The box of the mapped vertices.
      */
-    Vector2Df getMaxBound() const override;
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
 
     /**
      * @brief Prints the data of the shape.
@@ -1,6 +1,7 @@
 #include "Polygon.hpp"
 
-Plygon::Plygon(ColorShape fill, ColorShape stroke, float stroke_width)
-    : PolyShape(fill, stroke, stroke_width) {}
+Plygon::Plygon(ColorShape fill, ColorShape stroke, float stroke_width,
+               const std::pmr::polymorphic_allocator<>& allocator)
+    : PolyShape(ElementKind::Polygon, fill, stroke, stroke_width, allocator) {}
 
 std::string Plygon::getClass() const { return "Polygon"; }
\ No newline at end of file
@@ -18,8 +18,10 @@ public:
      * sf::Color::Transparent).
      * @param stroke Outline color of the polygon (default is sf::Color::White).
      * @param stroke_width Thickness of the polygon outline (default is 0).
+     * @param allocator The allocator of the vertices.
      */
-    Plygon(ColorShape fill, ColorShape stroke, float stroke_width);
+    Plygon(ColorShape fill, ColorShape stroke, float stroke_width,
+           const std::pmr::polymorphic_allocator<>& allocator = {});
 
     /**
      * @brief Gets the type of the shape.
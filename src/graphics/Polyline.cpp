@@ -1,7 +1,9 @@
 #include "Polyline.hpp"
 
 Plyline::Plyline(const ColorShape& fill, const ColorShape& stroke,
-                 float stroke_width)
-    : PolyShape(fill, stroke, stroke_width) {}
+                 float stroke_width,
+                 const std::pmr::polymorphic_allocator<>& allocator)
+    : PolyShape(ElementKind::Polyline, fill, stroke, stroke_width,
+                allocator) {}
 
 std::string Plyline::getClass() const { return "Polyline"; }
\ No newline at end of file
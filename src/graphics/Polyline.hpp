@@ -19,9 +19,11 @@ public:
      * sf::Color::White).
      * @param fill The fill color of the polyline (default is
      * sf::Color::Transparent).
+     * @param allocator The allocator of the vertices.
      */
     Plyline(const ColorShape& fill, const ColorShape& stroke,
-            float stroke_width);
+            float stroke_width,
+            const std::pmr::polymorphic_allocator<>& allocator = {});
 
     /**
      * @brief Gets the type of the shape.
@@ -1,9 +1,9 @@
 #include "RadialGradient.hpp"
 
-RadialGradient::RadialGradient(std::vector< Stop > stops,
+RadialGradient::RadialGradient(StopRamp stops,
                                std::pair< Vector2Df, Vector2Df > points,
-                               Vector2Df radius, std::string units)
-    : Gradient(stops, points, units) {
+                               Vector2Df radius, GradientUnits units)
+    : Gradient(GradientKind::Radial, std::move(stops), points, units) {
     this->radius = radius;
 }
 
@@ -21,9 +21,8 @@ public:
      * @param radius The radius of the gradient.
      * @param units The units of the gradient.
      */
-    RadialGradient(std::vector< Stop > stops,
-                   std::pair< Vector2Df, Vector2Df > points, Vector2Df radius,
-                   std::string units);
+    RadialGradient(StopRamp stops, std::pair< Vector2Df, Vector2Df > points,
+                   Vector2Df radius, GradientUnits units);
 
     /**
      * @brief Gets the type of the gradient.
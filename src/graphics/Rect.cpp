@@ -1,24 +1,60 @@
 #include "Rect.hpp"
 
+#include <cmath>
+
 Rect::Rect(float width, float height, Vector2Df position, Vector2Df radius,
            const ColorShape &fill, const ColorShape &stroke, float stroke_width)
-    : SVGElement(fill, stroke, stroke_width, position), width(width),
-      height(height), radius(radius) {}
+    : SVGElement(ElementKind::Rect, fill, stroke, stroke_width, position),
+      width(width), height(height), radius(radius) {}
 
 std::string Rect::getClass() const { return "Rect"; }
 
-void Rect::setWidth(float width) { this->width = width; }
+void Rect::setWidth(float width) {
+    this->width = width;
+    invalidateBounds();
+}
 
 float Rect::getWidth() const { return width; }
 
-void Rect::setHeight(float height) { this->height = height; }
+void Rect::setHeight(float height) {
+    this->height = height;
+    invalidateBounds();
+}
 
 float Rect::getHeight() const { return height; }
 
-void Rect::setRadius(const Vector2Df &radius) { this->radius = radius; }
+void Rect::setRadius(const Vector2Df &radius) {
+    this->radius = radius;
+    invalidateBounds();
+}
 
 Vector2Df Rect::getRadius() const { return radius; }
 
+BoundingBox Rect::computeBounds(const AffineTransform &matrix) const {
+    // A rounded rectangle is its inner rectangle grown by the ellipse of the
+    // corners, bounded as the box of the mapped inner corners grown by the
+    // extents of the mapped ellipse. The renderer does not clamp radii larger
+    // than half the sides, those rectangles are bounded by their corners
+    Vector2Df position = getPosition();
+    Vector2Df corner(std::abs(radius.x), std::abs(radius.y));
+    if (corner.x == 0 || corner.y == 0 || corner.x * 2 > std::abs(width) ||
+        corner.y * 2 > std::abs(height))
+        corner = Vector2Df(0, 0);
+    BoundingBox box;
+    box.add(matrix.apply(position + corner));
+    box.add(matrix.apply(Vector2Df(position.x + width - corner.x,
+                                   position.y + corner.y)));
+    box.add(matrix.apply(Vector2Df(position.x + corner.x,
+                                   position.y + height - corner.y)));
+    box.add(matrix.apply(
+        Vector2Df(position.x + width, position.y + height) - corner));
+    Vector2Df extent(std::hypot(matrix.a * corner.x, matrix.c * corner.y),
+                     std::hypot(matrix.b * corner.x, matrix.d * corner.y));
+    box.min -= extent;
+    box.max += extent;
+    return box;
+}
+
 void Rect::printData() const {
     SVGElement::printData();
     std::cout << "Width: " << getWidth() << std::endl;
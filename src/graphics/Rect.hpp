@@ -80,6 +80,14 @@ public:
      */
     Vector2Df getRadius() const;
 
+    /**
+     * @brief Computes the bounds of the rectangle mapped through a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the rectangle.
+     * @return The box of the mapped rectangle, rounded corners included.
+     */
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
+
     /**
      * @brief Prints the data of the rectangle.
      *
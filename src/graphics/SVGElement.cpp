@@ -2,29 +2,40 @@
 
 #include <iostream>
 
-SVGElement::SVGElement()
-    : fill(ColorShape::Black), stroke(ColorShape::Transparent), stroke_width(1),
-      gradient(NULL) {}
-
-SVGElement::SVGElement(const ColorShape& fill, const ColorShape& stroke,
-                       float stroke_width)
-    : fill(fill), stroke(stroke), stroke_width(stroke_width), gradient(NULL) {}
-
-SVGElement::SVGElement(const ColorShape& fill, const ColorShape& stroke,
-                       float stroke_width, const Vector2Df& position)
-    : fill(fill), stroke(stroke), stroke_width(stroke_width),
-      position(position), gradient(NULL) {}
+SVGElement::SVGElement(ElementKind kind)
+    : parent(NULL), kind(kind), fill(ColorShape::Black),
+      stroke(ColorShape::Transparent), stroke_width(1), gradient(NULL),
+      style(NULL), bounds_dirty(true) {}
+
+SVGElement::SVGElement(ElementKind kind, const ColorShape& fill,
+                       const ColorShape& stroke, float stroke_width)
+    : parent(NULL), kind(kind), fill(fill), stroke(stroke),
+      stroke_width(stroke_width), gradient(NULL), style(NULL),
+      bounds_dirty(true) {}
+
+SVGElement::SVGElement(ElementKind kind, const ColorShape& fill,
+                       const ColorShape& stroke, float stroke_width,
+                       const Vector2Df& position)
+    : parent(NULL), kind(kind), fill(fill), stroke(stroke),
+      stroke_width(stroke_width), position(position), gradient(NULL),
+      style(NULL), bounds_dirty(true) {}
+
+ElementKind SVGElement::getKind() const { return kind; }
 
 void SVGElement::setFillColor(const ColorShape& color) { fill = color; }
 
 const ColorShape& SVGElement::getFillColor() const { return fill; }
 
-void SVGElement::setOutlineColor(const ColorShape& color) { stroke = color; }
+void SVGElement::setOutlineColor(const ColorShape& color) {
+    stroke = color;
+    invalidateBounds();
+}
 
 const ColorShape& SVGElement::getOutlineColor() const { return stroke; }
 
 void SVGElement::setOutlineThickness(float thickness) {
     stroke_width = thickness;
+    invalidateBounds();
 }
 
 float SVGElement::getOutlineThickness() const { return stroke_width; }
@@ -32,6 +43,7 @@ float SVGElement::getOutlineThickness() const { return stroke_width; }
 void SVGElement::setPosition(float x, float y) {
     position.x = x;
     position.y = y;
+    invalidateBounds();
 }
 
 void SVGElement::setPosition(const Vector2Df& position) {
@@ -40,9 +52,69 @@ void SVGElement::setPosition(const Vector2Df& position) {
 
 Vector2Df SVGElement::getPosition() const { return position; }
 
-Vector2Df SVGElement::getMinBound() const { return Vector2Df(); }
+Vector2Df SVGElement::getMinBound() const {
+    const BoundingBox& box = getLocalBounds();
+    return box.isEmpty() ? Vector2Df() : box.min;
+}
+
+Vector2Df SVGElement::getMaxBound() const {
+    const BoundingBox& box = getLocalBounds();
+    return box.isEmpty() ? Vector2Df() : box.max;
+}
+
+BoundingBox SVGElement::computeBounds(const AffineTransform&) const {
+    return BoundingBox();
+}
+
+BoundingBox SVGElement::getBounds(const AffineTransform& matrix) const {
+    BoundingBox box = computeBounds(matrix);
+    addOutline(box, matrix);
+    return box;
+}
+
+const BoundingBox& SVGElement::getLocalBounds() const {
+    if (bounds_dirty) updateBounds();
+    return local_bounds;
+}
+
+const BoundingBox& SVGElement::getBounds() const {
+    if (bounds_dirty) updateBounds();
+    return bounds;
+}
+
+BoundingBox SVGElement::getWorldBounds() const {
+    // Compose the transforms first, to map the box only once
+    AffineTransform matrix;
+    for (const SVGElement* ancestor = parent;
+         ancestor != NULL && ancestor->parent != NULL;
+         ancestor = ancestor->parent)
+        matrix = ancestor->transform * matrix;
+    return getBounds().transform(matrix);
+}
 
-Vector2Df SVGElement::getMaxBound() const { return Vector2Df(); }
+void SVGElement::invalidateBounds() {
+    // The ancestors of a dirty shape are dirty already
+    for (SVGElement* element = this; element != NULL && !element->bounds_dirty;
+         element = element->parent)
+        element->bounds_dirty = true;
+}
+
+void SVGElement::updateBounds() const {
+    local_bounds = computeBounds(AffineTransform());
+    // Without a transform, the geometry is bounded once
+    bounds = transform.isIdentity() ? local_bounds : computeBounds(transform);
+    addOutline(bounds, transform);
+    bounds_dirty = false;
+}
+
+void SVGElement::addOutline(BoundingBox& box,
+                            const AffineTransform& matrix) const {
+    // Groups and uses draw no outline of their own
+    if (kind == ElementKind::Group || kind == ElementKind::Use ||
+        stroke.a == 0 || stroke_width <= 0)
+        return;
+    box.expand(stroke_width / 2 * matrix.getMaxScale());
+}
 
 void SVGElement::printData() const {
     std::cout << "Shape: " << getClass() << std::endl;
@@ -51,11 +123,9 @@ void SVGElement::printData() const {
     std::cout << "Stroke width: " << getOutlineThickness() << std::endl;
     std::cout << "Position: " << getPosition().x << " " << getPosition().y
               << std::endl;
-    std::cout << "Transforms: ";
-    for (auto transform : transforms) {
-        std::cout << transform << " ";
-    }
-    std::cout << std::endl;
+    std::cout << "Transform: " << transform.a << " " << transform.b << " "
+              << transform.c << " " << transform.d << " " << transform.e << " "
+              << transform.f << std::endl;
     if (gradient != NULL)
         std::cout << "Gradient: " << gradient->getClass() << " "
                   << gradient->getPoints().first.x << " "
@@ -64,13 +134,12 @@ void SVGElement::printData() const {
                   << gradient->getPoints().second.y << std::endl;
 }
 
-void SVGElement::setTransforms(const std::vector< std::string >& transforms) {
-    this->transforms = transforms;
+void SVGElement::setTransform(const AffineTransform& transform) {
+    this->transform = transform;
+    invalidateBounds();
 }
 
-std::vector< std::string > SVGElement::getTransforms() const {
-    return transforms;
-}
+const AffineTransform& SVGElement::getTransform() const { return transform; }
 
 void SVGElement::setParent(SVGElement* parent) { this->parent = parent; }
 
@@ -80,4 +149,12 @@ void SVGElement::setGradient(Gradient* gradient) { this->gradient = gradient; }
 
 Gradient* SVGElement::getGradient() const { return gradient; }
 
-void SVGElement::addElement(SVGElement* element) {}
\ No newline at end of file
+void SVGElement::setStyle(const ComputedStyle* style) {
+    this->style = style;
+}
+
+const ComputedStyle* SVGElement::getStyle() const {
+    return style;
+}
+
+void SVGElement::addElement(SVGElement*) {}
\ No newline at end of file
@@ -1,12 +1,44 @@
 #ifndef SVG_ELEMENT_HPP_
 #define SVG_ELEMENT_HPP_
 
+#include <cstdint>
 #include <vector>
 
+#include "AffineTransform.hpp"
+#include "BoundingBox.hpp"
 #include "ColorShape.hpp"
 #include "Gradient.hpp"
 #include "Vector2D.hpp"
 
+class ComputedStyle;
+
+/**
+ * @brief The kind of an SVGElement, fixed when the element is constructed.
+ *
+ * Code that handles each kind of element differently switches on the kind
+ * and then casts the element, instead of comparing the class names.
+ */
+enum class ElementKind : std::uint8_t {
+    Group,
+    Line,
+    Rect,
+    Circle,
+    Ellipse,
+    Polygon,
+    Polyline,
+    Path,
+    Text,
+    Use,
+};
+
+/**
+ * @brief The fill-rule of a shape, parsed once when the shape is built.
+ */
+enum class FillRule : std::uint8_t {
+    NonZero,  ///< "nonzero", the default
+    EvenOdd,  ///< "evenodd"
+};
+
 /**
  * @brief Represents an element in an SVG file.
  * @note This class is abstract and cannot be instantiated.
@@ -27,12 +59,20 @@ public:
      *
      * @return The type of the shape
      *
-     * @note This function is used for determining the type of the shape.
+     * @note This function is used for printing the type of the shape, the
+     * kind is used to tell the shapes apart.
      * @note This function is pure virtual and must be implemented by derived
      * classes.
      */
     virtual std::string getClass() const = 0;
 
+    /**
+     * @brief Gets the kind of the shape.
+     *
+     * @return The kind of the shape, the same for the whole life of the shape.
+     */
+    ElementKind getKind() const;
+
     /**
      * @brief Sets the fill color of the shape.
      *
@@ -109,16 +149,89 @@ public:
     /**
      * @brief Gets the minimum bound of the shape.
      *
-     * @return The minimum bound of the shape.
+     * @return The minimum bound of the geometry of the shape, in its own
+     * coordinates, or (0, 0) if the shape is empty.
+     * @note The bounds are cached, see getLocalBounds().
      */
-    virtual Vector2Df getMinBound() const;
+    Vector2Df getMinBound() const;
 
     /**
      * @brief Gets the maximum bound of the shape.
      *
-     * @return The maximum bound of the shape.
+     * @return The maximum bound of the geometry of the shape, in its own
+     * coordinates, or (0, 0) if the shape is empty.
+     * @note The bounds are cached, see getLocalBounds().
+     */
+    Vector2Df getMaxBound() const;
+
+    /**
+     * @brief Computes the bounds of the geometry of the shape mapped through
+     * a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the shape.
+     * @return The smallest box containing the mapped geometry, without the
+     * outline. The geometry is mapped before it is bounded, so the box stays
+     * tight under rotations and skews, and the extrema of the curves and arcs
+     * are solved exactly.
+     * @note The result is not cached. The bounds of a group or a use are
+     * those of the cached bounds of its children, and the bounds of a text
+     * are estimated from its font size.
+     * @note This function is virtual and overridden by every kind of shape.
+     */
+    virtual BoundingBox computeBounds(const AffineTransform& matrix) const;
+
+    /**
+     * @brief Computes the bounds of the shape mapped through a matrix, with
+     * its outline.
+     *
+     * @param matrix The matrix mapping the coordinates of the shape.
+     * @return The bounds of the geometry, grown by half the outline
+     * thickness scaled by the matrix if the outline is drawn.
+     * @note The spikes of the mitered joins of sharp corners are not
+     * contained.
+     */
+    BoundingBox getBounds(const AffineTransform& matrix) const;
+
+    /**
+     * @brief Gets the bounds of the geometry of the shape.
+     *
+     * @return The bounds in the coordinates of the shape, without the
+     * transform of the shape nor the outline.
+     * @note The bounds are computed on first use and kept until the shape
+     * changes, see invalidateBounds().
+     */
+    const BoundingBox& getLocalBounds() const;
+
+    /**
+     * @brief Gets the bounds of the shape in the coordinates of its parent.
+     *
+     * @return The bounds of the shape mapped through its transform, with its
+     * outline.
+     * @note The bounds are computed on first use and kept until the shape
+     * changes, see invalidateBounds().
+     */
+    const BoundingBox& getBounds() const;
+
+    /**
+     * @brief Gets the bounds of the shape in the coordinates of the document.
+     *
+     * @return The cached bounds of the shape mapped through the transforms
+     * of its ancestors, the root excluded as the renderer draws it without
+     * its transform.
+     * @note A shape of a symbol is bounded in the coordinates of the symbol:
+     * the SceneStore bounds each use of it through the matrix of the use.
      */
-    virtual Vector2Df getMaxBound() const;
+    BoundingBox getWorldBounds() const;
+
+    /**
+     * @brief Marks the cached bounds of the shape and of its ancestors as
+     * out of date.
+     *
+     * @note The setters of the geometry, the transform and the outline call
+     * this function, and a group calls it when a shape is added to it. The
+     * bounds of a use are not invalidated when its symbol changes.
+     */
+    void invalidateBounds();
 
     /**
      * @brief Prints the data of the shape.
@@ -129,22 +242,21 @@ public:
     virtual void printData() const;
 
     /**
-     * @brief Sets the transformations of the shape.
+     * @brief Sets the transformation of the shape.
      *
-     * @param transforms The new transformations of the shape.
-     * @note The default transformations of the shape is empty.
-     * @note The transformations can be either "translate", "rotate", "scale",
+     * @param transform The transform list of the shape resolved into one
+     * matrix.
+     * @note The default transformation of the shape is the identity.
      */
-    void setTransforms(const std::vector< std::string >& transforms);
+    void setTransform(const AffineTransform& transform);
 
     /**
-     * @brief Gets the transformations of the shape.
+     * @brief Gets the transformation of the shape.
      *
-     * @return The transformations of the shape.
-     * @note The default transformations of the shape is empty.
-     * @note The transformations can be either "translate", "rotate", "scale",
+     * @return The transformation of the shape.
+     * @note The default transformation of the shape is the identity.
      */
-    std::vector< std::string > getTransforms() const;
+    const AffineTransform& getTransform() const;
 
     /**
      * @brief Parent pointer setter to make the composite design pattern
@@ -178,6 +290,22 @@ public:
      */
     Gradient* getGradient() const;
 
+    /**
+     * @brief Sets the computed style of the shape.
+     *
+     * @param style The resolved style record, shared with the elements that
+     * inherit it.
+     */
+    void setStyle(const ComputedStyle* style);
+
+    /**
+     * @brief Gets the computed style of the shape.
+     *
+     * @return The resolved style record of the shape.
+     * @note The default style of the shape is NULL.
+     */
+    const ComputedStyle* getStyle() const;
+
     /**
      * @brief Adds a shape to the composite group.
      * @param element The shape to be added to the composite group.
@@ -189,24 +317,27 @@ public:
 protected:
     /**
      * @brief Constructs a Shape object
+     * @param kind The kind of the shape
      * @note This constructor is protected because Shape is an abstract class
      * that cannot be instantiated.
      */
-    SVGElement();
+    SVGElement(ElementKind kind);
 
     /**
      * @brief Constructs a Shape object
+     * @param kind The kind of the shape
      * @param fill The fill color of the shape
      * @param stroke The outline color of the shape
      * @param stroke_width The outline thickness of the shape
      * @note This constructor is protected because Shape is an abstract class
      * that cannot be instantiated.
      */
-    SVGElement(const ColorShape& fill, const ColorShape& stroke,
-               float stroke_width);
+    SVGElement(ElementKind kind, const ColorShape& fill,
+               const ColorShape& stroke, float stroke_width);
 
     /**
      * @brief Constructs a Shape object
+     * @param kind The kind of the shape
      * @param fill The fill color of the shape
      * @param stroke The outline color of the shape
      * @param stroke_width The outline thickness of the shape
@@ -214,18 +345,37 @@ protected:
      * @note This constructor is protected because Shape is an abstract class
      * that cannot be instantiated.
      */
-    SVGElement(const ColorShape& fill, const ColorShape& stroke,
-               float stroke_width, const Vector2Df& position);
+    SVGElement(ElementKind kind, const ColorShape& fill,
+               const ColorShape& stroke, float stroke_width,
+               const Vector2Df& position);
 
     SVGElement* parent;  ///< Pointer to the group that contains the shape
 
 private:
+    ElementKind kind;    ///< Kind of the shape
     ColorShape fill;     ///< Fill color
     ColorShape stroke;   ///< Outline color
     float stroke_width;  ///< Thickness of the shape's outline
     Vector2Df position;  ///< Position of the shape
-    std::vector< std::string > transforms;  ///< List of transformations
+    AffineTransform transform;  ///< Transformation matrix
     Gradient* gradient;  ///< Pointer to the gradient that contains the shape
+    const ComputedStyle* style;  ///< Resolved style record, in the arena
+    mutable BoundingBox local_bounds;  ///< Cached bounds of the geometry
+    mutable BoundingBox bounds;        ///< Cached bounds in the parent
+    mutable bool bounds_dirty;         ///< Whether the bounds are out of date
+
+    /**
+     * @brief Computes the cached bounds.
+     */
+    void updateBounds() const;
+
+    /**
+     * @brief Grows a box by the outline of the shape, if it is drawn.
+     *
+     * @param box The bounds of the geometry mapped through the matrix.
+     * @param matrix The matrix mapping the coordinates of the shape.
+     */
+    void addOutline(BoundingBox& box, const AffineTransform& matrix) const;
 };
 
 #endif  // SVG_ELEMENT_HPP_
\ No newline at end of file
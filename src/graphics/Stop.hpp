@@ -1,6 +1,9 @@
 #ifndef STOP_HPP_
 #define STOP_HPP_
 
+#include <memory>
+#include <vector>
+
 #include "ColorShape.hpp"
 
 /**
@@ -37,4 +40,9 @@ private:
     float offset;      ///< The offset of the stop.
 };
 
+/**
+ * @brief An immutable list of stops, shared by the gradients using it.
+ */
+using StopRamp = std::shared_ptr< const std::vector< Stop > >;
+
 #endif
\ No newline at end of file
@@ -1,27 +1,52 @@
 #include "Text.hpp"
 
 Text::Text(Vector2Df pos, std::string text, float font_size,
-           const ColorShape &fill, const ColorShape &stroke, float stroke_width)
-    : SVGElement(fill, stroke, stroke_width, pos), content(text),
-      font_size(font_size) {}
+           const ColorShape &fill, const ColorShape &stroke, float stroke_width,
+           const std::pmr::polymorphic_allocator<> &allocator)
+    : SVGElement(ElementKind::Text, fill, stroke, stroke_width, pos),
+      content(text, allocator), font_size(font_size),
+      anchor(TextAnchor::Start), style(FontStyle::Normal) {}
 
 std::string Text::getClass() const { return "Text"; }
 
-void Text::setFontSize(float font_size) { this->font_size = font_size; }
+void Text::setFontSize(float font_size) {
+    this->font_size = font_size;
+    invalidateBounds();
+}
 
 float Text::getFontSize() const { return font_size; }
 
-void Text::setContent(std::string content) { this->content = content; }
-
-std::string Text::getContent() const { return content; }
-
-void Text::setAnchor(std::string anchor) { this->anchor = anchor; }
-
-std::string Text::getAnchor() const { return anchor; }
-
-void Text::setFontStyle(std::string font_style) { this->style = font_style; }
-
-std::string Text::getFontStyle() const { return style; }
+void Text::setContent(std::string content) {
+    this->content = content;
+    invalidateBounds();
+}
+
+std::string Text::getContent() const { return std::string(content); }
+
+void Text::setAnchor(TextAnchor anchor) {
+    this->anchor = anchor;
+    invalidateBounds();
+}
+
+TextAnchor Text::getAnchor() const { return anchor; }
+
+void Text::setFontStyle(FontStyle font_style) { this->style = font_style; }
+
+FontStyle Text::getFontStyle() const { return style; }
+
+BoundingBox Text::computeBounds(const AffineTransform &matrix) const {
+    // The renderer offsets the anchored texts by a fixed amount
+    float width = content.size() * font_size;
+    float x = getPosition().x, y = getPosition().y;
+    if (anchor == TextAnchor::Middle) {
+        x += 7 - width / 2;
+    } else if (anchor == TextAnchor::End) {
+        x += 14 - width;
+    }
+    BoundingBox box(Vector2Df(x, y - 1),
+                    Vector2Df(x + width, y + font_size * 1.5f));
+    return box.transform(matrix);
+}
 
 void Text::printData() const {
     SVGElement::printData();
@@ -1,8 +1,28 @@
 #ifndef TEXT_HPP_
 #define TEXT_HPP_
 
+#include <memory_resource>
+
 #include "SVGElement.hpp"
 
+/**
+ * @brief The text-anchor of a Text, parsed once when the text is built.
+ */
+enum class TextAnchor : std::uint8_t {
+    Start,   ///< "start", the default
+    Middle,  ///< "middle"
+    End,     ///< "end"
+};
+
+/**
+ * @brief The font-style of a Text, parsed once when the text is built.
+ */
+enum class FontStyle : std::uint8_t {
+    Normal,   ///< "normal", the default
+    Italic,   ///< "italic"
+    Oblique,  ///< "oblique"
+};
+
 /**
  * @brief Represents text in 2D space.
  *
@@ -11,10 +31,10 @@
  */
 class Text : public SVGElement {
 private:
-    std::string content;  ///< Text element
-    float font_size;      ///< Font size of the text
-    std::string anchor;   ///< Anchor of the text
-    std::string style;    ///< Style of the text
+    std::pmr::string content;  ///< Text element
+    float font_size;           ///< Font size of the text
+    TextAnchor anchor;         ///< Anchor of the text
+    FontStyle style;           ///< Style of the text
 
 public:
     /**
@@ -24,9 +44,11 @@ public:
      * @param text The string of the text.
      * @param fill The fill color of the text
      * @param font_size The font size of the text (default is 1).
+     * @param allocator The allocator of the string of the text.
      */
     Text(Vector2Df pos, std::string text, float font_size,
-         const ColorShape &fill, const ColorShape &stroke, float stroke_width);
+         const ColorShape &fill, const ColorShape &stroke, float stroke_width,
+         const std::pmr::polymorphic_allocator<> &allocator = {});
 
     /**
      * @brief Gets the type of the shape.
@@ -68,28 +90,37 @@ public:
      *
      * @param anchor The new anchor of the text.
      */
-    void setAnchor(std::string anchor);
+    void setAnchor(TextAnchor anchor);
 
     /**
      * @brief Gets the anchor of the text.
      *
      * @return The anchor of the text.
      */
-    std::string getAnchor() const;
+    TextAnchor getAnchor() const;
 
     /**
      * @brief Sets the style of the text.
      *
      * @param style The new style of the text.
      */
-    void setFontStyle(std::string style);
+    void setFontStyle(FontStyle style);
 
     /**
      * @brief Gets the style of the text.
      *
      * @return The style of the text.
      */
-    std::string getFontStyle() const;
+    FontStyle getFontStyle() const;
+
+    /**
+     * @brief Computes the bounds of the text mapped through a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the text.
+     * @return The mapped box of the text, estimated as one em per byte of
+     * content and placed as the renderer aligns it.
+     */
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
 
     /**
      * @brief Prints the data of the text.
@@ -0,0 +1,25 @@
+#include "Use.hpp"
+
+Use::Use() : SVGElement(ElementKind::Use), symbol(NULL) {}
+
+std::string Use::getClass() const { return "Use"; }
+
+void Use::setSymbol(const Group* symbol) {
+    this->symbol = symbol;
+    invalidateBounds();
+}
+
+const Group* Use::getSymbol() const { return symbol; }
+
+BoundingBox Use::computeBounds(const AffineTransform& matrix) const {
+    if (symbol == NULL) return BoundingBox();
+    return symbol->getLocalBounds().transform(matrix);
+}
+
+void Use::printData() const {
+    SVGElement::printData();
+    if (symbol != NULL) {
+        std::cout << "Symbol: ";
+        symbol->printData();
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef USE_HPP_
+#define USE_HPP_
+
+#include "Group.hpp"
+
+/**
+ * @brief Represents an instance of a symbol.
+ *
+ * The Use class is derived from the SVGElement class and defines a <use>
+ * element. It only holds its transform, its style and a reference to the
+ * subtree of the symbol it draws. The subtree is immutable and shared by
+ * every instance of the symbol resolving to the same style, so repeating a
+ * symbol costs one Use per instance instead of a copy of its geometry.
+ */
+class Use : public SVGElement {
+private:
+    const Group* symbol;  ///< Subtree of the symbol, in the arena
+
+public:
+    /**
+     * @brief Constructs a Use object without a symbol.
+     */
+    Use();
+
+    /**
+     * @brief Gets the type of the shape.
+     *
+     * @return The string "Use".
+     */
+    std::string getClass() const override;
+
+    /**
+     * @brief Sets the subtree drawn by the instance.
+     *
+     * @param symbol The shared subtree of the symbol, or NULL if the
+     * reference could not be resolved.
+     */
+    void setSymbol(const Group* symbol);
+
+    /**
+     * @brief Gets the subtree drawn by the instance.
+     *
+     * @return The subtree of the symbol, or NULL if none.
+     */
+    const Group* getSymbol() const;
+
+    /**
+     * @brief Computes the bounds of the instance mapped through a matrix.
+     *
+     * @param matrix The matrix mapping the coordinates of the instance.
+     * @return The cached bounds of the shapes of the symbol, drawn without
+     * the transform of its group, mapped through the matrix.
+     */
+    BoundingBox computeBounds(const AffineTransform& matrix) const override;
+
+    /**
+     * @brief Prints the data of the shape and of its symbol.
+     *
+     * @note This function is used for debugging purposes.
+     */
+    void printData() const override;
+};
+
+#endif  // USE_HPP_
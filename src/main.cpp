@@ -5,6 +5,10 @@
 #include <gdiplus.h>
 // clang-format on
 
+#include <cstring>
+#include <filesystem>
+#include <string>
+
 #include "Parser.hpp"
 #include "Viewer.hpp"
 
@@ -12,12 +16,44 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 Parser* parser = nullptr;
 
+// Check whether an option follows the file path on the command line
+bool hasOption(const char* option) {
+    for (int i = 2; i < __argc; ++i) {
+        if (std::strcmp(__argv[i], option) == 0) return true;
+    }
+    return false;
+}
+
 void OnPaint(HDC hdc, const std::string& filePath, Viewer& viewer) {
     Gdiplus::Graphics graphics(hdc);
 
     // Set up the graphics object for antialiased rendering.
     if (!parser) {
-        parser = Parser::getInstance(filePath);
+        // Files too large to be held in memory as a DOM are streamed
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(filePath, error);
+        LoadMode mode = !error && size > (std::uintmax_t(1) << 30)
+                            ? LoadMode::Streaming
+                            : LoadMode::Mapped;
+        // Large documents build their top-level groups on every core
+        unsigned int threads =
+            !error && size > (std::uintmax_t(1) << 26) ? 0 : 1;
+        // With --cache, reopening a document reads the scene cached in the
+        // temporary directory, keyed by the absolute path of the file
+        std::string cache_file;
+        if (mode != LoadMode::Streaming && hasOption("--cache")) {
+            std::string path =
+                std::filesystem::absolute(filePath, error).string();
+            std::filesystem::path directory =
+                std::filesystem::temp_directory_path(error);
+            std::uint64_t key = SceneCache::hash(path.data(), path.size());
+            if (!error) {
+                cache_file = (directory / ("svg-reader-" +
+                                           std::to_string(key) + ".svgc"))
+                                 .string();
+            }
+        }
+        parser = new Parser(filePath, mode, threads, cache_file);
     }
 
     // Set up Viewbox and Viewport
@@ -34,6 +70,9 @@ void OnPaint(HDC hdc, const std::string& filePath, Viewer& viewer) {
     graphics.SetPixelOffsetMode(Gdiplus::PixelOffsetModeHighQuality);
     graphics.SetInterpolationMode(Gdiplus::InterpolationModeHighQuality);
 
+    // The view is composed as GDI+ composes the transforms of the graphics,
+    // each one applied before the previous ones
+    AffineTransform view;
     graphics.SetClip(Gdiplus::Rect(0, 0, viewport.x, viewport.y));
     if ((viewport.x != viewbox.getWidth() ||
          viewport.y != viewbox.getHeight()) &&
@@ -51,8 +90,11 @@ void OnPaint(HDC hdc, const std::string& filePath, Viewer& viewer) {
             offset_y = (viewport.y - viewbox.getHeight() * scale) / 2 / scale;
         }
         graphics.TranslateTransform(offset_x, offset_y);
+        view = view * AffineTransform::scale(scale, scale) *
+               AffineTransform::translate(offset_x, offset_y);
     }
     graphics.TranslateTransform(-viewbox.getX(), -viewbox.getY());
+    view = view * AffineTransform::translate(-viewbox.getX(), -viewbox.getY());
 
     Gdiplus::Matrix matrix;
     Gdiplus::Region region;
@@ -61,12 +103,19 @@ void OnPaint(HDC hdc, const std::string& filePath, Viewer& viewer) {
     graphics.ScaleTransform(viewer.zoom_factor, viewer.zoom_factor);
     graphics.TranslateTransform(viewer.offset_x, viewer.offset_y);
     graphics.SetClip(&region);
+    view = view * AffineTransform::rotate(viewer.rotate_angle) *
+           AffineTransform::scale(viewer.zoom_factor, viewer.zoom_factor) *
+           AffineTransform::translate(viewer.offset_x, viewer.offset_y);
+
+    // The visible area is the viewport mapped back into the document, with
+    // a pixel more on each side for the antialiased edges
+    BoundingBox visible(Vector2Df(-1, -1), viewport + Vector2Df(1, 1));
+    visible = visible.transform(view.getInverse());
 
     // Render the SVG file.
     Renderer* renderer = Renderer::getInstance();
-    SVGElement* root = parser->getRoot();
-    Group* group = dynamic_cast< Group* >(root);
-    renderer->draw(graphics, group);
+    renderer->draw(graphics, parser->getStore(), parser->getSceneBVH(),
+                   visible);
 }
 
 INT WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, PSTR, INT iCmdShow) {